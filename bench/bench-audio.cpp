@@ -0,0 +1,115 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <vector>
+
+#include "./bench.hpp"
+#include "switcher/utils/audio-frame-ring-buffer.hpp"
+#include "switcher/utils/audio-interleave.hpp"
+#include "switcher/utils/audio-ring-buffer.hpp"
+
+namespace switcher {
+namespace bench {
+
+using namespace utils;
+
+namespace {
+using interleave_t = void (*)(const float* const*, std::size_t, std::size_t, float*);
+
+// one operation is the interleaving of a jack period, as done by JackToShmdata
+void add_interleave(Suite& suite,
+                    const std::string& name,
+                    interleave_t fun,
+                    std::size_t num_channels,
+                    std::size_t num_frames) {
+  suite.add("audio/interleave/" + name + "/" + std::to_string(num_channels) + "x" +
+                std::to_string(num_frames),
+            [=](size_t iterations, Timer& timer) {
+              timer.pause();
+              std::vector<std::vector<float>> channels(num_channels,
+                                                       std::vector<float>(num_frames, 0.5f));
+              std::vector<const float*> srcs;
+              for (auto& it : channels) srcs.push_back(it.data());
+              std::vector<float> interleaved(num_channels * num_frames);
+              timer.resume();
+              for (size_t i = 0; i < iterations; ++i)
+                fun(srcs.data(), num_channels, num_frames, interleaved.data());
+              timer.pause();
+            });
+}
+
+const unsigned int kChannels = 64;
+const std::size_t kFrames = 1024;
+
+// one operation is a period of kFrames frames of kChannels channels fed from an interleaved
+// buffer into per-channel ring buffers, as ShmdataToJack does, and drained in the same thread
+template <typename Put>
+void add_ring_buffer(Suite& suite, const std::string& name, Put put) {
+  suite.add("audio/ring_buffer/" + name, [put](size_t iterations, Timer& timer) {
+    timer.pause();
+    std::vector<AudioRingBuffer<float>> ring_buffers(kChannels);
+    std::vector<float> interleaved(kFrames * kChannels, 0.5f);
+    std::vector<float> out(kFrames);
+    timer.resume();
+    for (size_t i = 0; i < iterations; ++i) {
+      for (unsigned int chan = 0; chan < kChannels; ++chan) {
+        put(ring_buffers[chan], interleaved.data(), chan);
+        ring_buffers[chan].pop_samples(kFrames, out.data());
+      }
+    }
+    timer.pause();
+  });
+}
+}  // namespace
+
+void register_audio_benchmarks(Suite& suite) {
+  for (std::size_t num_channels : {2, 16, 128}) {
+    for (std::size_t num_frames : {64, 1024}) {
+      add_interleave(suite, "scalar", &interleave_scalar, num_channels, num_frames);
+      add_interleave(suite, "simd", &interleave, num_channels, num_frames);
+    }
+  }
+
+  add_ring_buffer(
+      suite, "sample_factory", [](AudioRingBuffer<float>& rb, const float* src, int chan) {
+        std::size_t pos = 0;
+        rb.put_samples(kFrames, [&]() { return src[pos++ * kChannels + chan]; });
+      });
+  add_ring_buffer(suite, "bulk", [](AudioRingBuffer<float>& rb, const float* src, int chan) {
+    rb.put_samples(src + chan, kFrames, kChannels);
+  });
+
+  // same with a single frame-interleaved ring buffer, de-interleaving into per-channel buffers
+  suite.add("audio/ring_buffer/frames", [](size_t iterations, Timer& timer) {
+    timer.pause();
+    AudioFrameRingBuffer<float> ring_buffer(kChannels);
+    std::vector<float> interleaved(kFrames * kChannels, 0.5f);
+    std::vector<std::vector<float>> outs(kChannels, std::vector<float>(kFrames));
+    std::vector<float*> dests;
+    for (auto& it : outs) dests.push_back(it.data());
+    timer.resume();
+    for (size_t i = 0; i < iterations; ++i) {
+      ring_buffer.put_frames(interleaved.data(), kFrames);
+      ring_buffer.pop_frames(kFrames, dests.data());
+    }
+    timer.pause();
+  });
+}
+
+}  // namespace bench
+}  // namespace switcher
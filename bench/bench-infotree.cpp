@@ -0,0 +1,322 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <json-glib/json-glib.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "./bench.hpp"
+#include "switcher/infotree/information-tree.hpp"
+#include "switcher/infotree/json-serializer.hpp"
+#include "switcher/infotree/json-writer.hpp"
+#include "switcher/infotree/msgpack-serializer.hpp"
+
+namespace switcher {
+namespace bench {
+
+namespace {
+// a tree shaped like a quiddity description: a few hundred branches with some properties
+InfoTree::ptr make_tree(int num_branches) {
+  auto tree = InfoTree::make();
+  for (int i = 0; i < num_branches; ++i) {
+    auto key = ".quiddities.quid" + std::to_string(i);
+    tree->vgraft(key + ".kind", std::string("videotestsrc"));
+    tree->vgraft(key + ".property.width", 640 + i);
+    tree->vgraft(key + ".property.height", 480);
+    tree->vgraft(key + ".property.started", i % 2 == 0);
+    tree->vgraft(key + ".property.framerate", 29.97);
+  }
+  return tree;
+}
+
+// a tree shaped like a quiddity tree with statistics of many shmdata writers
+InfoTree::ptr make_shmdata_tree(int num_branches) {
+  auto tree = InfoTree::make();
+  for (int i = 0; i < num_branches; ++i) {
+    auto branch = ".shmdata.writer./tmp/switcher_bench_" + std::to_string(i);
+    tree->vgraft(branch + ".caps", std::string("video/x-raw"));
+    tree->vgraft(branch + ".stat.byte_rate", 0.f);
+    tree->vgraft(branch + ".stat.rate", 0.f);
+  }
+  return tree;
+}
+
+std::string stat_rate_key(int i) {
+  return ".shmdata.writer./tmp/switcher_bench_" + std::to_string(i) + ".stat.rate";
+}
+
+// a tree shaped like a saved session, with arrays and various value types
+InfoTree::ptr make_session(int num_quiddities) {
+  auto tree = InfoTree::make();
+  for (int i = 0; i < num_quiddities; ++i) {
+    auto name = "quid_" + std::to_string(i);
+    auto quid = ".state.quiddities." + std::to_string(i);
+    tree->vgraft(quid + ".kind", std::string("videotestsrc"));
+    tree->vgraft(quid + ".name", name);
+    for (int j = 0; j < 20; ++j) {
+      auto prop = quid + ".properties.prop_" + std::to_string(j);
+      switch (j % 4) {
+        case 0:
+          tree->vgraft(prop, std::string("some value"));
+          break;
+        case 1:
+          tree->vgraft(prop, j % 3 == 0);
+          break;
+        case 2:
+          tree->vgraft(prop, 0.5 * j + i);
+          break;
+        default:
+          tree->vgraft(prop, j * i);
+      }
+    }
+    tree->vgraft(quid + ".userdata.position.x", 10.f * i);
+    tree->vgraft(".state.nicknames." + name, "video source \"" + std::to_string(i) + "\"");
+    if (i > 0) {
+      auto readers = ".state.readers." + name;
+      tree->vgraft(readers + ".0", "quid_" + std::to_string(i - 1));
+      tree->tag_as_array(readers, true);
+    }
+  }
+  tree->tag_as_array(".state.quiddities", true);
+  return tree;
+}
+
+// keeps results of operations the compiler could otherwise discard
+volatile float sink = 0;
+}  // namespace
+
+void register_infotree_benchmarks(Suite& suite) {
+  suite.add("infotree/graft", [](size_t iterations, Timer& timer) {
+    timer.pause();
+    auto tree = make_tree(300);
+    timer.resume();
+    for (size_t i = 0; i < iterations; ++i)
+      tree->vgraft(".quiddities.quid" + std::to_string(i % 300) + ".property.width",
+                   static_cast<int>(i));
+    timer.pause();
+  });
+
+  suite.add("infotree/get_value", [](size_t iterations, Timer& timer) {
+    timer.pause();
+    auto tree = make_tree(300);
+    timer.resume();
+    for (size_t i = 0; i < iterations; ++i)
+      tree->branch_get_value(".quiddities.quid" + std::to_string(i % 300) + ".property.width");
+    timer.pause();
+  });
+
+  suite.add("infotree/serialize_json", [](size_t iterations, Timer& timer) {
+    timer.pause();
+    auto tree = make_tree(300);
+    timer.resume();
+    for (size_t i = 0; i < iterations; ++i) infotree::json::serialize(tree.get());
+    timer.pause();
+  });
+
+  suite.add("infotree/deserialize_json", [](size_t iterations, Timer& timer) {
+    timer.pause();
+    auto json = infotree::json::serialize(make_tree(300).get());
+    timer.resume();
+    for (size_t i = 0; i < iterations; ++i) infotree::json::deserialize(json);
+    timer.pause();
+  });
+
+  suite.add("infotree/serialize_json/reused_writer", [](size_t iterations, Timer& timer) {
+    timer.pause();
+    auto tree = make_tree(300);
+    infotree::json::Writer writer;
+    timer.resume();
+    for (size_t i = 0; i < iterations; ++i) writer.write(tree.get());
+    timer.pause();
+  });
+
+  // the former serialization generated the string from a json-glib document
+  suite.add("infotree/serialize_json/json_glib_generator", [](size_t iterations, Timer& timer) {
+    timer.pause();
+    JsonNode* doc = json_from_string(infotree::json::serialize(make_tree(300).get()).c_str(),
+                                     nullptr);
+    timer.resume();
+    for (size_t i = 0; i < iterations; ++i) g_free(json_to_string(doc, FALSE));
+    timer.pause();
+    json_node_free(doc);
+  });
+
+  suite.add("infotree/session/save_json", [](size_t iterations, Timer& timer) {
+    timer.pause();
+    auto tree = make_session(300);
+    timer.resume();
+    for (size_t i = 0; i < iterations; ++i) infotree::json::serialize(tree.get());
+    timer.pause();
+  });
+
+  suite.add("infotree/session/save_msgpack", [](size_t iterations, Timer& timer) {
+    timer.pause();
+    auto tree = make_session(300);
+    timer.resume();
+    for (size_t i = 0; i < iterations; ++i) infotree::msgpack::serialize(tree.get());
+    timer.pause();
+  });
+
+  suite.add("infotree/session/load_json", [](size_t iterations, Timer& timer) {
+    timer.pause();
+    auto json = infotree::json::serialize(make_session(300).get());
+    timer.resume();
+    for (size_t i = 0; i < iterations; ++i) infotree::json::deserialize(json);
+    timer.pause();
+  });
+
+  suite.add("infotree/session/load_msgpack", [](size_t iterations, Timer& timer) {
+    timer.pause();
+    auto msgpack = infotree::msgpack::serialize(make_session(300).get());
+    timer.resume();
+    for (size_t i = 0; i < iterations; ++i) infotree::msgpack::deserialize(msgpack);
+    timer.pause();
+  });
+
+  suite.add("any/make_double", [](size_t iterations, Timer& timer) {
+    float sum = 0;
+    for (size_t i = 0; i < iterations; ++i) {
+      Any value(static_cast<double>(i));
+      sum += value.copy_as<float>();
+    }
+    timer.pause();
+    sink = sum;
+  });
+
+  suite.add("any/copy_short_string", [](size_t iterations, Timer& timer) {
+    timer.pause();
+    const Any value(std::string("video/x-raw"));
+    size_t size = 0;
+    timer.resume();
+    for (size_t i = 0; i < iterations; ++i) {
+      Any copy(value);
+      size += copy.as<std::string>().size();
+    }
+    timer.pause();
+    sink = size;
+  });
+
+  // stat updates and reads, as done by shmdata writers and followers, with pre-tokenized paths
+  // or with strings parsed at each call
+  for (int num_branches : {8, 64, 512}) {
+    const auto prefix = "infotree/shmdata/" + std::to_string(num_branches) + "/";
+    auto paths = std::make_shared<std::vector<infotree::Path>>();
+    auto keys = std::make_shared<std::vector<std::string>>();
+    for (int i = 0; i < num_branches; ++i) {
+      keys->push_back(stat_rate_key(i));
+      paths->emplace_back(keys->back());
+    }
+
+    suite.add(prefix + "get_value_string", [=](size_t iterations, Timer& timer) {
+      timer.pause();
+      auto tree = make_shmdata_tree(num_branches);
+      float sum = 0;
+      timer.resume();
+      for (size_t i = 0; i < iterations; ++i)
+        sum += tree->branch_get_value((*keys)[i % num_branches]).copy_as<float>();
+      timer.pause();
+      sink = sum;
+    });
+
+    suite.add(prefix + "get_value_path", [=](size_t iterations, Timer& timer) {
+      timer.pause();
+      auto tree = make_shmdata_tree(num_branches);
+      float sum = 0;
+      timer.resume();
+      for (size_t i = 0; i < iterations; ++i)
+        sum += tree->branch_get_value((*paths)[i % num_branches]).copy_as<float>();
+      timer.pause();
+      sink = sum;
+    });
+
+    suite.add(prefix + "set_value_path", [=](size_t iterations, Timer& timer) {
+      timer.pause();
+      auto tree = make_shmdata_tree(num_branches);
+      timer.resume();
+      for (size_t i = 0; i < iterations; ++i)
+        tree->branch_set_value((*paths)[i % num_branches], Any(static_cast<float>(i)));
+      timer.pause();
+    });
+
+    suite.add(prefix + "graft_string", [=](size_t iterations, Timer& timer) {
+      timer.pause();
+      auto tree = make_shmdata_tree(num_branches);
+      timer.resume();
+      for (size_t i = 0; i < iterations; ++i)
+        tree->graft((*keys)[i % num_branches], InfoTree::make(static_cast<float>(i)));
+      timer.pause();
+    });
+
+    suite.add(prefix + "graft_path", [=](size_t iterations, Timer& timer) {
+      timer.pause();
+      auto tree = make_shmdata_tree(num_branches);
+      timer.resume();
+      for (size_t i = 0; i < iterations; ++i)
+        tree->graft((*paths)[i % num_branches], InfoTree::make(static_cast<float>(i)));
+      timer.pause();
+    });
+
+    suite.add(prefix + "prune_graft_path", [=](size_t iterations, Timer& timer) {
+      timer.pause();
+      auto tree = make_shmdata_tree(num_branches);
+      timer.resume();
+      for (size_t i = 0; i < iterations; ++i) {
+        const auto& path = (*paths)[i % num_branches];
+        tree->graft(path, tree->prune(path));
+      }
+      timer.pause();
+    });
+
+    suite.add(prefix + "stat_update", [=](size_t iterations, Timer& timer) {
+      timer.pause();
+      auto tree = make_shmdata_tree(num_branches);
+      timer.resume();
+      for (size_t i = 0; i < iterations; ++i) {
+        auto stat = InfoTree::make();
+        stat->vgraft(".byte_rate", static_cast<float>(i));
+        stat->vgraft(".rate", static_cast<float>(i));
+        tree->graft(
+            ".shmdata.writer./tmp/switcher_bench_" + std::to_string(i % num_branches) + ".stat",
+            stat);
+      }
+      timer.pause();
+    });
+
+    suite.add(prefix + "copy", [=](size_t iterations, Timer& timer) {
+      timer.pause();
+      auto tree = make_shmdata_tree(num_branches);
+      timer.resume();
+      for (size_t i = 0; i < iterations; ++i) InfoTree::copy(tree.get());
+      timer.pause();
+    });
+
+    suite.add(prefix + "snapshot_after_update", [=](size_t iterations, Timer& timer) {
+      timer.pause();
+      auto tree = make_shmdata_tree(num_branches);
+      timer.resume();
+      for (size_t i = 0; i < iterations; ++i) {
+        tree->graft((*paths)[i % num_branches], InfoTree::make(static_cast<float>(i)));
+        tree->snapshot();
+      }
+      timer.pause();
+    });
+  }
+}
+
+}  // namespace bench
+}  // namespace switcher
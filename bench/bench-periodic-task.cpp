@@ -0,0 +1,71 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "./bench.hpp"
+#include "switcher/utils/periodic-task.hpp"
+
+namespace switcher {
+namespace bench {
+
+void register_periodic_task_benchmarks(Suite& suite) {
+  // one operation is a wakeup of a task among num_tasks tasks sharing the same period. Its
+  // duration is the jitter, i.e. the difference between the period and the time elapsed since
+  // the previous execution of the task
+  const auto period = std::chrono::milliseconds(1);
+  for (int num_tasks : {10, 100, 1000}) {
+    suite.add("periodic_task/jitter/" + std::to_string(num_tasks),
+              [=](size_t iterations, Timer& timer) {
+                timer.pause();
+                std::mutex mtx;
+                std::condition_variable cv;
+                size_t wakeups = 0;
+                Timer::clock::duration jitter{};
+                std::vector<Timer::clock::time_point> last(num_tasks);
+                std::vector<std::unique_ptr<PeriodicTask<>>> tasks;
+                for (int i = 0; i < num_tasks; ++i) {
+                  tasks.push_back(std::make_unique<PeriodicTask<>>(
+                      [&, i]() {
+                        auto now = Timer::clock::now();
+                        std::lock_guard<std::mutex> lock(mtx);
+                        // the first execution is not measured, it follows the task creation
+                        if (Timer::clock::time_point() != last[i] && wakeups < iterations) {
+                          auto elapsed = now - last[i];
+                          jitter += elapsed > period ? elapsed - period : period - elapsed;
+                          if (++wakeups == iterations) cv.notify_one();
+                        }
+                        last[i] = now;
+                      },
+                      period));
+                }
+                {
+                  std::unique_lock<std::mutex> lock(mtx);
+                  cv.wait(lock, [&]() { return wakeups == iterations; });
+                }
+                tasks.clear();
+                timer.add(jitter);
+              });
+  }
+}
+
+}  // namespace bench
+}  // namespace switcher
@@ -0,0 +1,96 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <vector>
+
+#include "./bench.hpp"
+#include "switcher/infotree/information-tree.hpp"
+#include "switcher/quiddity/property/pbag.hpp"
+#include "switcher/quiddity/signal/sig.hpp"
+
+namespace switcher {
+namespace bench {
+
+using namespace quiddity;
+
+void register_property_benchmarks(Suite& suite) {
+  suite.add("property/set_get_int", [](size_t iterations, Timer& timer) {
+    timer.pause();
+    int value = 0;
+    property::PBag pbag(
+        InfoTree::make(), [](const std::string&) {}, [](const std::string&) {});
+    pbag.make_int(
+        "value",
+        [&](const int& val) {
+          value = val;
+          return true;
+        },
+        [&]() { return value; },
+        "Value",
+        "An integer property",
+        value,
+        0,
+        1000);
+    timer.resume();
+    for (size_t i = 0; i < iterations; ++i) {
+      pbag.set_str_str("value", std::to_string(i % 1000));
+      pbag.get_str_str("value");
+    }
+    timer.pause();
+  });
+
+  suite.add("property/set_get_string", [](size_t iterations, Timer& timer) {
+    timer.pause();
+    std::string value;
+    property::PBag pbag(
+        InfoTree::make(), [](const std::string&) {}, [](const std::string&) {});
+    pbag.make_string(
+        "value",
+        [&](const std::string& val) {
+          value = val;
+          return true;
+        },
+        [&]() { return value; },
+        "Value",
+        "A string property",
+        value);
+    timer.resume();
+    for (size_t i = 0; i < iterations; ++i) {
+      pbag.set_str_str("value", "some text");
+      pbag.get_str_str("value");
+    }
+    timer.pause();
+  });
+
+  for (auto num_subscribers : {1, 16, 256}) {
+    suite.add("signal/fan_out/" + std::to_string(num_subscribers),
+              [num_subscribers](size_t iterations, Timer& timer) {
+                timer.pause();
+                signal::Sig sig;
+                size_t received = 0;
+                for (int i = 0; i < num_subscribers; ++i)
+                  sig.subscribe([&](const InfoTree::ptr&) { ++received; });
+                timer.resume();
+                for (size_t i = 0; i < iterations; ++i) sig.notify(InfoTree::make(i));
+                timer.pause();
+              });
+  }
+}
+
+}  // namespace bench
+}  // namespace switcher
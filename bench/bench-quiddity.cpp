@@ -0,0 +1,142 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "./bench.hpp"
+#include "switcher/quiddity/claw/claw.hpp"
+#include "switcher/quiddity/property/pbag.hpp"
+#include "switcher/switcher.hpp"
+
+namespace switcher {
+namespace bench {
+
+using namespace quiddity;
+
+void register_quiddity_benchmarks(Suite& suite) {
+  // startup with all the plugins opened when scanned, or with a plugin manifest and plugins
+  // opened on first use. The manifest is written in a temporary cache directory.
+  for (bool with_manifest : {false, true}) {
+    suite.add(std::string("switcher/make_switcher/") +
+                  (with_manifest ? "with_manifest" : "without_manifest"),
+              [with_manifest](size_t iterations, Timer& timer) {
+                timer.pause();
+                char cache_dir[] = "/tmp/switcher-bench-XXXXXX";
+                if (!mkdtemp(cache_dir)) return;
+                const char* env_xch = std::getenv("XDG_CACHE_HOME");
+                const std::string prev_xch = env_xch ? env_xch : "";
+                setenv("XDG_CACHE_HOME", cache_dir, 1);
+                if (with_manifest) Switcher::make_switcher("bench-startup");
+                for (size_t i = 0; i < iterations; ++i) {
+                  if (!with_manifest) fs::remove(Factory::get_manifest_path());
+                  timer.resume();
+                  Switcher::make_switcher("bench-startup");
+                  timer.pause();
+                }
+                if (env_xch)
+                  setenv("XDG_CACHE_HOME", prev_xch.c_str(), 1);
+                else
+                  unsetenv("XDG_CACHE_HOME");
+                fs::remove_all(cache_dir);
+              });
+  }
+
+  for (auto kind : {"empty-quid", "videotestsrc"}) {
+    suite.add(std::string("quiddity/create_remove/") + kind,
+              [kind](size_t iterations, Timer& timer) {
+                timer.pause();
+                auto manager = Switcher::make_switcher("bench-create");
+                timer.resume();
+                for (size_t i = 0; i < iterations; ++i) {
+                  auto qrox = manager->quids<&Container::create>(kind, "quid", nullptr);
+                  manager->quids<&Container::remove>(qrox.get_id());
+                }
+                timer.pause();
+              });
+  }
+
+  suite.add("claw/connect_disconnect", [](size_t iterations, Timer& timer) {
+    timer.pause();
+    auto manager = Switcher::make_switcher("bench-claw");
+    auto vid = manager->quids<&Container::create>("videotestsrc", "vid", nullptr).get();
+    auto dummy = manager->quids<&Container::create>("dummysink", "dummy", nullptr).get();
+    vid->prop<&property::PBag::set_str_str>("started", "true");
+    auto sfid = dummy->claw<&claw::Claw::get_sfid>("default");
+    auto swid = vid->claw<&claw::Claw::get_swid>("video");
+    timer.resume();
+    for (size_t i = 0; i < iterations; ++i) {
+      dummy->claw<&claw::Claw::connect>(sfid, vid->get_id(), swid);
+      dummy->claw<&claw::Claw::disconnect>(sfid);
+    }
+    timer.pause();
+  });
+
+  // nickname lookups by concurrent control clients among 1000 quiddities, optionally while
+  // another client creates and removes quiddities. One operation is a lookup by each client.
+  const std::vector<std::pair<int, bool>> lookups{{1, false}, {4, false}, {8, false}, {4, true}};
+  for (const auto& it : lookups) {
+    const int num_clients = it.first;
+    const bool churn = it.second;
+    suite.add("container/lookup/" + std::to_string(num_clients) + "_clients" +
+                  (churn ? "_churn" : ""),
+              [=](size_t iterations, Timer& timer) {
+                timer.pause();
+                const int num_quids = 1000;
+                auto manager = Switcher::make_switcher("bench-lookup");
+                for (int i = 0; i < num_quids; ++i)
+                  manager->quids<&Container::create>(
+                      "empty-quid", "quid" + std::to_string(i), nullptr);
+                std::atomic<bool> done{false};
+                std::thread churner;
+                if (churn) {
+                  churner = std::thread([&]() {
+                    int i = 0;
+                    while (!done) {
+                      auto nick = "churn" + std::to_string(i++);
+                      auto qrox = manager->quids<&Container::create>("empty-quid", nick, nullptr);
+                      if (qrox) manager->quids<&Container::remove>(qrox.get_id());
+                    }
+                  });
+                }
+                std::vector<std::thread> clients;
+                timer.resume();
+                for (int t = 0; t < num_clients; ++t) {
+                  clients.emplace_back([&, t]() {
+                    for (size_t i = 0; i < iterations; ++i) {
+                      auto nick = "quid" + std::to_string((i * 7919 + t) % num_quids);
+                      auto id = manager->quids<&Container::get_id>(nick);
+                      if (0 == id || !manager->quids<&Container::get_quiddity>(id))
+                        std::cerr << "lookup of " << nick << " failed\n";
+                    }
+                  });
+                }
+                for (auto& client : clients) client.join();
+                timer.pause();
+                done = true;
+                if (churner.joinable()) churner.join();
+              });
+  }
+}
+
+}  // namespace bench
+}  // namespace switcher
@@ -0,0 +1,177 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "./bench.hpp"
+#include <gst/gst.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "switcher/infotree/information-tree.hpp"
+#include "switcher/infotree/json-serializer.hpp"
+#include "switcher/utils/file-utils.hpp"
+
+namespace switcher {
+namespace bench {
+
+void Timer::pause() {
+  if (!running_) return;
+  elapsed_ += clock::now() - start_;
+  running_ = false;
+}
+
+void Timer::resume() {
+  if (running_) return;
+  start_ = clock::now();
+  running_ = true;
+}
+
+void Timer::add(clock::duration duration) { elapsed_ += duration; }
+
+double Timer::elapsed_ns() const {
+  auto elapsed = running_ ? elapsed_ + (clock::now() - start_) : elapsed_;
+  return std::chrono::duration<double, std::nano>(elapsed).count();
+}
+
+void Suite::add(const std::string& name, bench_t bench) {
+  benches_.push_back(Bench{name, std::move(bench)});
+}
+
+Suite::Result Suite::measure(const Bench& bench) const {
+  const double min_ns = min_time_s_ * 1e9;
+  // the calibration runs also warm up caches and lazily initialized state
+  size_t iterations = 1;
+  while (true) {
+    Timer timer;
+    bench.fun(iterations, timer);
+    timer.pause();
+    auto ns = timer.elapsed_ns();
+    if (ns >= min_ns) break;
+    // aim a bit above the minimum time, without trusting too much a very short run
+    auto next = ns > 0 ? static_cast<size_t>(1.4 * iterations * min_ns / ns) : 10 * iterations;
+    iterations = std::clamp(next, iterations + 1, 10 * iterations);
+  }
+  Result res{bench.name, iterations, {}};
+  for (size_t i = 0; i < repetitions_; ++i) {
+    Timer timer;
+    bench.fun(iterations, timer);
+    timer.pause();
+    res.ns_per_op.push_back(timer.elapsed_ns() / iterations);
+  }
+  std::sort(res.ns_per_op.begin(), res.ns_per_op.end());
+  return res;
+}
+
+bool Suite::write_json(const std::vector<Result>& results, const std::string& file) const {
+  auto tree = InfoTree::make();
+  tree->vgraft(".context.switcher_version", std::string(SWITCHER_VERSION_STRING));
+  char date[32];
+  auto now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%FT%T%z", std::localtime(&now));
+  tree->vgraft(".context.date", std::string(date));
+  char host[256] = {};
+  gethostname(host, sizeof(host) - 1);
+  tree->vgraft(".context.host", std::string(host));
+  tree->vgraft(".context.num_cpus", std::thread::hardware_concurrency());
+  tree->vgraft(".context.min_time_s", min_time_s_);
+  tree->vgraft(".context.repetitions", repetitions_);
+  tree->graft(".benchmarks", InfoTree::make());
+  tree->tag_as_array(".benchmarks", true);
+  for (size_t i = 0; i < results.size(); ++i) {
+    const auto& it = results[i];
+    auto key = ".benchmarks." + std::to_string(i);
+    tree->vgraft(key + ".name", it.name);
+    tree->vgraft(key + ".iterations", it.iterations);
+    tree->vgraft(key + ".ns_per_op.median", it.ns_per_op[it.ns_per_op.size() / 2]);
+    tree->vgraft(key + ".ns_per_op.min", it.ns_per_op.front());
+    tree->vgraft(key + ".ns_per_op.max", it.ns_per_op.back());
+  }
+  auto json = infotree::json::serialize(tree.get());
+  if ("-" == file) {
+    std::cout << json << '\n';
+    return true;
+  }
+  auto saved = fileutils::save(json, file);
+  if (!saved) std::cerr << "cannot write " << file << ": " << saved.msg() << '\n';
+  return static_cast<bool>(saved);
+}
+
+int Suite::run(int argc, char* argv[]) {
+  std::string filter;
+  std::string json_file;
+  bool list = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg(argv[i]);
+    auto value = arg.substr(arg.find('=') + 1);
+    if (0 == arg.find("--filter=")) {
+      filter = value;
+    } else if (0 == arg.find("--json=")) {
+      json_file = value;
+    } else if (0 == arg.find("--min-time=")) {
+      min_time_s_ = std::atof(value.c_str());
+    } else if (0 == arg.find("--repetitions=")) {
+      repetitions_ = std::max(1, std::atoi(value.c_str()));
+    } else if ("--list" == arg) {
+      list = true;
+    } else {
+      std::cerr << "usage: " << argv[0]
+                << " [--list] [--filter=<substring>] [--json=<file or ->]"
+                   " [--min-time=<seconds>] [--repetitions=<n>]\n";
+      return "--help" == arg ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  std::vector<Result> results;
+  for (const auto& it : benches_) {
+    if (std::string::npos == it.name.find(filter)) continue;
+    if (list) {
+      std::cout << it.name << '\n';
+      continue;
+    }
+    results.push_back(measure(it));
+    const auto& res = results.back();
+    // keep stdout for results when json is written there
+    auto& out = "-" == json_file ? std::cerr : std::cout;
+    out << std::left << std::setw(40) << res.name << std::right << std::fixed
+        << std::setprecision(1) << std::setw(14) << res.ns_per_op[res.ns_per_op.size() / 2]
+        << " ns/op (min " << res.ns_per_op.front() << ", max " << res.ns_per_op.back() << ", "
+        << res.iterations << " iterations)" << std::endl;
+  }
+  if (!json_file.empty() && !list && !write_json(results, json_file)) return EXIT_FAILURE;
+  return EXIT_SUCCESS;
+}
+
+}  // namespace bench
+}  // namespace switcher
+
+int main(int argc, char* argv[]) {
+  int res;
+  {
+    switcher::bench::Suite suite;
+    switcher::bench::register_audio_benchmarks(suite);
+    switcher::bench::register_infotree_benchmarks(suite);
+    switcher::bench::register_periodic_task_benchmarks(suite);
+    switcher::bench::register_property_benchmarks(suite);
+    switcher::bench::register_quiddity_benchmarks(suite);
+    res = suite.run(argc, argv);
+  }
+  gst_deinit();
+  return res;
+}
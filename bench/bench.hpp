@@ -0,0 +1,92 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SWITCHER_BENCH_H__
+#define __SWITCHER_BENCH_H__
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace switcher {
+namespace bench {
+
+/**
+ * Timer given to a benchmark function. It is running when the function is invoked, and can be
+ * paused around setup and tear down code that must not be measured.
+ */
+class Timer {
+ public:
+  using clock = std::chrono::steady_clock;
+  void pause();
+  void resume();
+  // account for a duration measured by the benchmark itself, for instance in another thread
+  void add(clock::duration duration);
+  double elapsed_ns() const;
+
+ private:
+  clock::time_point start_{clock::now()};
+  clock::duration elapsed_{};
+  bool running_{true};
+};
+
+/**
+ * Suite runs benchmarks and reports their time per operation. The number of iterations of each
+ * benchmark is increased until a run lasts at least the minimum time, then runs are repeated
+ * and the median, min and max are reported. Results are printed and optionally written in
+ * JSON, for comparison between releases.
+ */
+class Suite {
+ public:
+  // run the measured operation the given number of iterations
+  using bench_t = std::function<void(size_t iterations, Timer& timer)>;
+
+  void add(const std::string& name, bench_t bench);
+  /**
+   * Run the benchmarks selected by the command line arguments.
+   * \return The process exit code.
+   */
+  int run(int argc, char* argv[]);
+
+ private:
+  struct Bench {
+    std::string name;
+    bench_t fun;
+  };
+  struct Result {
+    std::string name;
+    size_t iterations;
+    std::vector<double> ns_per_op;  //!< One value per repetition, sorted.
+  };
+  std::vector<Bench> benches_{};
+  double min_time_s_{0.2};
+  size_t repetitions_{5};
+
+  Result measure(const Bench& bench) const;
+  bool write_json(const std::vector<Result>& results, const std::string& file) const;
+};
+
+void register_audio_benchmarks(Suite& suite);
+void register_infotree_benchmarks(Suite& suite);
+void register_periodic_task_benchmarks(Suite& suite);
+void register_property_benchmarks(Suite& suite);
+void register_quiddity_benchmarks(Suite& suite);
+
+}  // namespace bench
+}  // namespace switcher
+#endif
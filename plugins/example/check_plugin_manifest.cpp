@@ -0,0 +1,136 @@
+/*
+ * This file is part of switcher-plugin-example.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+
+#undef NDEBUG  // get assert in release mode
+
+#include <stdlib.h>
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include "switcher/infotree/json-serializer.hpp"
+#include "switcher/switcher.hpp"
+#include "switcher/utils/file-utils.hpp"
+
+using namespace switcher;
+namespace fs = std::filesystem;
+
+// whether the file is mapped in the process, i.e. the plugin has been opened
+bool is_opened(const fs::path& plugin) {
+  std::ifstream maps("/proc/self/maps");
+  std::string line;
+  while (std::getline(maps, line))
+    if (std::string::npos != line.find(plugin.string())) return true;
+  return false;
+}
+
+// manifest entry recorded for a plugin file, or nullptr
+InfoTree::ptr get_entry(const fs::path& plugin) {
+  auto manifest = infotree::json::deserialize(
+      fileutils::get_content(quiddity::Factory::get_manifest_path()));
+  for (const auto& it : manifest->get_child_keys(".plugins")) {
+    auto entry = manifest->get_tree(".plugins." + it);
+    if (plugin.string() == entry->branch_get_value(".file").copy_as<std::string>()) return entry;
+  }
+  return nullptr;
+}
+
+// replace the manifest with a single entry
+void set_entry(const fs::path& plugin, const std::string& stamp, const std::string& kind) {
+  auto manifest = InfoTree::make();
+  manifest->vgraft(".plugins.0.file", plugin.string());
+  manifest->vgraft(".plugins.0.stamp", stamp);
+  manifest->vgraft(".plugins.0.kind", kind);
+  manifest->tag_as_array(".plugins", true);
+  assert(fileutils::save(infotree::json::serialize(manifest.get()),
+                         quiddity::Factory::get_manifest_path()));
+}
+
+// copy a plugin into its own directory, keeping the modification time and size of the source
+// so that its stamp is the same
+fs::path copy_plugin(const fs::path& source, const fs::path& dir) {
+  fs::create_directories(dir);
+  auto res = dir / source.filename();
+  fs::copy_file(source, res);
+  fs::last_write_time(res, fs::last_write_time(source));
+  return res;
+}
+
+bool has_kind(Switcher::ptr manager, const std::string& kind) {
+  return manager->factory<&quiddity::Factory::exists>(kind);
+}
+
+int main() {
+  char tmp_dir[] = "/tmp/switcher-check-manifest-XXXXXX";
+  assert(mkdtemp(tmp_dir));
+  const auto root = fs::canonical(tmp_dir);
+  // the manifest is written in a temporary cache directory
+  setenv("XDG_CACHE_HOME", (root / "cache").c_str(), 1);
+  const auto plugin = copy_plugin(PROP_QUID_PLUGIN, root / "scanned");
+  std::string stamp;
+
+  {  // a plugin is opened and rescanned when its stamp does not match the manifest
+    fs::create_directories(quiddity::Factory::get_manifest_path().parent_path());
+    set_entry(plugin, "outdated-stamp", "outdated-kind");
+    setenv("SWITCHER_PLUGIN_PATH", plugin.parent_path().c_str(), 1);
+    Switcher::ptr manager = Switcher::make_switcher("test-manifest");
+    assert(is_opened(plugin));
+    assert(has_kind(manager, "property-quid"));
+    assert(!has_kind(manager, "outdated-kind"));
+    auto entry = get_entry(plugin);
+    assert(entry);
+    assert("property-quid" == entry->branch_get_value(".kind").copy_as<std::string>());
+    stamp = entry->branch_get_value(".stamp").copy_as<std::string>();
+    assert("outdated-stamp" != stamp);
+  }
+
+  {  // a plugin listed in the manifest is opened when its first quiddity is created
+    const auto lazy = copy_plugin(plugin, root / "lazy");
+    set_entry(lazy, stamp, "property-quid");
+    setenv("SWITCHER_PLUGIN_PATH", lazy.parent_path().c_str(), 1);
+    Switcher::ptr manager = Switcher::make_switcher("test-manifest");
+    assert(has_kind(manager, "property-quid"));
+    assert(!is_opened(lazy));
+    auto created = manager->quids<&quiddity::Container::create>("property-quid", "lazy", nullptr);
+    assert(created);
+    assert(is_opened(lazy));
+    assert(manager->quids<&quiddity::Container::remove>(created.get_id()));
+  }
+
+  {  // a plugin failing to open is removed from the manifest
+    fs::create_directories(root / "broken");
+    const auto broken = root / "broken" / plugin.filename();
+    {  // same size and modification time as a valid plugin, but not a shared library
+      std::ofstream file(broken, std::ios::binary);
+      file << std::string(fs::file_size(plugin), '\0');
+    }
+    fs::last_write_time(broken, fs::last_write_time(plugin));
+    set_entry(broken, stamp, "broken-quid");
+    setenv("SWITCHER_PLUGIN_PATH", broken.parent_path().c_str(), 1);
+    Switcher::ptr manager = Switcher::make_switcher("test-manifest");
+    assert(has_kind(manager, "broken-quid"));
+    assert(!manager->quids<&quiddity::Container::create>("broken-quid", "broken", nullptr));
+    assert(!has_kind(manager, "broken-quid"));
+    assert(!get_entry(broken));
+  }
+
+  fs::remove_all(root);
+  return 0;
+}
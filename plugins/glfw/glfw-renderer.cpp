@@ -60,22 +60,7 @@ void GLFWRenderer::render_loop() {
         if (current->draw_video_ || current->draw_image_) {
           glBindTexture(GL_TEXTURE_2D, current->drawing_texture_);
 
-          if (current->draw_video_) {
-            bool has_changed = true;
-            auto data = current->video_frames_.read(has_changed);
-            if (has_changed) {
-              glTexSubImage2D(GL_TEXTURE_2D,
-                              0,
-                              0,
-                              0,
-                              current->vid_width_,
-                              current->vid_height_,
-                              GL_RGBA,
-                              GL_UNSIGNED_INT_8_8_8_8_REV,
-                              (const GLvoid*)data);
-              glGenerateMipmap(GL_TEXTURE_2D);
-            }
-          }
+          if (current->draw_video_) current->upload_video_frame();
 
           glBindVertexArray(current->vao_);
           glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -614,6 +614,7 @@ void GLFWVideo::destroy_gl_elements() {
   if (!window_) return;
 
   glfwMakeContextCurrent(window_);
+  setup_pixel_buffers(0);
   if (drawing_texture_) glDeleteTextures(1, &drawing_texture_);
   if (shader_program_) glDeleteProgram(shader_program_);
   if (fragment_shader_) glDeleteShader(fragment_shader_);
@@ -799,9 +800,28 @@ void GLFWVideo::setup_video_texture() {
                GL_UNSIGNED_INT_8_8_8_8_REV,
                0);
   glBindTexture(GL_TEXTURE_2D, 0);
+  setup_pixel_buffers(static_cast<size_t>(vid_width_ * vid_height_ * 4));
   set_viewport();
 }
 
+void GLFWVideo::setup_pixel_buffers(size_t size) {
+  // without persistent mapping, frames are uploaded from the mapped GstBuffer
+  if (size && !GLAD_GL_VERSION_4_4 && !GLAD_GL_ARB_buffer_storage) return;
+  std::lock_guard<std::mutex> lock(pbo_mutex_);
+  video_frames_.for_each_slot([size](VideoFrame& frame) { frame.attach_pbo(size); });
+}
+
+void GLFWVideo::upload_video_frame() {
+  // the current frame goes back to on_handoff_cb once another one is read
+  video_frames_.front().wait_upload();
+  bool has_changed = true;
+  auto& frame = video_frames_.read(has_changed);
+  // frames received before a caps change may not fill the texture
+  if (!has_changed || frame.size() < static_cast<size_t>(vid_width_ * vid_height_ * 4)) return;
+  frame.upload(vid_width_, vid_height_);
+  glGenerateMipmap(GL_TEXTURE_2D);
+}
+
 void GLFWVideo::setup_background_texture() {
   glBindTexture(GL_TEXTURE_2D, drawing_texture_);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -901,9 +921,7 @@ void GLFWVideo::key_cb(GLFWwindow* window, int key, int /*scancode*/, int action
   if (quiddity->keyb_shm_.get()) {
     guint32 val = key;
     auto keybevent = KeybEvent(val, action);
-    quiddity->keyb_shm_->writer<&::shmdata::Writer::copy_to_shm>(&keybevent,
-                                                                       sizeof(KeybEvent));
-    quiddity->keyb_shm_->bytes_written(sizeof(KeybEvent));
+    quiddity->keyb_shm_->copy_to_shm(&keybevent, sizeof(KeybEvent));
   }
 
   if (quiddity->keyb_interaction_) {
@@ -939,9 +957,7 @@ void GLFWVideo::mouse_cb(GLFWwindow* window, double xpos, double ypos) {
   if (!quiddity->cursor_inside_) return;
 
   auto mouse_event = MouseEvent(xpos, ypos, 1);
-  quiddity->mouse_shm_->writer<&::shmdata::Writer::copy_to_shm>(&mouse_event,
-                                                                      sizeof(MouseEvent));
-  quiddity->mouse_shm_->bytes_written(sizeof(MouseEvent));
+  quiddity->mouse_shm_->copy_to_shm(&mouse_event, sizeof(MouseEvent));
 }
 
 void GLFWVideo::enter_cb(GLFWwindow* window, int entered) {
@@ -1072,8 +1088,6 @@ bool GLFWVideo::on_shmdata_connect(const std::string& shmpath) {
         vid_width_ = g_value_get_int(width_val);
         vid_height_ = g_value_get_int(height_val);
 
-        auto frame_size = vid_width_ * vid_height_ * 4;  // Only RGBA is supported.
-        video_frames_.resize(frame_size);
 
         add_rendering_task([this]() {
           draw_video_ = true;
@@ -1223,15 +1237,97 @@ inline void GLFWVideo::on_handoff_cb(GstElement* /*object*/,
                                      gpointer user_data) {
   GLFWVideo* context = static_cast<GLFWVideo*>(user_data);
 
-  GstMapInfo map;
-
-  if (!gst_buffer_map(buf, &map, GST_MAP_READ)) {
+  std::lock_guard<std::mutex> lock(context->pbo_mutex_);
+  if (!context->video_frames_.back().write(buf)) {
     context->sw_warning("gst_buffer_map failed: canceling video buffer access");
     return;
   }
-  On_scope_exit { gst_buffer_unmap(buf, &map); };
+  context->video_frames_.publish();
+}
+
+bool GLFWVideo::VideoFrame::write(GstBuffer* buf) {
+  release();
+  if (!gst_buffer_map(buf, &map_, GST_MAP_READ)) return false;
+  if (map_.size <= pbo_size_) {
+    // straight into memory the GPU reads from, the buffer can be released right away
+    memcpy(pbo_data_, map_.data, map_.size);
+    pbo_filled_ = map_.size;
+    gst_buffer_unmap(buf, &map_);
+    return true;
+  }
+  buf_ = gst_buffer_ref(buf);
+  return true;
+}
+
+void GLFWVideo::VideoFrame::release() {
+  pbo_filled_ = 0;
+  if (!buf_) return;
+  gst_buffer_unmap(buf_, &map_);
+  gst_buffer_unref(buf_);
+  buf_ = nullptr;
+}
+
+void GLFWVideo::VideoFrame::upload(GLsizei width, GLsizei height) {
+  if (!pbo_filled_) {
+    glTexSubImage2D(GL_TEXTURE_2D,
+                    0,
+                    0,
+                    0,
+                    width,
+                    height,
+                    GL_RGBA,
+                    GL_UNSIGNED_INT_8_8_8_8_REV,
+                    (const GLvoid*)map_.data);
+    return;
+  }
+  // the transfer from the PBO is asynchronous, the fence tells when the PBO can be written again
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo_);
+  glTexSubImage2D(
+      GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_INT_8_8_8_8_REV, nullptr);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  fence_ = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void GLFWVideo::VideoFrame::wait_upload() {
+  if (!fence_) return;
+  // the PBO must not be written while the GPU may still read it, so the wait goes on after a
+  // timeout, commands being flushed with the first call only
+  GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+  GLenum res = GL_TIMEOUT_EXPIRED;
+  while (GL_TIMEOUT_EXPIRED == res) {
+    res = glClientWaitSync(fence_, flags, kUploadTimeout);
+    flags = 0;
+  }
+  // the fence cannot tell, wait for every command instead
+  if (GL_WAIT_FAILED == res) glFinish();
+  glDeleteSync(fence_);
+  fence_ = nullptr;
+}
 
-  context->video_frames_.write(map.data, map.data + map.size);
+void GLFWVideo::VideoFrame::attach_pbo(size_t size) {
+  wait_upload();
+  // a frame written in the previous PBO is lost
+  pbo_filled_ = 0;
+  if (pbo_) {
+    // deleting the buffer also unmaps it
+    glDeleteBuffers(1, &pbo_);
+    pbo_ = 0;
+    pbo_data_ = nullptr;
+    pbo_size_ = 0;
+  }
+  if (!size) return;
+  const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+  glGenBuffers(1, &pbo_);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo_);
+  glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags);
+  pbo_data_ = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags));
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  if (!pbo_data_) {
+    glDeleteBuffers(1, &pbo_);
+    pbo_ = 0;
+    return;
+  }
+  pbo_size_ = size;
 }
 
 GLFWVideo::GUIConfiguration::GUIConfiguration(GLFWVideo* window)
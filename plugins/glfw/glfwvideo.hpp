@@ -22,7 +22,7 @@
 
 // clang-format off
 #include "./external/glad.h"
-#include "./multiple-buffer.hpp"
+#include "./triple-buffer.hpp"
 #include <GLFW/glfw3.h>
 #include <imgui.h>
 // clang-format on
@@ -194,6 +194,8 @@ class GLFWVideo : public Quiddity {
   bool setup_shaders();
   bool setup_vertex_array();
   void setup_video_texture();
+  void setup_pixel_buffers(size_t size);
+  void upload_video_frame();
   void setup_background_texture();
   void load_icon();
   void setup_icon();
@@ -233,6 +235,50 @@ class GLFWVideo : public Quiddity {
    * \brief Data management methods
    */
   bool on_shmdata_connect(const std::string& shmpath);
+  /**
+   * \brief Video frame kept mapped until replaced, so that the renderer uploads it from the
+   * GstBuffer memory without an intermediate copy
+   */
+  class VideoFrame {
+   public:
+    VideoFrame() = default;
+    ~VideoFrame() { release(); }
+    VideoFrame(const VideoFrame&) = delete;
+    VideoFrame& operator=(const VideoFrame&) = delete;
+    /**
+     * \brief Write a new frame. It is copied into the attached pixel buffer object if it fits,
+     * otherwise a mapped reference to the buffer is kept until the next write.
+     * \return false if the new buffer cannot be mapped
+     */
+    bool write(GstBuffer* buf);
+    /**
+     * \brief Upload the frame into the bound texture. From the rendering thread only.
+     */
+    void upload(GLsizei width, GLsizei height);
+    /**
+     * \brief Wait for the last upload from the pixel buffer object to complete, so that it can
+     * be written again. From the rendering thread only.
+     */
+    void wait_upload();
+    /**
+     * \brief Replace the pixel buffer object with a persistently mapped one. A null size only
+     * removes the current one. From the rendering thread only.
+     */
+    void attach_pbo(size_t size);
+    size_t size() const { return pbo_filled_ ? pbo_filled_ : (buf_ ? map_.size : 0); }
+
+   private:
+    static constexpr GLuint64 kUploadTimeout{100000000};  //!< Nanoseconds, for each wait call.
+    GstBuffer* buf_{nullptr};
+    GstMapInfo map_{};
+    GLuint pbo_{0};
+    uint8_t* pbo_data_{nullptr};  //!< Persistent and coherent mapping of the pbo_ storage.
+    size_t pbo_size_{0};
+    size_t pbo_filled_{0};  //!< Size of the frame written in the pbo_, 0 if the frame is in buf_.
+    GLsync fence_{nullptr};
+    void release();
+  };
+
   bool on_shmdata_disconnect();
   bool remake_elements();
   void install_gst_properties();
@@ -244,7 +290,8 @@ class GLFWVideo : public Quiddity {
    */
   std::atomic<bool> ongoing_destruction_{false};
   static std::atomic<int> instance_counter_;
-  MultipleBuffer<3, uint8_t> video_frames_{};
+  TripleBuffer<VideoFrame> video_frames_{};  //!< Written by on_handoff_cb, read by the renderer.
+  std::mutex pbo_mutex_{};  //!< Keeps on_handoff_cb from writing while PBOs are reallocated.
   std::vector<uint8_t> image_data_{};
   GLuint drawing_texture_{0};
   GLuint shader_program_{0};
@@ -0,0 +1,88 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __SWITCHER_TRIPLE_BUFFER_H__
+#define __SWITCHER_TRIPLE_BUFFER_H__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Lock-free exchange of the latest value between a single writer and a single reader. The writer
+ * fills its back slot in place and publishes it, the reader takes the latest published slot.
+ * Neither side ever waits for the other: slots are swapped with an atomic exchange of their index.
+ */
+template <typename T>
+class TripleBuffer {
+ public:
+  TripleBuffer() = default;
+  ~TripleBuffer() = default;
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  /**
+   * Get the slot owned by the writer, to be filled before publish.
+   */
+  T& back() { return slots_[back_]; }
+
+  /**
+   * Make the back slot the latest value. The writer gets in exchange the previous unread or
+   * already read slot as its new back slot.
+   */
+  void publish() {
+    auto previous = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel);
+    back_ = previous & kIndexMask;
+  }
+
+  /**
+   * Get the latest published value. The returned slot is not touched by the writer until the
+   * next call to read.
+   * \param has_changed Set to true if a value has been published since the previous read.
+   */
+  T& read(bool& has_changed) {
+    has_changed = 0 != (middle_.load(std::memory_order_relaxed) & kFresh);
+    if (has_changed) front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+    return slots_[front_];
+  }
+
+  /**
+   * Get the slot currently owned by the reader, as returned by the last call to read.
+   */
+  T& front() { return slots_[front_]; }
+
+  /**
+   * Apply a function to every slot. This is not synchronized with the writer, the caller must
+   * make sure the writer is not running.
+   */
+  template <typename F>
+  void for_each_slot(F fun) {
+    for (auto& slot : slots_) fun(slot);
+  }
+
+ private:
+  static constexpr uint8_t kIndexMask{0x3};
+  static constexpr uint8_t kFresh{0x4};  //!< Set in middle_ when published and not read yet.
+  std::array<T, 3> slots_{};
+  uint8_t front_{0};  //!< Reader slot.
+  alignas(64) std::atomic<uint8_t> middle_{1};
+  alignas(64) uint8_t back_{2};  //!< Writer slot.
+};
+
+#endif
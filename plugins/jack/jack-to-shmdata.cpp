@@ -20,6 +20,7 @@
 #include "./jack-to-shmdata.hpp"
 #include <string.h>
 #include "switcher/quiddity/container.hpp"
+#include "switcher/utils/audio-interleave.hpp"
 
 namespace switcher {
 namespace quiddities {
@@ -156,7 +157,6 @@ bool JackToShmdata::start() {
 
   client_name_ = jack_client_->get_name();
 
-  buf_.resize(num_channels_ * jack_client_->get_buffer_size());
   std::string data_type(
       "audio/x-raw, "
       "format=(string)F32LE, "
@@ -196,7 +196,10 @@ bool JackToShmdata::start() {
 
   std::string shmpath = claw_.get_shmpath_from_writer_label("audio");
   shm_ = std::make_unique<shmdata::Writer>(
-      this, shmpath, buf_.size() * sizeof(jack_sample_t), data_type);
+      this,
+      shmpath,
+      num_channels_ * jack_client_->get_buffer_size() * sizeof(jack_sample_t),
+      data_type);
   if (!shm_.get()) {
     sw_warning("JackToShmdata failed to start");
     shm_.reset(nullptr);
@@ -212,6 +215,7 @@ bool JackToShmdata::start() {
     std::lock_guard<std::mutex> lock(input_ports_mutex_);
     input_ports_.clear();
     for (size_t i = 1; i <= num_channels_; ++i) input_ports_.emplace_back(*jack_client_, i, false);
+    port_buffers_.assign(num_channels_, nullptr);
     connect_ports();
   }
   return true;
@@ -247,23 +251,21 @@ int JackToShmdata::jack_process(jack_nframes_t nframes, void* arg) {
     if (lock.try_lock()) {
       std::size_t num_chan = context->input_ports_.size();
       if (0 == num_chan) return 0;
-      std::vector<jack_sample_t*> jack_bufs;
-      for (auto& port : context->input_ports_) {
-        jack_sample_t* buf =
-            static_cast<jack_sample_t*>(jack_port_get_buffer(port.get_raw(), nframes));
+      for (size_t i = 0; i < num_chan; ++i) {
+        jack_sample_t* buf = static_cast<jack_sample_t*>(
+            jack_port_get_buffer(context->input_ports_[i].get_raw(), nframes));
         if (!buf) return 0;
-        jack_bufs.emplace_back(buf);
-      }
-      std::size_t index = 0;
-      for (size_t j = 0; j < nframes; ++j) {
-        for (size_t i = 0; i < num_chan; ++i) {
-          context->buf_[index] = jack_bufs[i][j];
-          ++index;
-        }
+        context->port_buffers_[i] = buf;
       }
       size_t size = nframes * num_chan * sizeof(jack_sample_t);
-      context->shm_->writer<&::shmdata::Writer::copy_to_shm>(context->buf_.data(), size);
-      context->shm_->bytes_written(size);
+      // interleave directly into the shared memory, growing it if the jack period grew
+      auto reservation = context->shm_->reserve(size);
+      if (!reservation) return 0;
+      utils::interleave(context->port_buffers_.data(),
+                        num_chan,
+                        nframes,
+                        static_cast<jack_sample_t*>(reservation.data()));
+      reservation.commit(size);
     }  // locked
   }    // releasing lock
   return 0;
@@ -53,7 +53,7 @@ class JackToShmdata : public Quiddity, public Startable {
   size_t index_{1};
   property::prop_id_t index_id_{0};
   std::mutex input_ports_mutex_{};
-  std::vector<jack_sample_t> buf_{};
+  std::vector<jack_sample_t*> port_buffers_{};  //!< Input port buffers, filled by jack_process.
   std::vector<std::string> ports_to_connect_{};
   std::mutex port_to_connect_in_jack_process_mutex_{};
   std::vector<std::pair<std::string, std::string>> port_to_connect_in_jack_process_{};
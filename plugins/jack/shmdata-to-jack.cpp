@@ -182,9 +182,7 @@ int ShmdataToJack::jack_process(jack_nframes_t nframes, void* arg) {
     std::unique_lock<std::mutex> lock(context->output_ports_mutex_, std::defer_lock);
     if (lock.try_lock()) {
       auto write_zero = false;
-      auto num_channels = context->output_ports_.size();
-      if (context->ring_buffers_.empty() ||
-          (num_channels > 0 && context->ring_buffers_[0].get_usage() < nframes)) {
+      if (!context->ring_buffer_ || context->ring_buffer_->get_usage() < nframes) {
         write_zero = true;
         context->sw_info("ring buffer empty");
       }
@@ -192,12 +190,15 @@ int ShmdataToJack::jack_process(jack_nframes_t nframes, void* arg) {
         jack_sample_t* buf = static_cast<jack_sample_t*>(
             jack_port_get_buffer(context->output_ports_[i].get_raw(), nframes));
         if (!buf) return 0;
-        if (!write_zero) {
-          context->ring_buffers_[i].pop_samples(static_cast<std::size_t>(nframes), buf);
-        } else {
+        if (write_zero) {
           for (unsigned int j = 0; j < nframes; ++j) buf[j] = 0;
         }
+        context->port_buffers_[i] = buf;
       }
+      // all channels are de-interleaved together, keeping them aligned
+      if (!write_zero)
+        context->ring_buffer_->pop_frames(static_cast<std::size_t>(nframes),
+                                          context->port_buffers_.data());
     }  // locked
   }    // releasing lock
   return 0;
@@ -207,11 +208,9 @@ void ShmdataToJack::on_xrun(uint num_of_missed_samples) {
   if (!is_constructed_) return;
   sw_info("jack xrun (delay of {} samples)", std::to_string(num_of_missed_samples));
   jack_nframes_t jack_buffer_size = jack_client_->get_buffer_size();
-  for (auto& it : ring_buffers_) {
-    // this is safe since on_xrun is called right before jack_process,
-    // on the same thread
-    it.shrink_to(static_cast<std::size_t>(jack_buffer_size * 1.5));
-  }
+  // this is safe since on_xrun is called right before jack_process,
+  // on the same thread
+  if (ring_buffer_) ring_buffer_->shrink_to(static_cast<std::size_t>(jack_buffer_size * 1.5));
 }
 
 void ShmdataToJack::on_handoff_cb(GstElement* /*object*/,
@@ -246,27 +245,21 @@ void ShmdataToJack::on_handoff_cb(GstElement* /*object*/,
   --context->debug_buffer_usage_;
   if (0 == context->debug_buffer_usage_) {
     context->sw_debug("buffer load is {}, ratio is {}",
-                      std::to_string(context->ring_buffers_[0].get_usage()),
+                      std::to_string(context->ring_buffer_->get_usage()),
                       std::to_string(context->drift_observer_.get_ratio()));
     context->debug_buffer_usage_ = 1000;
   }
   // Smoothly reduce latency if the ring buffer contain more than 10ms of audio
-  if (context->ring_buffers_[0].get_usage() > context->jack_client_->get_sample_rate() * 0.01) {
+  if (context->ring_buffer_->get_usage() > context->jack_client_->get_sample_rate() * 0.01) {
     new_size *= 0.9999;
   }
 
   jack_sample_t* tmp_buf = (jack_sample_t*)map.data;
   context->audio_resampler_->do_resample(duration, new_size, tmp_buf);
-  for (int i = 0; i < channels; ++i) {
-    std::size_t cur_pos = 0;
-    auto emplaced = context->ring_buffers_[i].put_samples(new_size, [&]() {
-      auto pos = cur_pos;
-      ++cur_pos;
-      return context->audio_resampler_->get_sample(pos, i);
-    });
-    if (emplaced != new_size)
-      context->sw_warning("overflow of {} samples", std::to_string(new_size - emplaced));
-  }
+  auto emplaced =
+      context->ring_buffer_->put_frames(context->audio_resampler_->get_samples(), new_size);
+  if (emplaced != new_size)
+    context->sw_warning("overflow of {} frames", std::to_string(new_size - emplaced));
 }
 
 bool ShmdataToJack::make_elements() {
@@ -422,9 +415,9 @@ void ShmdataToJack::on_channel_update(unsigned int channels) {
     // replacing with new ports
     for (unsigned int i = 0; i < channels; ++i) output_ports_.emplace_back(*jack_client_, i);
     update_ports_to_connect();
-    // replacing ring buffers
-    std::vector<utils::AudioRingBuffer<jack_sample_t>> tmp(channels);
-    std::swap(ring_buffers_, tmp);
+    port_buffers_.assign(channels, nullptr);
+    // replacing ring buffer
+    ring_buffer_ = std::make_unique<utils::AudioFrameRingBuffer<jack_sample_t>>(channels);
     // restarting resampler
     audio_resampler_ = std::make_unique<utils::AudioResampler<jack_sample_t>>(this, channels);
   }  // unlocking output_ports_
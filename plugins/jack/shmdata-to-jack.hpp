@@ -26,8 +26,8 @@
 #include "./jack-client.hpp"
 #include "switcher/gst/pipeliner.hpp"
 #include "switcher/shmdata/gst-tree-updater.hpp"
+#include "switcher/utils/audio-frame-ring-buffer.hpp"
 #include "switcher/utils/audio-resampler.hpp"
-#include "switcher/utils/audio-ring-buffer.hpp"
 #include "switcher/utils/drift-observer.hpp"
 
 namespace switcher {
@@ -61,9 +61,9 @@ class ShmdataToJack : public Quiddity {
       1000};  //!< Output log message about buffer usage each debug_buffer_usage_ buffers
   std::mutex output_ports_mutex_{};
   std::mutex ports_to_connect_mutex_{};
-  std::vector<utils::AudioRingBuffer<jack_sample_t>>
-      ring_buffers_{};  //!< Ring buffer for audio drift correction. There is one ring buffer per
-                        //!< channel.
+  std::unique_ptr<utils::AudioFrameRingBuffer<jack_sample_t>>
+      ring_buffer_{};  //!< Ring buffer for audio drift correction, holding all channels.
+  std::vector<jack_sample_t*> port_buffers_{};  //!< Output port buffers for the current period.
   utils::DriftObserver<jack_nframes_t>
       drift_observer_{};  //!< Track jack timing in order to correct audio drift.
   std::unique_ptr<utils::AudioResampler<jack_sample_t>>
@@ -352,8 +352,7 @@ void NVencPlugin::on_shmreader_data(void* data, size_t size) {
   es_.get()->invoke_async([](NVencES* ctx) { ctx->encode_current_input(); });
   es_.get()->invoke_async([&](NVencES* ctx) {
     ctx->process_encoded_frame([&](void* data, uint32_t enc_size) {
-      shmw_->writer<&::shmdata::Writer::copy_to_shm>(data, enc_size);
-      shmw_->bytes_written(enc_size);
+      shmw_->copy_to_shm(data, enc_size);
     });
   });
 }
@@ -100,18 +100,12 @@ int OscToShmdata::osc_handler(const char* path,
     // FIXME handle internal timetag
     // note: this is not implemented in osc-send
   }
-  size_t size = 0;
-  void* buftmp = lo_message_serialise(m, path, nullptr, &size);
-  if (context->shm_->writer<&::shmdata::Writer::alloc_size>() < size) {
-    context->shm_.reset(nullptr);
-    context->shm_.reset(new shmdata::Writer(context,
-                                            context->claw_.get_shmpath_from_writer_label("osc"),
-                                            size,
-                                            "application/x-libloserialized-osc"));
-  }
-  context->shm_->writer<&::shmdata::Writer::copy_to_shm>(buftmp, size);
-  context->shm_->bytes_written(size);
-  free(buftmp);
+  // serialise directly into the shared memory
+  size_t size = lo_message_length(m, path);
+  auto reservation = context->shm_->reserve(size);
+  if (!reservation) return 0;
+  lo_message_serialise(m, path, reservation.data(), &size);
+  reservation.commit(size);
   return 0;
 }
 
@@ -652,8 +652,7 @@ void PJCall::process_incoming_call(pjsip_rx_data* rdata) {
     auto* writer = call->rtp_writers_.back().get();
     call->ice_trans_->set_data_cb(
         call->rtp_writers_.size(), [writer, rtp_shmpath](void* data, size_t size) {
-          writer->writer<&::shmdata::Writer::copy_to_shm>(data, size);
-          writer->bytes_written(size);
+          writer->copy_to_shm(data, size);
         });
     // setting a decoder for this shmdata
     // Create a shmdata quiddity for this stream.
@@ -20,6 +20,7 @@
 #define SWITCHER_PROTOCOL_CURL_HPP
 
 #include <curl/curl.h>
+#include <atomic>
 #include "./protocol-reader.hpp"
 #include "switcher/quiddity/quiddity.hpp"
 
@@ -67,8 +67,10 @@ std::unique_ptr<ProtocolReader> ProtocolReader::create_protocol_reader(Quiddity*
 }
 
 void ProtocolReader::set_emission_period(const unsigned int& period) {
+  // commands may be network requests, they are run apart from the short periodic tasks
   ptask_ = std::make_unique<PeriodicTask<>>([this]() { continuous_emission_task(); },
-                                            std::chrono::milliseconds(period));
+                                            std::chrono::milliseconds(period),
+                                            Scheduler::get_blocking());
 }
 
 void ProtocolReader::continuous_emission_task() {
@@ -329,13 +329,9 @@ void PulseSink::on_shmreader_data(void* raw_data, size_t data_size) {
   }
   audio_resampler_->do_resample(duration, new_size, static_cast<const float*>(data));
 
+  const auto* resampled = audio_resampler_->get_samples();
   for (unsigned int i = 0; i < shmf_caps_.channels(); ++i) {
-    std::size_t cur_pos = 0;
-    auto emplaced = ring_buffers_[i].put_samples(new_size, [&]() {
-      auto pos = cur_pos;
-      ++cur_pos;
-      return audio_resampler_->get_sample(pos, i);
-    });
+    auto emplaced = ring_buffers_[i].put_samples(resampled + i, new_size, shmf_caps_.channels());
 
     if (emplaced != new_size)
       sw_warning("overflow of {} samples", std::to_string(new_size - emplaced));
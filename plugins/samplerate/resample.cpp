@@ -74,10 +74,7 @@ Resample::Resample(quiddity::Config&& conf)
           [this]() { return algo_.get(); },
           "Resampling algorithm",
           "Balance fidelity vs. speed",
-          algo_)) {
-  resampled_.resize(resampled_size_);
-  in_converted_.resize(resampled_size_);
-}
+          algo_)) {}
 
 bool Resample::connect(const std::string& path) {
   shmr_.reset();
@@ -92,48 +89,41 @@ bool Resample::connect(const std::string& path) {
         resampler_data_->input_frames =
             size / (incaps_->channels() * incaps_->format_size_in_bytes());
         resampler_data_->output_frames = resampler_data_->input_frames * resampler_data_->src_ratio;
-        // resize buffers if necessary
-        auto expected_resampled_size =
-            resampler_data_->output_frames * incaps_->channels() * sizeof(float);
-        if (resampled_size_ < expected_resampled_size) {
-          resampled_size_ = expected_resampled_size;
-          resampled_.resize(resampled_size_);
-        }
+        // resize buffer if necessary
         auto required_sample_for_convertion =
             size * sizeof(float) / incaps_->format_size_in_bytes();
         if (in_converted_size_ < required_sample_for_convertion) {
           in_converted_size_ = required_sample_for_convertion;
           in_converted_.resize(in_converted_size_);
         }
-        // configure resampler memory
+        // configure resampler input
         if (incaps_->is_float()) {
           resampler_data_->data_in = static_cast<float*>(buf);
-          resampler_data_->data_out = resampled_.data();
         } else if (incaps_->format_size_in_bytes() == sizeof(short)) {
           src_short_to_float_array(static_cast<short*>(buf),
                                    in_converted_.data(),
                                    size / incaps_->format_size_in_bytes());
           resampler_data_->data_in = in_converted_.data();
-          resampler_data_->data_out = resampled_.data();
         } else if (incaps_->format_size_in_bytes() == sizeof(int)) {
           src_int_to_float_array(
               static_cast<int*>(buf), in_converted_.data(), size / incaps_->format_size_in_bytes());
           resampler_data_->data_in = in_converted_.data();
-          resampler_data_->data_out = resampled_.data();
         } else {
           sw_warning("BUG in resample shmr data handler");
           return;
         }
-        // do resampling
+        // resample directly into the shared memory
+        auto reservation = shmw_->reserve(resampler_data_->output_frames * incaps_->channels() *
+                                          sizeof(float));
+        if (!reservation) return;
+        resampler_data_->data_out = static_cast<float*>(reservation.data());
         auto err = src_process(resampler_config_, resampler_data_.get());
         if (err) {
           sw_error("resample error: {}", std::string(src_strerror(err)));
           return;
         }
-        // write to shmdata
-        auto written = resampler_data_->output_frames_gen * incaps_->channels() * sizeof(float);
-        shmw_->writer<&::shmdata::Writer::copy_to_shm>(resampled_.data(), written);
-        shmw_->bytes_written(written);
+        reservation.commit(resampler_data_->output_frames_gen * incaps_->channels() *
+                           sizeof(float));
       },
       [this](const std::string& str_caps) {
         if (nullptr != resampler_config_) src_delete(resampler_config_);  // FIXME make this RAII
@@ -37,8 +37,6 @@ class Resample : public Quiddity {
 
   static const std::string kConnectionSpec;  //!< Shmdata specifications
   // resampling
-  size_t resampled_size_{0};
-  std::vector<float> resampled_{};  //!< buffer of resampled data
   size_t in_converted_size_{0};
   std::vector<float> in_converted_{};  //!< depth converted input buffer
   SRC_STATE* resampler_config_{nullptr};
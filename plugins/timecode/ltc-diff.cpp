@@ -123,9 +123,7 @@ bool LTCDiff::on_shmdata_connect(const std::string& shmpath, claw::sfid_t sfid)
           }
 
           time_difference_ = std::max<double>(time_difference_, -time_difference_) * 1000;
-          shmw_->writer<&::shmdata::Writer::copy_to_shm>(&time_difference_,
-                                                               sizeof(time_difference_));
-          shmw_->bytes_written(sizeof(time_difference_));
+          shmw_->copy_to_shm(&time_difference_, sizeof(time_difference_));
           time_difference_ = 0;
         },
         nullptr,
@@ -302,11 +302,12 @@ void LTCSource::write_samples_to_shmdata(const unsigned int& nb_samples) {
   if (!nb_samples || samples_.size() < nb_samples) return;
 
   auto samples_size = sizeof(ltcsnd_sample_t) * nb_samples;
-  std::vector<ltcsnd_sample_t> array;
-  array.reserve(samples_size);
-  std::copy(samples_.begin(), samples_.begin() + nb_samples, array.begin());
-  shmw_->writer<&::shmdata::Writer::copy_to_shm>(array.data(), samples_size);
-  shmw_->bytes_written(samples_size);
+  auto reservation = shmw_->reserve(samples_size);
+  if (!reservation) return;
+  std::copy(samples_.begin(),
+            samples_.begin() + nb_samples,
+            static_cast<ltcsnd_sample_t*>(reservation.data()));
+  reservation.commit(samples_size);
   for (unsigned int i = 0; i < nb_samples; ++i) {
     samples_.pop_front();
   }
@@ -22,6 +22,7 @@
 
 #include <jack/jack.h>
 #include <ltc.h>
+#include <atomic>
 #include <deque>
 #include <fstream>
 #include <switcher/quiddity/startable.hpp>
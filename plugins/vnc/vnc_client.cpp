@@ -118,9 +118,7 @@ bool VncClientSrc::start() {
       if (i > 0) {
         if (!HandleRFBServerMessage(rfb_client_)) return;
         if (vnc_writer_) {
-          vnc_writer_->writer<&::shmdata::Writer::copy_to_shm>(rfb_client_->frameBuffer,
-                                                                     framebuffer_size_);
-          vnc_writer_->bytes_written(framebuffer_size_);
+          vnc_writer_->copy_to_shm(rfb_client_->frameBuffer, framebuffer_size_);
         }
       }
     }
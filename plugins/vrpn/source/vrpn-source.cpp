@@ -426,12 +426,15 @@ int VRPNSource::handleMessage(void* userData, vrpn_HANDLERPARAM p) {
 
   context->watchDevice(senderName, typeName);
 
-  std::vector<unsigned char> buffer((size_t)(
-      sizeof(uint32_t) + senderName.length() + sizeof(uint32_t) + typeName.length() +
-      sizeof(p.msg_time.tv_sec) + sizeof(p.msg_time.tv_usec) + sizeof(uint32_t) + p.payload_len));
+  size_t size = (size_t)(sizeof(uint32_t) + senderName.length() + sizeof(uint32_t) +
+                         typeName.length() + sizeof(p.msg_time.tv_sec) +
+                         sizeof(p.msg_time.tv_usec) + sizeof(uint32_t) + p.payload_len);
 
-  // BUFFER
-  auto buffer_ptr = buffer.data();
+  // BUFFER, written directly into the shared memory
+  auto reservation = context->shmDataWriter_->reserve(size);
+  if (!reservation) return 0;
+  auto buffer = static_cast<unsigned char*>(reservation.data());
+  auto buffer_ptr = buffer;
 
   // SENDER
   *((uint32_t*)buffer_ptr) = htonl((uint32_t)senderName.length());
@@ -456,27 +459,29 @@ int VRPNSource::handleMessage(void* userData, vrpn_HANDLERPARAM p) {
   buffer_ptr += sizeof(p.payload_len);
   memcpy(buffer_ptr, p.buffer, (uint32_t)p.payload_len);
 
+  // keep a copy for the debug dump, the shared memory stays locked until the commit
+  std::string dump;
+  if (context->debug_) dump.assign(reinterpret_cast<const char*>(buffer), size);
+
+  // PUBLISH TO SHMDATA
+  reservation.commit(size);
+
   // DEBUG
   if (context->debug_) {
     context->sw_debug("VRPNSource >>> Sender: {} Type: {} Length: {} Payload: {}",
                       senderName,
                       typeName,
-                      std::to_string(buffer.size()),
+                      std::to_string(size),
                       std::to_string(p.payload_len));
 
     std::stringstream ss;
     ss << "VRPNSource >>> ";
-    for (auto const& value : buffer) {
-      ss << std::hex << std::setfill('0') << std::setw(2) << (int)value << " ";
+    for (auto byte : dump) {
+      ss << std::hex << std::setfill('0') << std::setw(2) << (int)(unsigned char)byte << " ";
     }
     context->sw_debug(ss.str());
   }
 
-  // WRITE TO SHMDATA
-  context->shmDataWriter_->writer<&::shmdata::Writer::copy_to_shm>(buffer.data(),
-                                                                         buffer.size());
-  context->shmDataWriter_->bytes_written(buffer.size());
-
   return 0;
 }
 
@@ -19,10 +19,24 @@
 
 #undef NDEBUG  // get assert in release mode
 
+#include <shmdata/console-logger.hpp>
+#include <shmdata/writer.hpp>
 #include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <thread>
 #include "switcher/quiddity/basic-test.hpp"
 #include "switcher/switcher.hpp"
 
+bool wait_for(std::function<bool()> predicate) {
+  for (int i = 0; i < 200; ++i) {
+    if (predicate()) return true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return false;
+}
+
 int main() {
   {
     using namespace switcher;
@@ -31,6 +45,26 @@ int main() {
 
     assert(quiddity::test::full(manager, "watcher"));
 
+    // shmdata created and removed in a subdirectory are followed and forgotten
+    char dir_template[] = "/tmp/check_watcher_XXXXXX";
+    const std::string dir(mkdtemp(dir_template));
+    std::filesystem::create_directories(dir + "/sub");
+    auto watcher =
+        manager->quids<&quiddity::Container::create>("watcher", "dirwatch", nullptr).get();
+    assert(watcher);
+    assert(watcher->prop<&quiddity::property::PBag::set_str_str>("directory", dir));
+    assert(watcher->prop<&quiddity::property::PBag::set_str_str>("started", "true"));
+    const std::string shmpath = dir + "/sub/check_watcher";
+    const std::string caps_key = ".shmdata.writer." + shmpath + ".caps";
+    {
+      ::shmdata::ConsoleLogger logger;
+      ::shmdata::Writer writer(shmpath, sizeof(int), "application/x-check-watcher", &logger);
+      assert(writer);
+      assert(wait_for([&]() { return watcher->tree<&InfoTree::branch_has_data>(caps_key); }));
+    }
+    assert(wait_for([&]() { return !watcher->tree<&InfoTree::branch_has_data>(caps_key); }));
+    assert(watcher->prop<&quiddity::property::PBag::set_str_str>("started", "false"));
+    std::filesystem::remove_all(dir);
   }  // end of scope is releasing the manager
   return 0;
 }
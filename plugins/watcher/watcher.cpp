@@ -18,11 +18,22 @@
  */
 
 #include "watcher.hpp"
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <array>
+#include <cerrno>
+#include <cstring>
 
 namespace fs = std::filesystem;
 
 namespace switcher {
 namespace quiddities {
+namespace {
+// interval between looks for the watched directory while it is gone
+const int kRetryIntervalMs = 500;
+}  // namespace
+
 SWITCHER_MAKE_QUIDDITY_DOCUMENTATION(Watcher,
                                      "watcher",
                                      "Directory watcher",
@@ -86,57 +97,163 @@ bool Watcher::start() {
     fs::permissions(directory_, fs::perms::all, fs::perm_options::replace);
   }
 
-  // Launch periodic checking
-  readEventsTask_ = std::make_unique<PeriodicTask<>>([this]() { watch_events(); },
-                                                     std::chrono::milliseconds(500));
+  // Watch the directory tree from the event loop
+  inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  quit_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (inotify_fd_ < 0 || quit_fd_ < 0) {
+    sw_error("Directory watching could not be initialized. Error: {}", strerror(errno));
+    stop();
+    return false;
+  }
+  root_gone_ = !watch_dir(directory_);
+  event_loop_ = std::thread([this]() { event_loop(); });
 
   return true;
 }
 
 bool Watcher::stop() {
-  readEventsTask_ = nullptr;
+  if (event_loop_.joinable()) {
+    uint64_t quit = 1;
+    if (static_cast<ssize_t>(sizeof(quit)) != write(quit_fd_, &quit, sizeof(quit)))
+      sw_error("Directory watching could not be stopped. Error: {}", strerror(errno));
+    event_loop_.join();
+  }
   followers_.clear();
+  watched_dirs_.clear();
+  if (inotify_fd_ >= 0) close(inotify_fd_);
+  inotify_fd_ = -1;
+  if (quit_fd_ >= 0) close(quit_fd_);
+  quit_fd_ = -1;
   return true;
 }
 
-void Watcher::watch_events() {
-  // Check if a file was deleted
-  auto it = followers_.begin();
-  while (it != followers_.end()) {
-    if (!fs::exists(fs::path(std::get<0>(*it)))) {
+void Watcher::event_loop() {
+  std::array<pollfd, 2> fds{{{inotify_fd_, POLLIN, 0}, {quit_fd_, POLLIN, 0}}};
+  alignas(struct inotify_event) char buf[4096];
+  while (true) {
+    auto res = poll(fds.data(), fds.size(), root_gone_ ? kRetryIntervalMs : -1);
+    if (res < 0) {
+      if (EINTR == errno) continue;
+      sw_error("Directory watching failed. Error: {}", strerror(errno));
+      return;
+    }
+    if (0 == res) {
+      std::error_code ec;
+      if (fs::is_directory(directory_, ec) && watch_dir(directory_)) {
+        sw_info("Watched directory {} is back.", directory_);
+        root_gone_ = false;
+      }
+      continue;
+    }
+    if (0 != fds[1].revents) return;
+    ssize_t len;
+    while ((len = read(inotify_fd_, buf, sizeof(buf))) > 0) {
+      for (char* ptr = buf; ptr < buf + len;) {
+        auto event = reinterpret_cast<const struct inotify_event*>(ptr);
+        handle_event(event);
+        ptr += sizeof(struct inotify_event) + event->len;
+      }
+    }
+  }
+}
+
+void Watcher::handle_event(const struct inotify_event* event) {
+  if (event->mask & IN_Q_OVERFLOW) {
+    rescan();
+    return;
+  }
+  auto dir = watched_dirs_.find(event->wd);
+  if (watched_dirs_.end() == dir) return;
+  if (event->mask & IN_IGNORED) {
+    // the directory has been removed, it is watched again once recreated
+    if (dir->second == directory_) {
+      sw_warning("Watched directory {} is gone.", directory_);
+      root_gone_ = true;
+    }
+    watched_dirs_.erase(dir);
+    return;
+  }
+  if (0 == event->len) return;
+  const auto path = (fs::path(dir->second) / event->name).string();
+  if (event->mask & IN_ISDIR) {
+    if (event->mask & (IN_CREATE | IN_MOVED_TO))
+      watch_dir(path);
+    else if (event->mask & IN_MOVED_FROM)
+      unwatch_dir(path);
+    return;
+  }
+  if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+    std::error_code ec;
+    if (fs::is_socket(path, ec)) create_follower(path);
+  } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+    followers_.erase(path);
+  }
+}
+
+bool Watcher::watch_dir(const std::string& dir) {
+  auto wd = inotify_add_watch(inotify_fd_,
+                              dir.c_str(),
+                              IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+  if (wd < 0) {
+    sw_warning("Directory {} cannot be watched. Error: {}", dir, strerror(errno));
+    return false;
+  }
+  watched_dirs_[wd] = dir;
+  // the content may have been created before the watch
+  std::error_code ec;
+  for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+    const auto path = it->path().string();
+    std::error_code entry_ec;  // the entry may be gone already
+    if (fs::is_directory(it->symlink_status(entry_ec)))
+      watch_dir(path);
+    else if (it->is_socket(entry_ec))
+      create_follower(path);
+  }
+  return true;
+}
+
+void Watcher::unwatch_dir(const std::string& dir) {
+  // a directory moved out of the tree is not watched anymore, nor its subdirectories
+  const auto prefix = dir + "/";
+  for (auto it = followers_.begin(); it != followers_.end();) {
+    if (0 == it->first.compare(0, prefix.size(), prefix))
       it = followers_.erase(it);
+    else
+      ++it;
+  }
+  for (auto it = watched_dirs_.begin(); it != watched_dirs_.end();) {
+    if (it->second == dir || 0 == it->second.compare(0, prefix.size(), prefix)) {
+      inotify_rm_watch(inotify_fd_, it->first);
+      it = watched_dirs_.erase(it);
     } else {
       ++it;
     }
   }
+}
 
-  // Check if a file was created
-  for (auto& file : fs::recursive_directory_iterator(directory_)) {
-    std::string path = file.path().string();
-    if (std::find_if(followers_.begin(),
-                     followers_.end(),
-                     [path](const std::tuple<std::string, std::unique_ptr<shmdata::Follower>>& t) {
-                       return std::get<0>(t) == path;
-                     }) == followers_.end()) {
-      if (fs::is_socket(file.path())) {
-        create_follower(path);
-      }
-    }
+void Watcher::rescan() {
+  // events have been lost, forget removed sockets and look for new ones
+  std::error_code ec;
+  for (auto it = followers_.begin(); it != followers_.end();) {
+    if (fs::is_socket(it->first, ec))
+      ++it;
+    else
+      it = followers_.erase(it);
   }
-  return;
+  root_gone_ = !watch_dir(directory_);
 }
 
 void Watcher::create_follower(const std::string& shmpath) {
-  followers_.push_back(
-      std::make_tuple(shmpath,
-                      std::make_unique<shmdata::Follower>(this,
-                                                          shmpath,
-                                                          nullptr,
-                                                          nullptr,
-                                                          nullptr,
-                                                          shmdata::Stat::kDefaultUpdateInterval,
-                                                          shmdata::Follower::Direction::writer,
-                                                          true)));
+  if (followers_.count(shmpath)) return;
+  followers_.emplace(shmpath,
+                     std::make_unique<shmdata::Follower>(this,
+                                                         shmpath,
+                                                         nullptr,
+                                                         nullptr,
+                                                         nullptr,
+                                                         shmdata::Stat::kDefaultUpdateInterval,
+                                                         shmdata::Follower::Direction::writer,
+                                                         true));
 }
 
 Watcher::DirectoryStatus Watcher::dir_exists(const std::string path) const {
@@ -20,19 +20,26 @@
 #ifndef __SWITCHER_WATCHER_H__
 #define __SWITCHER_WATCHER_H__
 
+#include <sys/inotify.h>
 #include <filesystem>
 #include <memory>
 #include <string>
-#include <vector>
+#include <thread>
+#include <unordered_map>
 #include "switcher/quiddity/container.hpp"
 #include "switcher/quiddity/quiddity.hpp"
 #include "switcher/quiddity/startable.hpp"
 #include "switcher/shmdata/follower.hpp"
-#include "switcher/utils/periodic-task.hpp"
 
 namespace switcher {
 namespace quiddities {
 using namespace quiddity;
+/**
+ * Watcher follows the shmdata sockets found in a directory and its subdirectories. Directories
+ * are watched with inotify from an event loop thread, so sockets are followed as soon as they
+ * are created, without polling the directory. If the watched directory is removed, it is looked
+ * for periodically and watched again once recreated.
+ */
 class Watcher : public Quiddity, public Startable {
  public:
   enum class DirectoryStatus { ERROR, ABSENT, PRESENT, IS_FILE };
@@ -42,8 +49,13 @@ class Watcher : public Quiddity, public Startable {
   Watcher& operator=(const Watcher&) = delete;
 
  private:
-  std::vector<std::tuple<std::string, std::unique_ptr<shmdata::Follower>>> followers_;
-  std::unique_ptr<PeriodicTask<>> readEventsTask_;
+  // followed sockets and watched directories are accessed by the event loop only, while running
+  std::unordered_map<std::string, std::unique_ptr<shmdata::Follower>> followers_{};
+  std::unordered_map<int, std::string> watched_dirs_{};  //!< Paths by watch descriptor.
+  bool root_gone_{false};  //!< The watched directory is looked for periodically until back.
+  int inotify_fd_{-1};
+  int quit_fd_{-1};  //!< Written by stop in order to wake up the event loop.
+  std::thread event_loop_{};
   std::string directory_{"."};
   property::prop_id_t directory_id_;
   bool create_dir_{false};
@@ -53,7 +65,11 @@ class Watcher : public Quiddity, public Startable {
   bool start() final;
   bool stop() final;
 
-  void watch_events();
+  void event_loop();
+  void handle_event(const struct inotify_event* event);
+  bool watch_dir(const std::string& dir);
+  void unwatch_dir(const std::string& dir);
+  void rescan();
   void create_follower(const std::string& shmpath);
   DirectoryStatus dir_exists(const std::string path) const;
 };
@@ -24,6 +24,7 @@
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 #include "../utils/threaded-wrapper.hpp"
 
 namespace switcher {
@@ -23,12 +23,18 @@
 #include "../utils/scope-exit.hpp"
 #include "../utils/string-utils.hpp"
 #include "./json-serializer.hpp"
+#include "./node-allocator.hpp"
 
 namespace switcher {
 
-InfoTree::ptr InfoTree::make() {
-  std::shared_ptr<InfoTree> tree;  // can't use make_shared because ctor is private
-  tree.reset(new InfoTree());
+const InfoTree::children_t::size_type InfoTree::kChildIndexThreshold = 16;
+const size_t InfoTree::kMaxPrunedKeys = 64;
+
+InfoTree::ptr InfoTree::make() { return make_node(Any()); }
+
+InfoTree::ptr InfoTree::make_node(Any&& data) {
+  auto tree =
+      std::allocate_shared<InfoTree>(infotree::NodeAllocator<InfoTree>(), std::move(data));
   tree->me_ = tree;
   return tree;
 }
@@ -59,37 +65,53 @@ InfoTree::ptr InfoTree::merge(InfoTree::ptrc first, InfoTree::ptrc second) {
 }
 
 InfoTree::ptr InfoTree::copy(InfoTree::ptrc tree) {
-  auto res = InfoTree::make();
-  std::list<std::string> path;
+  if (!tree) return make();
+  return clone(tree, next_version());
+}
 
-  if (tree) {
-    auto root_value = tree->get_value();
-    if (root_value.not_null()) {
-      res->set_value(root_value);
+InfoTree::ptr InfoTree::clone(InfoTree::ptrc tree, std::uint64_t version) {
+  std::lock_guard<std::recursive_mutex> lock(tree->mutex_);
+  auto res = make_node(Any(tree->data_));
+  res->is_array_ = tree->is_array_;
+  res->changed_ = 0 == version ? tree->changed_.load() : version;
+  res->version_ = 0 == version ? tree->version_.load() : version;
+  res->children_.reserve(tree->children_.size());
+  for (auto& it : tree->children_) {
+    if (!it.second) continue;
+    auto child = clone(it.second.get(), version);
+    res->adopt(child.get());
+    res->children_.emplace_back(it.first, std::move(child));
+  }
+  if (res->children_.size() >= kChildIndexThreshold) res->index_children();
+  return res;
+}
+
+InfoTree::ptr InfoTree::clone_shared(InfoTree::ptrc tree, const InfoTree::ptr& previous) {
+  std::lock_guard<std::recursive_mutex> lock(tree->mutex_);
+  // a node grafted since the previous copy has no counterpart in it
+  if (!previous || tree->changed_ != previous->changed_) return clone(tree, 0);
+  // modifications stamp the nodes along their path and the ancestors of the modified node
+  if (tree->version_ == previous->version_) return previous;
+  // the node is copied, but its children may still be shared
+  auto res = make_node(Any(tree->data_));
+  res->is_array_ = tree->is_array_;
+  res->changed_ = tree->changed_.load();
+  res->version_ = tree->version_.load();
+  res->children_.reserve(tree->children_.size());
+  for (children_t::size_type i = 0; i < tree->children_.size(); ++i) {
+    auto& it = tree->children_[i];
+    if (!it.second) continue;
+    InfoTree::ptr previous_child;
+    if (i < previous->children_.size() && previous->children_[i].first == it.first) {
+      previous_child = previous->children_[i].second;
+    } else {
+      auto hash = previous->child_index_ ? infotree::Path::hash_key(it.first) : 0;
+      auto found = previous->get_child_index(it.first, hash);
+      if (found.first) previous_child = previous->children_[found.second].second;
     }
-    preorder_tree_walk(tree,
-                       [&](const std::string& name, InfoTree::ptrc tree, bool is_array_element) {
-                         std::string key{"."};
-                         for (auto& it : path) {
-                           key += it + ".";
-                         }
-                         if (is_array_element) {
-                           res->tag_as_array(key, true);
-                         }
-                         path.push_back(name);
-                         key += "." + name;
-                         auto value = tree->read_data();
-                         if (value.not_null())
-                           res->graft(key, make(value));
-                         else
-                           res->graft(key, make());
-                         return true;
-                       },
-                       [&](const std::string&, InfoTree::ptrc, bool) {
-                         path.pop_back();
-                         return true;
-                       });
+    res->children_.emplace_back(it.first, clone_shared(it.second.get(), previous_child));
   }
+  if (res->children_.size() >= kChildIndexThreshold) res->index_children();
   return res;
 }
 
@@ -129,7 +151,7 @@ void InfoTree::preorder_tree_walk(InfoTree::ptrc tree,
 
 InfoTree::InfoTree(const Any& data) : data_(data) {}
 
-InfoTree::InfoTree(Any&& data) : data_(data) {}
+InfoTree::InfoTree(Any&& data) : data_(std::move(data)) {}
 
 bool InfoTree::empty() const {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
@@ -164,23 +186,35 @@ const Any& InfoTree::read_data() const {
 void InfoTree::set_value(const Any& data) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   data_ = data;
+  auto version = next_version();
+  changed_ = version;
+  version_ = version;
+  touch_ancestors(version);
 }
 
 void InfoTree::set_value(const char* data) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   data_ = std::string(data);
+  auto version = next_version();
+  changed_ = version;
+  version_ = version;
+  touch_ancestors(version);
 }
 
 void InfoTree::set_value(std::nullptr_t ptr) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   data_ = ptr;
+  auto version = next_version();
+  changed_ = version;
+  version_ = version;
+  touch_ancestors(version);
 }
 
 bool InfoTree::branch_is_leaf(const std::string& path) const {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   if (path_is_root(path)) return children_.empty();
   auto found = get_node(path);
-  if (nullptr != found.first) return (*found.first)[found.second].second->children_.empty();
+  if (nullptr != found.first) return found.first->children_[found.second].second->children_.empty();
   return false;
 }
 
@@ -188,23 +222,35 @@ bool InfoTree::branch_is_array(const std::string& path) const {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   if (path_is_root(path)) return children_.empty();
   auto found = get_node(path);
-  if (nullptr != found.first) return (*found.first)[found.second].second->is_array_;
+  if (nullptr != found.first) return found.first->children_[found.second].second->is_array_;
   return false;
 }
 
-bool InfoTree::branch_has_data(const std::string& path) const {
+bool InfoTree::branch_has_data(const std::string& path) const { return branch_has_data_at(path); }
+
+bool InfoTree::branch_has_data(const infotree::Path& path) const {
+  return branch_has_data_at(path);
+}
+
+bool InfoTree::branch_has_data_at(infotree::PathCursor path) const {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
-  if (path_is_root(path)) return data_.not_null();
+  if (path.is_root()) return data_.not_null();
   auto found = get_node(path);
-  if (nullptr != found.first) return (*found.first)[found.second].second->data_.not_null();
+  if (nullptr != found.first) return found.first->children_[found.second].second->data_.not_null();
   return false;
 }
 
-Any InfoTree::branch_get_value(const std::string& path) const {
+Any InfoTree::branch_get_value(const std::string& path) const { return branch_get_value_at(path); }
+
+Any InfoTree::branch_get_value(const infotree::Path& path) const {
+  return branch_get_value_at(path);
+}
+
+Any InfoTree::branch_get_value_at(infotree::PathCursor path) const {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
-  if (path_is_root(path)) return data_;
+  if (path.is_root()) return data_;
   auto found = get_node(path);
-  if (nullptr != found.first) return (*found.first)[found.second].second->data_;
+  if (nullptr != found.first) return found.first->children_[found.second].second->data_;
   Any res;
   return res;
 }
@@ -213,17 +259,36 @@ InfoTree::ptr InfoTree::get_copy() const { return copy(this); }
 
 InfoTree::ptr InfoTree::branch_get_copy(const std::string& path) const {
   if (path_is_root(path)) return copy(this);
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   auto found = get_node(path);
   if (nullptr == found.first) return nullptr;
-  return copy((*found.first)[found.second].second.get());
+  return copy(found.first->children_[found.second].second.get());
 }
 
 bool InfoTree::branch_set_value(const std::string& path, const Any& data) {
+  return branch_set_value_at(path, data);
+}
+
+bool InfoTree::branch_set_value(const infotree::Path& path, const Any& data) {
+  return branch_set_value_at(path, data);
+}
+
+bool InfoTree::branch_set_value_at(infotree::PathCursor path, const Any& data) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
-  if (path_is_root(path)) return data_ = data;
+  auto version = next_version();
+  if (path.is_root()) {
+    changed_ = version;
+    version_ = version;
+    touch_ancestors(version);
+    return data_ = data;
+  }
   auto found = get_node(path);
   if (nullptr != found.first) {
-    (*found.first)[found.second].second->data_ = data;
+    auto& tree = found.first->children_[found.second].second;
+    tree->data_ = data;
+    tree->changed_ = version;
+    touch(path, version);
+    touch_ancestors(version);
     return true;
   }
   return false;
@@ -238,94 +303,293 @@ bool InfoTree::branch_set_value(const std::string& path, std::nullptr_t ptr) {
 }
 
 std::pair<bool, InfoTree::children_t::size_type> InfoTree::get_child_index(
-    const std::string& key) const {
+    std::string_view key, infotree::Path::hash_t hash) const {
+  if (child_index_) {
+    auto range = child_index_->equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (children_[it->second].first == key) return std::make_pair(true, it->second);
+    }
+    return std::make_pair(false, 0);
+  }
   auto found =
       std::find_if(children_.begin(), children_.end(), [key](const InfoTree::child_type& s) {
-        return (0 == s.first.compare(key));
+        return s.first == key;
       });
   return std::make_pair(children_.end() != found,
                         children_.end() != found ? found - children_.begin() : 0);
 }
 
-InfoTree::ptr InfoTree::prune(const std::string& path) {
+void InfoTree::add_child(std::string_view key, infotree::Path::hash_t hash, InfoTree::ptr child) {
+  adopt(child.get());
+  children_.emplace_back(std::string(key), child);
+  if (child_index_) {
+    child_index_->emplace(hash, children_.size() - 1);
+    return;
+  }
+  if (children_.size() < kChildIndexThreshold) return;
+  index_children();
+}
+
+void InfoTree::index_children() {
+  child_index_ = std::make_unique<child_index_t>();
+  child_index_->reserve(children_.size());
+  for (children_t::size_type i = 0; i < children_.size(); ++i)
+    child_index_->emplace(infotree::Path::hash_key(children_[i].first), i);
+}
+
+void InfoTree::remove_child(children_t::size_type index) {
+  disown(children_[index].second.get());
+  children_.erase(children_.begin() + index);
+  if (!child_index_) return;
+  if (children_.size() < kChildIndexThreshold / 2) {
+    child_index_.reset();
+    return;
+  }
+  // remove the entry of the erased child and shift indexes of the following ones
+  for (auto it = child_index_->begin(); it != child_index_->end();) {
+    if (it->second == index) {
+      it = child_index_->erase(it);
+      continue;
+    }
+    if (it->second > index) --it->second;
+    ++it;
+  }
+}
+
+InfoTree::ptr InfoTree::prune(const std::string& path) { return prune_at(path); }
+
+InfoTree::ptr InfoTree::prune(const infotree::Path& path) { return prune_at(path); }
+
+InfoTree::ptr InfoTree::prune_at(infotree::PathCursor path) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   auto found = get_node(path);
   if (nullptr != found.first) {
-    On_scope_exit { found.first->erase(found.first->begin() + found.second); };
-    return (*found.first)[found.second].second;
+    auto res = found.first->children_[found.second].second;
+    auto version = next_version();
+    found.first->add_pruned(found.first->children_[found.second].first, version);
+    found.first->remove_child(found.second);
+    touch(path, version);
+    touch_ancestors(version);
+    return res;
   }
   return InfoTree::make_null();
 }
 
-InfoTree::ptr InfoTree::get_tree(const std::string& path) {
+InfoTree::ptr InfoTree::get_tree(const std::string& path) { return get_tree_at(path); }
+
+InfoTree::ptr InfoTree::get_tree(const infotree::Path& path) { return get_tree_at(path); }
+
+InfoTree::ptr InfoTree::get_tree_at(infotree::PathCursor path) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
-  if (path_is_root(path)) return me_.lock();
+  if (path.is_root()) return me_.lock();
   auto found = get_node(path);
-  if (nullptr != found.first) return (*found.first)[found.second].second;
+  if (nullptr != found.first) return found.first->children_[found.second].second;
   // not found
   return make();
 }
 
-InfoTree::GetNodeReturn InfoTree::get_node(const std::string& path) const {
-  std::istringstream iss(path);
-  return get_next(iss, nullptr, 0);
+InfoTree::GetNodeReturn InfoTree::get_node(infotree::PathCursor path) const {
+  // children_ is mutable, the parent is returned as non const in order to allow modifications
+  // from non const methods
+  auto tree = const_cast<InfoTree*>(this);
+  GetNodeReturn res(nullptr, 0);
+  while (path.next()) {
+    auto child_index = tree->get_child_index(path.key(), path.hash());
+    if (!child_index.first) return std::make_pair(nullptr, 0);
+    res = std::make_pair(tree, child_index.second);
+    tree = tree->children_[child_index.second].second.get();
+  }
+  return res;
 }
 
-InfoTree::GetNodeReturn InfoTree::get_next(std::istringstream& path,
-                                           InfoTree::children_t* parent_vector,
-                                           children_t::size_type index) const {
-  std::string child_key;
-  if (!std::getline(path, child_key, '.')) return std::make_pair(parent_vector, index);
-  if (child_key.empty()) return get_next(path, parent_vector, index);
+bool InfoTree::graft(const std::string& where, InfoTree::ptr tree) { return graft_at(where, tree); }
 
-  auto child_index = get_child_index(child_key);
-  if (!child_index.first) return std::make_pair(nullptr, 0);
-  return children_[child_index.second].second->get_next(path, &children_, child_index.second);
+bool InfoTree::graft(const infotree::Path& where, InfoTree::ptr tree) {
+  return graft_at(where, tree);
 }
 
-bool InfoTree::graft(const std::string& where, InfoTree::ptr tree) {
-  if (!tree) return false;
+bool InfoTree::graft_at(infotree::PathCursor path, InfoTree::ptr leaf) {
+  if (!leaf) return false;
   std::lock_guard<std::recursive_mutex> lock(mutex_);
-  std::istringstream iss(where);
-  return !graft_next(iss, this, tree);
-}
-
-bool InfoTree::graft_next(std::istringstream& path, InfoTree* tree, InfoTree::ptr leaf) {
-  std::string child;
-  if (!std::getline(path, child, '.')) return true;
-  if (child.empty())  // in case of two or more consecutive dots
-    return graft_next(path, tree, leaf);
-  auto index = tree->get_child_index(child);
-  if (index.first) {
-    if (graft_next(path, tree->children_[index.second].second.get(), leaf))
-      // graft on already existing child
-      tree->children_[index.second].second =
-          leaf;  // replacing the previously empy tree with the one to graft
-  } else {
-    InfoTree::ptr child_node = make();
-    tree->children_.emplace_back(child, child_node);
-    if (graft_next(path, child_node.get(), leaf))  // graft on already existing child
-    {
-      // replacing empty tree for replacement by leaf
-      tree->children_.pop_back();
-      tree->children_.emplace_back(child, leaf);
+  if (!path.next()) return false;
+  auto version = next_version();
+  InfoTree* tree = this;
+  while (true) {
+    tree->version_ = version;
+    auto key = path.key();
+    auto hash = path.hash();
+    auto is_last = !path.next();
+    auto index = tree->get_child_index(key, hash);
+    if (is_last) {
+      leaf->changed_ = version;
+      if (index.first) {
+        // replacing the previous tree with the one to graft
+        tree->disown(tree->children_[index.second].second.get());
+        tree->adopt(leaf.get());
+        tree->children_[index.second].second = leaf;
+      } else {
+        tree->remove_pruned(key);
+        tree->add_child(key, hash, leaf);
+      }
+      touch_ancestors(version);
+      return true;
+    }
+    if (index.first) {
+      tree = tree->children_[index.second].second.get();
+    } else {
+      InfoTree::ptr child_node = make();
+      child_node->changed_ = version;
+      tree->remove_pruned(key);
+      tree->add_child(key, hash, child_node);
+      tree = child_node.get();
     }
   }
-  return false;
 }
 
 bool InfoTree::tag_as_array(const std::string& path, bool is_array) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   InfoTree::ptr tree = InfoTree::get_tree(path);
   if (!(bool)tree) return false;
   tree->is_array_ = is_array;
+  auto version = next_version();
+  tree->changed_ = version;
+  touch(path, version);
+  touch_ancestors(version);
   return true;
 }
 
 bool InfoTree::make_array(bool is_array) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   is_array_ = is_array;
+  auto version = next_version();
+  changed_ = version;
+  version_ = version;
+  touch_ancestors(version);
   return true;
 }
 
+std::uint64_t InfoTree::next_version() {
+  static std::atomic<std::uint64_t> clock{0};
+  return ++clock;
+}
+
+void InfoTree::touch(infotree::PathCursor path, std::uint64_t version) {
+  InfoTree* tree = this;
+  while (true) {
+    tree->version_ = version;
+    if (!path.next()) return;
+    auto index = tree->get_child_index(path.key(), path.hash());
+    if (!index.first) return;
+    tree = tree->children_[index.second].second.get();
+  }
+}
+
+void InfoTree::touch_ancestors(std::uint64_t version) const {
+  InfoTree::ptr parent;
+  for (auto node = this;; node = parent.get()) {
+    {
+      std::lock_guard<std::mutex> lock(parents_mutex());
+      parent = node->parent_.lock();
+    }
+    if (!parent) return;
+    // a concurrent modification may have stamped a later version already
+    auto current = parent->version_.load();
+    while (current < version && !parent->version_.compare_exchange_weak(current, version)) {
+    }
+  }
+}
+
+void InfoTree::adopt(InfoTree* child) const {
+  std::lock_guard<std::mutex> lock(parents_mutex());
+  child->parent_ = me_;
+}
+
+void InfoTree::disown(InfoTree* child) const {
+  std::lock_guard<std::mutex> lock(parents_mutex());
+  // the child may have been grafted to another tree meanwhile
+  if (child && this == child->parent_.lock().get()) child->parent_.reset();
+}
+
+std::mutex& InfoTree::parents_mutex() {
+  // parent links are updated briefly and rarely contended, a single mutex keeps nodes small
+  static std::mutex mtx;
+  return mtx;
+}
+
+void InfoTree::add_pruned(const std::string& key, std::uint64_t version) {
+  if (!pruned_) pruned_ = std::make_unique<Pruned>();
+  remove_pruned(key);
+  auto& keys = pruned_->keys;
+  keys.emplace_back(key, version);
+  if (keys.size() <= kMaxPrunedKeys) return;
+  // the oldest key is forgotten, changes older than its pruning will graft the whole node
+  pruned_->forgotten = keys.front().second;
+  keys.erase(keys.begin());
+}
+
+void InfoTree::remove_pruned(std::string_view key) {
+  if (!pruned_) return;
+  auto& keys = pruned_->keys;
+  auto found = std::find_if(
+      keys.begin(), keys.end(), [&](const std::pair<std::string, std::uint64_t>& pruned) {
+        return pruned.first == key;
+      });
+  if (keys.end() != found) keys.erase(found);
+}
+
+std::uint64_t InfoTree::get_version() const { return version_.load(); }
+
+std::vector<InfoTree::Change> InfoTree::get_changes_since(std::uint64_t version,
+                                                          std::uint64_t* current) const {
+  std::vector<Change> res;
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (current) *current = version_.load();
+  if (changed_ > version)
+    res.push_back(Change{Change::Op::graft, ".", me_.lock()});
+  else if (version_ > version)
+    collect_changes(std::string(), version, &res);
+  return res;
+}
+
+void InfoTree::collect_changes(const std::string& path,
+                               std::uint64_t since,
+                               std::vector<Change>* changes) const {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (pruned_) {
+    if (pruned_->forgotten > since) {
+      changes->push_back(Change{Change::Op::graft, path.empty() ? "." : path, me_.lock()});
+      return;
+    }
+    for (auto& it : pruned_->keys) {
+      if (it.second > since)
+        changes->push_back(Change{Change::Op::prune, path + "." + it.first, nullptr});
+    }
+  }
+  for (auto& it : children_) {
+    if (!it.second) continue;
+    if (it.second->changed_ > since)
+      changes->push_back(Change{Change::Op::graft, path + "." + it.first, it.second});
+    else if (it.second->version_ > since)
+      it.second->collect_changes(path + "." + it.first, since, changes);
+  }
+}
+
+InfoTree::cptr InfoTree::snapshot() const {
+  auto current = std::atomic_load(&snapshot_);
+  if (current && current->version == version_.load()) return current->tree;
+  // modifications are made with the mutex locked, so the copy is consistent with the version
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  current = std::atomic_load(&snapshot_);
+  auto version = version_.load();
+  if (current && current->version == version) return current->tree;
+  // snapshot nodes keep the versions of the nodes they copy, telling the unmodified ones
+  auto tree = current ? clone_shared(this, std::const_pointer_cast<InfoTree>(current->tree))
+                      : clone(this, 0);
+  auto updated = std::make_shared<const Snapshot>(Snapshot{version, tree});
+  std::atomic_store(&snapshot_, updated);
+  return updated->tree;
+}
+
 std::string InfoTree::escape_dots(const std::string& str) {
   return stringutils::replace_char(str, '.', "__DOT__");
 }
@@ -348,9 +612,10 @@ std::vector<std::string> InfoTree::get_child_keys(const std::string& path) const
   // else looking into childrens
   auto found = get_node(path);
   if (nullptr != found.first) {
-    res.resize((*found.first)[found.second].second->children_.size());
-    std::transform((*found.first)[found.second].second->children_.cbegin(),
-                   (*found.first)[found.second].second->children_.cend(),
+    auto& children = found.first->children_[found.second].second->children_;
+    res.resize(children.size());
+    std::transform(children.cbegin(),
+                   children.cend(),
                    res.begin(),
                    [](const child_type& child) { return child.first; });
   }
@@ -367,7 +632,7 @@ std::list<std::string> InfoTree::copy_leaf_values(const std::string& path) const
     else {
       auto found = get_node(path);
       if (nullptr == found.first) return res;
-      tree = (*found.first)[found.second].second;
+      tree = found.first->children_[found.second].second;
     }
   }
   preorder_tree_walk(tree.get(),
@@ -383,7 +648,7 @@ InfoTree::ptrc InfoTree::get_subtree(InfoTree::ptrc tree, const std::string& pat
   std::lock_guard<std::recursive_mutex> lock(tree->mutex_);
   auto found = tree->get_node(path);
   if (nullptr == found.first) return nullptr;
-  return (*found.first)[found.second].second.get();
+  return found.first->children_[found.second].second.get();
 }
 
 std::string InfoTree::serialize_json(const std::string& path) const {
@@ -391,7 +656,7 @@ std::string InfoTree::serialize_json(const std::string& path) const {
   if (path_is_root(path)) return infotree::json::serialize(me_.lock().get(), true);
   auto found = get_node(path);
   if (nullptr == found.first) return "null";
-  auto tree = (*found.first)[found.second].second;
+  auto tree = found.first->children_[found.second].second;
   if (!tree) return "null";
   return infotree::json::serialize(tree.get(), true);
 }
@@ -407,7 +672,7 @@ bool InfoTree::for_each_in_array(const std::string& path, std::function<void(Inf
   } else {
     auto found = get_node(path);
     if (!found.first) return false;
-    auto& tree = (*found.first)[found.second].second;
+    auto& tree = found.first->children_[found.second].second;
     if (!tree->is_array_) return false;
     children = tree->children_;
   }
@@ -429,7 +694,7 @@ bool InfoTree::cfor_each_in_array(const std::string& path,
   } else {
     auto found = get_node(path);
     if (!found.first) return false;
-    auto& tree = (*found.first)[found.second].second;
+    auto& tree = found.first->children_[found.second].second;
     if (!tree->is_array_) return false;
     children = tree->children_;
   }
@@ -441,5 +706,11 @@ bool InfoTree::cfor_each_in_array(const std::string& path,
   return true;
 }
 
+std::string InfoTree::serialize_json_changes(std::uint64_t since) const {
+  std::uint64_t version = 0;
+  auto changes = get_changes_since(since, &version);
+  return infotree::json::serialize_changes(version, changes, true);
+}
+
 std::string InfoTree::json() const { return serialize_json("."); }
 }  // namespace switcher
@@ -37,6 +37,8 @@
 #define __SWITCHER_INFORMATION_TREE_H__
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <list>
@@ -44,21 +46,45 @@
 #include <mutex>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include "../utils/any.hpp"
+#include "./path.hpp"
 
 namespace switcher {
+namespace infotree {
+namespace json {
+class Writer;
+}  // namespace json
+namespace msgpack {
+class Codec;
+}  // namespace msgpack
+template <typename T>
+class NodeAllocator;
+}  // namespace infotree
 
 class InfoTree {
+  // the JSON writer reads the nodes without walk callbacks
+  friend class infotree::json::Writer;
+  // the MessagePack codec reads and builds the nodes directly
+  friend class infotree::msgpack::Codec;
+  // nodes are constructed by the allocator given to std::allocate_shared
+  template <typename T>
+  friend class infotree::NodeAllocator;
+
  public:
   using ptr = std::shared_ptr<InfoTree>;  // shared
   using ptrc = const InfoTree*;           // const
+  using cptr = std::shared_ptr<const InfoTree>;  // shared const
   using rptr = InfoTree*;                 // raw
   using child_type = std::pair<std::string, InfoTree::ptr>;
   using children_t = std::vector<child_type>;
   using OnNodeFunction =
       std::function<bool(const std::string& name, InfoTree::ptrc tree, bool is_array_element)>;
-  using GetNodeReturn = std::pair<InfoTree::children_t*, InfoTree::children_t::size_type>;
+  // parent node and index of the child in the parent children
+  using GetNodeReturn = std::pair<InfoTree::rptr, InfoTree::children_t::size_type>;
+  // number of children above which a node indexes its children by key hash
+  static const children_t::size_type kChildIndexThreshold;
 
   // factory
   static InfoTree::ptr make();
@@ -68,10 +94,7 @@ class InfoTree {
 
   template <typename ValueType>
   static InfoTree::ptr make(ValueType data) {
-    std::shared_ptr<InfoTree> tree;  // can't use make_shared because ctor is private
-    tree.reset(new InfoTree(std::forward<ValueType>(data)));
-    tree->me_ = tree;
-    return tree;
+    return make_node(Any(std::forward<ValueType>(data)));
   }
   // InfoTree will store a std::string
   static InfoTree::ptr make(const char* data);
@@ -103,17 +126,41 @@ class InfoTree {
   bool branch_is_array(const std::string& path) const;
   bool branch_is_leaf(const std::string& path) const;
   bool branch_has_data(const std::string& path) const;
+  bool branch_has_data(const infotree::Path& path) const;
   template <typename T>
   T branch_read_data(const std::string& path) const {
-    std::unique_lock<std::recursive_mutex> lock(mutex_);
-    auto found = get_node(path);
-    if (nullptr != found.first) return (*found.first)[found.second].second->data_.copy_as<T>();
-    return T();
+    return read_data_at<T>(path);
+  }
+  template <typename T>
+  T branch_read_data(const infotree::Path& path) const {
+    return read_data_at<T>(path);
   }
 
+  // snapshot: immutable copy of the tree that readers can hold without locking the tree.
+  // The copy is made only once per modification and is shared among readers. Branches not
+  // modified since the previous snapshot are not copied but shared with it. Modifications made
+  // through a subtree obtained with get_tree are tracked as well, since they are stamped on the
+  // ancestors of the subtree.
+  InfoTree::cptr snapshot() const;
+
+  // versioning: each modification made through a node gets a version number, increasing across
+  // all the trees, and stamped on the node and its ancestors. Changes made since a version can
+  // be extracted as a list of grafts and prunes to apply in order.
+  struct Change {
+    enum class Op { graft, prune };
+    Op op;
+    std::string path;
+    InfoTree::ptr tree;  //!< Grafted tree, null with prune.
+  };
+  std::uint64_t get_version() const;
+  // current is set with the version the returned changes lead to
+  std::vector<Change> get_changes_since(std::uint64_t version, std::uint64_t* current) const;
+
   // serialize
   std::string serialize_json(const std::string& path = std::string(".")) const;
   std::string json() const;
+  // changes since a version, as a JSON object with "version" and "changes" members
+  std::string serialize_json_changes(std::uint64_t since) const;
 
   // get child keys - returning a newly allocated list
   std::vector<std::string> get_child_keys(const std::string& path) const;
@@ -124,8 +171,9 @@ class InfoTree {
     std::unique_lock<std::recursive_mutex> lock(mutex_);
     auto found = get_node(path);
     if (nullptr != found.first) {
-      std::transform((*found.first)[found.second].second->children_.begin(),
-                     (*found.first)[found.second].second->children_.end(),
+      auto& children = found.first->children_[found.second].second->children_;
+      std::transform(children.begin(),
+                     children.end(),
                      pos,
                      [](const child_type& child) { return child.first; });
       return true;
@@ -142,6 +190,7 @@ class InfoTree {
   void set_value(const char* data);
   void set_value(std::nullptr_t ptr);
   Any branch_get_value(const std::string& path) const;
+  Any branch_get_value(const infotree::Path& path) const;
   template <typename T>
   bool branch_set_value(const std::string& path, T data) {
     return branch_set_value(path, Any(data));
@@ -149,6 +198,7 @@ class InfoTree {
   bool branch_set_value(const std::string& path, const Any& data);
   bool branch_set_value(const std::string& path, const char* data);
   bool branch_set_value(const std::string& path, std::nullptr_t ptr);
+  bool branch_set_value(const infotree::Path& path, const Any& data);
   bool for_each_in_array(const std::string& path, std::function<void(InfoTree*)> fun);
   bool cfor_each_in_array(const std::string& path, std::function<void(const InfoTree*)> fun) const;
 
@@ -159,6 +209,7 @@ class InfoTree {
   // graft will create the path and graft the tree,
   // or remove old one and replace will the new tree
   bool graft(const std::string& path, InfoTree::ptr);
+  bool graft(const infotree::Path& path, InfoTree::ptr);
   // graft by value
   template <typename T>
   bool vgraft(const std::string& path, T val) {
@@ -166,8 +217,10 @@ class InfoTree {
   }
   // return empty tree if nothing can be pruned
   InfoTree::ptr prune(const std::string& path);
+  InfoTree::ptr prune(const infotree::Path& path);
   // get but not remove
   InfoTree::ptr get_tree(const std::string& path);
+  InfoTree::ptr get_tree(const infotree::Path& path);
   // return false if the path does not exist
   // when a path is tagged as an array, keys might be discarded
   // by some serializers, such as JSON
@@ -180,20 +233,77 @@ class InfoTree {
   mutable children_t children_{};
   mutable std::recursive_mutex mutex_{};
   std::weak_ptr<InfoTree> me_{};
+  // tree the node was last grafted to, accessed with the parents mutex locked
+  std::weak_ptr<InfoTree> parent_{};
+  // key hashes are already computed by the path, so the index does not hash them again
+  struct KeyHash {
+    std::size_t operator()(infotree::Path::hash_t hash) const { return hash; }
+  };
+  using child_index_t =
+      std::unordered_multimap<infotree::Path::hash_t, children_t::size_type, KeyHash>;
+  // built when the number of children reaches kChildIndexThreshold
+  std::unique_ptr<child_index_t> child_index_{};
+  // version of the last modification made through this node
+  std::atomic<std::uint64_t> version_{0};
+  // version of the last modification of the node itself: grafting, value or array tag
+  std::atomic<std::uint64_t> changed_{0};
+  // keys of the pruned children, kept for change extraction
+  struct Pruned {
+    std::vector<std::pair<std::string, std::uint64_t>> keys{};  //!< Keys with prune versions.
+    std::uint64_t forgotten{0};  //!< Latest version of the keys dropped from the list.
+  };
+  static const size_t kMaxPrunedKeys;
+  std::unique_ptr<Pruned> pruned_{};
+  struct Snapshot {
+    std::uint64_t version;
+    InfoTree::cptr tree;
+  };
+  // published and accessed with atomic_load/atomic_store
+  mutable std::shared_ptr<const Snapshot> snapshot_{};
 
   InfoTree() {}
-  template <typename U>
-  InfoTree(const U& data) : data_(Any(data)) {}
-  template <typename U>
-  InfoTree(U&& data) : data_(Any(std::forward<U>(data))) {}
   explicit InfoTree(const Any& data);
   explicit InfoTree(Any&& data);
-  std::pair<bool, children_t::size_type> get_child_index(const std::string& key) const;
-  static bool graft_next(std::istringstream& path, InfoTree* tree, InfoTree::ptr leaf);
-  GetNodeReturn get_node(const std::string& path) const;
-  GetNodeReturn get_next(std::istringstream& path,
-                         children_t* parent_vector_result,
-                         children_t::size_type result_index) const;
+  static InfoTree::ptr make_node(Any&& data);
+  // deep copy, with the nodes stamped with version, or keeping their versions if 0
+  static InfoTree::ptr clone(InfoTree::ptrc tree, std::uint64_t version);
+  // copy keeping the versions, sharing the nodes of previous, an older copy of the tree, that
+  // still have the same versions
+  static InfoTree::ptr clone_shared(InfoTree::ptrc tree, const InfoTree::ptr& previous);
+  std::pair<bool, children_t::size_type> get_child_index(std::string_view key,
+                                                          infotree::Path::hash_t hash) const;
+  void add_child(std::string_view key, infotree::Path::hash_t hash, InfoTree::ptr child);
+  void index_children();
+  void remove_child(children_t::size_type index);
+  GetNodeReturn get_node(infotree::PathCursor path) const;
+  static std::uint64_t next_version();
+  // set the version of the nodes along the path, stopping at the first missing key
+  void touch(infotree::PathCursor path, std::uint64_t version);
+  // raise the version of the ancestors of the node, for modifications made through a subtree
+  void touch_ancestors(std::uint64_t version) const;
+  // set or clear the parent of a child of this node
+  void adopt(InfoTree* child) const;
+  void disown(InfoTree* child) const;
+  static std::mutex& parents_mutex();
+  void add_pruned(const std::string& key, std::uint64_t version);
+  void remove_pruned(std::string_view key);
+  void collect_changes(const std::string& path,
+                       std::uint64_t since,
+                       std::vector<Change>* changes) const;
+  bool branch_has_data_at(infotree::PathCursor path) const;
+  Any branch_get_value_at(infotree::PathCursor path) const;
+  bool branch_set_value_at(infotree::PathCursor path, const Any& data);
+  bool graft_at(infotree::PathCursor path, InfoTree::ptr tree);
+  InfoTree::ptr prune_at(infotree::PathCursor path);
+  InfoTree::ptr get_tree_at(infotree::PathCursor path);
+  template <typename T>
+  T read_data_at(infotree::PathCursor path) const {
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    auto found = get_node(path);
+    if (nullptr != found.first)
+      return found.first->children_[found.second].second->data_.copy_as<T>();
+    return T();
+  }
   static bool path_is_root(const std::string& path);
 };
 
@@ -18,154 +18,23 @@
 #include "./json-serializer.hpp"
 #include <json-glib/json-glib.h>
 #include "../utils/scope-exit.hpp"
+#include "./json-writer.hpp"
 
 namespace switcher {
 namespace infotree {
 namespace json {
 
-void write_typed_member(JsonBuilder* builder, const Any& value) {
-  switch (value.get_category()) {
-    case AnyCategory::BOOLEAN:
-      json_builder_add_boolean_value(builder, value.copy_as<bool>());
-      break;
-    case AnyCategory::INTEGRAL:
-      json_builder_add_int_value(builder, value.copy_as<gint64>());
-      break;
-    case AnyCategory::FLOATING_POINT:
-      json_builder_add_double_value(builder, value.copy_as<gdouble>());
-      break;
-    case AnyCategory::OTHER:
-      json_builder_add_string_value(builder, Any::to_string(value).c_str());
-      break;
-    case AnyCategory::NONE:
-      json_builder_add_null_value(builder);
-      break;
-  }
-}
-
-void on_visiting_node(std::string key,
-                      InfoTree::ptrc node,
-                      bool is_array_element,
-                      bool repeat_array_indexes,
-                      JsonBuilder* builder) {
-  key = InfoTree::unescape_dots(key);
-  if (!is_array_element)  // discarding here to get it as a member called "name"
-    json_builder_set_member_name(builder, key.c_str());
-
-  if (!node) {
-    json_builder_add_null_value(builder);
-    return;
-  }
-
-  if (node->is_leaf()) {
-    if (!node->read_data().is_null()) {
-      write_typed_member(builder, node->read_data());
-    } else {
-      if (node->is_array()) {
-        json_builder_begin_array(builder);
-      } else {
-        json_builder_add_null_value(builder);
-      }
-    }
-    return;
-  } else {  // adding node value with the key "key_value" along with other
-            // childrens
-    if (node->is_array()) {
-      json_builder_begin_array(builder);
-      // json_builder_begin_object (builder);
-    } else {
-      json_builder_begin_object(builder);
-      if (is_array_element) {
-        if (repeat_array_indexes) {
-          json_builder_set_member_name(builder, "id");
-          json_builder_add_string_value(builder, key.c_str());
-        }
-      }
-      const Any& value = node->read_data();
-      if (value.not_null()) {
-        json_builder_set_member_name(builder, "key_value");
-        write_typed_member(builder, value);
-      }
-    }
-  }
-}
-
-void on_node_visited(std::string,
-                     InfoTree::ptrc node,
-                     bool /*is_array_element*/,
-                     JsonBuilder* builder) {
-  if (!node) return;
-  if (node->is_array()) {
-    // json_builder_end_object (builder);
-    json_builder_end_array(builder);
-    return;
-  }
-  if (!node->is_leaf()) json_builder_end_object(builder);
-}
-
 std::string serialize(InfoTree::ptrc tree, bool repeat_array_indexes) {
-  JsonBuilder* json_builder = json_builder_new();
-  On_scope_exit { g_object_unref(json_builder); };
-  if (tree->is_leaf()) {
-    if (!tree->read_data().is_null()) {
-      switch (tree->read_data().get_category()) {
-        case AnyCategory::BOOLEAN:
-          return std::string(tree->read_data().copy_as<bool>() ? "true" : "false");
-          break;
-        case AnyCategory::INTEGRAL:
-          return std::string(Any::to_string(tree->read_data()));
-          break;
-        case AnyCategory::FLOATING_POINT:
-          return std::string(Any::to_string(tree->read_data()));
-          break;
-        case AnyCategory::OTHER:
-          // We tried to get known types but sometimes values are of type OTHER
-          // because they were created as strings
-          return std::string("\"" + Any::to_string(tree->read_data()) + "\"");
-          break;
-        case AnyCategory::NONE:
-          return std::string("null");
-          break;
-      }
-    } else if (tree->is_array()) {
-      return std::string("[]");
-    } else {
-      return std::string("null");
-    }
-  }
-  bool is_array = tree->is_array();
-  if (!is_array)
-    json_builder_begin_object(json_builder);
-  else
-    json_builder_begin_array(json_builder);
-  InfoTree::preorder_tree_walk(
-      tree,
-      [&json_builder, repeat_array_indexes](
-          std::string key, InfoTree::ptrc node, bool is_array_element) {
-        infotree::json::on_visiting_node(
-            key, node, is_array_element, repeat_array_indexes, json_builder);
-        return true;
-      },
-      [&json_builder](std::string key, InfoTree::ptrc node, bool is_array_element) {
-        infotree::json::on_node_visited(key, node, is_array_element, json_builder);
-        return true;
-      });
+  std::string result;
+  Writer(repeat_array_indexes).append(tree, &result);
+  return result;
+}
 
-  if (!is_array)
-    json_builder_end_object(json_builder);
-  else
-    json_builder_end_array(json_builder);
-  JsonNode* node = json_builder_get_root(json_builder);
-  On_scope_exit { json_node_free(node); };
-  if (nullptr == node) return std::string();
-  JsonGenerator* generator = json_generator_new();
-  On_scope_exit { g_object_unref(generator); };
-  json_generator_set_pretty(generator, TRUE);
-  json_generator_set_root(generator, node);
-  gsize length = 0;
-  gchar* data = json_generator_to_data(generator, &length);
-  On_scope_exit { g_free(data); };
-  std::string result(data);
+std::string serialize_changes(std::uint64_t version,
+                              const std::vector<InfoTree::Change>& changes,
+                              bool repeat_array_indexes) {
+  std::string result;
+  Writer(repeat_array_indexes).append_changes(version, changes, &result);
   return result;
 }
 
@@ -28,7 +28,9 @@
 #ifndef __SWITCHER_INFORMATION_TREE_JSON_H__
 #define __SWITCHER_INFORMATION_TREE_JSON_H__
 
+#include <cstdint>
 #include <string>
+#include <vector>
 #include "./information-tree.hpp"
 
 namespace switcher {
@@ -45,9 +47,26 @@ namespace json {
  * the array objects under the key "id".
  *
  * \return Serialized string
+ *
+ * A json::Writer can be used instead in order to reuse its output buffer.
  */
 std::string serialize(InfoTree::ptrc tree, bool repeat_array_indexes = false);
 
+/**
+ * Serialize InfoTree changes into a JSON string.
+ *
+ * \param version The version the changes lead to
+ * \param changes Changes obtained with InfoTree::get_changes_since
+ *
+ * \param repeat_array_indexes When a branch is marked as an array, repeat keys in
+ * the array objects under the key "id".
+ *
+ * \return Serialized string, see Writer::append_changes for the format
+ */
+std::string serialize_changes(std::uint64_t version,
+                              const std::vector<InfoTree::Change>& changes,
+                              bool repeat_array_indexes = false);
+
 /**
  * Parse a JSON string and create an Infotree.
  *
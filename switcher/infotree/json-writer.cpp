@@ -0,0 +1,323 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include "./json-writer.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+
+namespace switcher {
+namespace infotree {
+namespace json {
+
+namespace {
+// json-glib pretty generator indentation
+const size_t kIndent = 2;
+// below this, integral doubles are printed without exponent by %.17g
+const double kMaxExactInteger = 1e15;
+
+void write_indent(size_t level, std::string* out) { out->append(level * kIndent, ' '); }
+
+// members are separated with a comma and a new line
+void write_separator(bool* first, std::string* out) {
+  if (*first)
+    *first = false;
+  else
+    out->append(",\n");
+}
+
+template <typename T>
+void write_integer(T val, std::string* out) {
+  char buf[24];
+  auto res = std::to_chars(buf, buf + sizeof(buf), val);
+  out->append(buf, res.ptr);
+}
+
+// keys with dots are stored escaped
+void unescape_key(const std::string& key, const std::string** name, std::string* unescaped) {
+  if (std::string::npos == key.find("__DOT__")) {
+    *name = &key;
+    return;
+  }
+  *unescaped = InfoTree::unescape_dots(key);
+  *name = unescaped;
+}
+}  // namespace
+
+Writer::Writer(bool repeat_array_indexes) : repeat_array_indexes_(repeat_array_indexes) {}
+
+const std::string& Writer::write(InfoTree::ptrc tree) {
+  buffer_.clear();
+  append(tree, &buffer_);
+  return buffer_;
+}
+
+void Writer::append(InfoTree::ptrc tree, std::string* out) const {
+  std::lock_guard<std::recursive_mutex> lock(tree->mutex_);
+  if (tree->children_.empty()) {
+    // a root leaf is not formatted as a json value
+    const Any& value = tree->data_;
+    if (value.is_null()) {
+      out->append(tree->is_array_ ? "[]" : "null");
+      return;
+    }
+    switch (value.get_category()) {
+      case AnyCategory::BOOLEAN:
+        out->append(value.copy_as<bool>() ? "true" : "false");
+        return;
+      case AnyCategory::INTEGRAL:
+      case AnyCategory::FLOATING_POINT:
+        out->append(Any::to_string(value));
+        return;
+      case AnyCategory::OTHER:
+        // We tried to get known types but sometimes values are of type OTHER
+        // because they were created as strings
+        out->push_back('"');
+        out->append(Any::to_string(value));
+        out->push_back('"');
+        return;
+      case AnyCategory::NONE:
+        out->append("null");
+        return;
+    }
+    return;
+  }
+  // the root has no "id" nor "key_value" members
+  out->append(tree->is_array_ ? "[\n" : "{\n");
+  write_children(tree, 1, out);
+  out->append(tree->is_array_ ? "]" : "}");
+}
+
+void Writer::append_changes(std::uint64_t version,
+                            const std::vector<InfoTree::Change>& changes,
+                            std::string* out) const {
+  out->append("{\n");
+  write_member_name("version", 1, out);
+  write_integer(version, out);
+  out->append(",\n");
+  write_member_name("changes", 1, out);
+  out->append("[\n");
+  bool first = true;
+  for (auto& it : changes) {
+    write_separator(&first, out);
+    write_indent(2, out);
+    out->append("{\n");
+    write_member_name("op", 3, out);
+    write_string(InfoTree::Change::Op::graft == it.op ? "graft" : "prune", out);
+    out->append(",\n");
+    write_member_name("path", 3, out);
+    write_string(it.path, out);
+    if (InfoTree::Change::Op::graft == it.op) {
+      out->append(",\n");
+      static const std::string value_key("value");
+      write_node(it.tree.get(), &value_key, false, 3, out);
+    }
+    out->push_back('\n');
+    write_indent(2, out);
+    out->push_back('}');
+  }
+  if (!first) out->push_back('\n');
+  write_indent(1, out);
+  out->append("]\n}");
+}
+
+void Writer::write_node(InfoTree::ptrc node,
+                        const std::string* key,
+                        bool is_array_element,
+                        size_t level,
+                        std::string* out) const {
+  std::string unescaped;
+  const std::string* name = nullptr;
+  if (key) unescape_key(*key, &name, &unescaped);
+  if (is_array_element)  // array elements have no name
+    write_indent(level, out);
+  else
+    write_member_name(*name, level, out);
+
+  if (!node) {
+    out->append("null");
+    return;
+  }
+  std::lock_guard<std::recursive_mutex> lock(node->mutex_);
+  if (node->children_.empty()) {
+    if (node->data_.not_null()) {
+      write_value(node->data_, out);
+    } else if (node->is_array_) {
+      out->append("[\n");
+      write_indent(level, out);
+      out->push_back(']');
+    } else {
+      out->append("null");
+    }
+    return;
+  }
+  if (node->is_array_) {
+    out->append("[\n");
+    write_children(node, level + 1, out);
+    write_indent(level, out);
+    out->push_back(']');
+    return;
+  }
+  // an object, with the node value under the key "key_value", along with the children
+  out->append("{\n");
+  bool first = true;
+  const InfoTree::child_type* id_child = nullptr;
+  const InfoTree::child_type* value_child = nullptr;
+  const bool with_id = is_array_element && repeat_array_indexes_;
+  const bool with_value = node->data_.not_null();
+  if (with_id || with_value) {
+    // a child with the same name replaces the value, but keeps the position of the member
+    for (auto& it : node->children_) {
+      if (with_id && it.first == "id") id_child = &it;
+      if (with_value && it.first == "key_value") value_child = &it;
+    }
+  }
+  if (with_id) {
+    write_separator(&first, out);
+    if (id_child) {
+      write_node(id_child->second.get(), &id_child->first, false, level + 1, out);
+    } else {
+      write_member_name("id", level + 1, out);
+      write_string(*name, out);
+    }
+  }
+  if (with_value) {
+    write_separator(&first, out);
+    if (value_child) {
+      write_node(value_child->second.get(), &value_child->first, false, level + 1, out);
+    } else {
+      write_member_name("key_value", level + 1, out);
+      write_value(node->data_, out);
+    }
+  }
+  for (auto& it : node->children_) {
+    if (&it == id_child || &it == value_child) continue;
+    write_separator(&first, out);
+    write_node(it.second.get(), &it.first, false, level + 1, out);
+  }
+  out->push_back('\n');
+  write_indent(level, out);
+  out->push_back('}');
+}
+
+void Writer::write_children(InfoTree::ptrc node, size_t level, std::string* out) const {
+  bool first = true;
+  for (auto& it : node->children_) {
+    write_separator(&first, out);
+    write_node(it.second.get(), &it.first, node->is_array_, level, out);
+  }
+  if (!first) out->push_back('\n');
+}
+
+void Writer::write_value(const Any& value, std::string* out) {
+  switch (value.get_category()) {
+    case AnyCategory::BOOLEAN:
+      out->append(value.copy_as<bool>() ? "true" : "false");
+      break;
+    case AnyCategory::INTEGRAL:
+      write_integer(value.copy_as<int64_t>(), out);
+      break;
+    case AnyCategory::FLOATING_POINT: {
+      auto val = value.copy_as<double>();
+      // integral values are formatted as integers by %.17g, except -0
+      if (std::trunc(val) == val && std::abs(val) < kMaxExactInteger &&
+          (val != 0 || !std::signbit(val))) {
+        write_integer(static_cast<int64_t>(val), out);
+        out->append(".0");
+        break;
+      }
+      // same as g_ascii_dtostr, that is locale independent
+      char buf[32];
+      int len = std::snprintf(buf, sizeof(buf), "%.17g", val);
+      bool has_point = false;
+      for (int i = 0; i < len; ++i) {
+        if (buf[i] == ',') buf[i] = '.';
+        if (buf[i] == '.') has_point = true;
+      }
+      out->append(buf, len);
+      // doubles do not become integers
+      if (!has_point) out->append(".0");
+      break;
+    }
+    case AnyCategory::OTHER:
+      // strings are not copied
+      if (value.is<std::string>())
+        write_string(value.as<std::string>(), out);
+      else
+        write_string(Any::to_string(value), out);
+      break;
+    case AnyCategory::NONE:
+      out->append("null");
+      break;
+  }
+}
+
+void Writer::write_string(std::string_view str, std::string* out) {
+  // strings are C strings for json-glib
+  auto end = str.find('\0');
+  if (std::string_view::npos != end) str = str.substr(0, end);
+  out->push_back('"');
+  // escaping as json-glib does
+  size_t run = 0;
+  for (size_t i = 0; i < str.size(); ++i) {
+    auto c = static_cast<unsigned char>(str[i]);
+    if (c != '\\' && c != '"' && (c == 0 || c >= 0x1f) && c != 0x7f) continue;
+    out->append(str.data() + run, i - run);
+    run = i + 1;
+    switch (c) {
+      case '\\':
+      case '"':
+        out->push_back('\\');
+        out->push_back(static_cast<char>(c));
+        break;
+      case '\b':
+        out->append("\\b");
+        break;
+      case '\f':
+        out->append("\\f");
+        break;
+      case '\n':
+        out->append("\\n");
+        break;
+      case '\r':
+        out->append("\\r");
+        break;
+      case '\t':
+        out->append("\\t");
+        break;
+      default: {
+        char buf[8];
+        std::snprintf(buf, sizeof(buf), "\\u00%.2x", c);
+        out->append(buf, 6);
+      }
+    }
+  }
+  out->append(str.data() + run, str.size() - run);
+  out->push_back('"');
+}
+
+void Writer::write_member_name(std::string_view name, size_t level, std::string* out) {
+  write_indent(level, out);
+  write_string(name, out);
+  out->append(" : ");
+}
+
+}  // namespace json
+}  // namespace infotree
+}  // namespace switcher
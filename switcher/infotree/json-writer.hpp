@@ -0,0 +1,102 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * @file   json-writer.h
+ *
+ * @brief streaming JSON serialization of an information tree
+ *
+ * The Writer formats the tree directly into a string, without building an
+ * intermediate JSON document. The output is the same as the json-glib pretty
+ * generator, so that it can be used as a drop-in replacement.
+ */
+
+#ifndef __SWITCHER_INFORMATION_TREE_JSON_WRITER_H__
+#define __SWITCHER_INFORMATION_TREE_JSON_WRITER_H__
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "./information-tree.hpp"
+
+namespace switcher {
+namespace infotree {
+namespace json {
+
+class Writer {
+ public:
+  /**
+   * Construct a Writer.
+   *
+   * \param repeat_array_indexes When a branch is marked as an array, repeat keys in
+   * the array objects under the key "id".
+   */
+  explicit Writer(bool repeat_array_indexes = false);
+
+  /**
+   * Serialize a tree, replacing the previous content of the output buffer. The buffer keeps
+   * its memory between calls, so that a long-lived Writer avoids allocations.
+   *
+   * \param tree Tree to serialize
+   *
+   * \return The serialized string, valid until the next call
+   */
+  const std::string& write(InfoTree::ptrc tree);
+
+  /**
+   * Append the serialization of a tree to a string.
+   *
+   * \param tree Tree to serialize
+   * \param out  String receiving the serialization
+   */
+  void append(InfoTree::ptrc tree, std::string* out) const;
+
+  /**
+   * Append the serialization of tree changes to a string. Changes are written as an object
+   * with the "version" reached and the "changes" array, each change having an "op" member
+   * ("graft" or "prune"), a "path" member and a "value" member for grafts.
+   *
+   * \param version The version the changes lead to
+   * \param changes Changes obtained with InfoTree::get_changes_since
+   * \param out     String receiving the serialization
+   */
+  void append_changes(std::uint64_t version,
+                      const std::vector<InfoTree::Change>& changes,
+                      std::string* out) const;
+
+ private:
+  bool repeat_array_indexes_;
+  std::string buffer_{};
+
+  void write_node(InfoTree::ptrc node,
+                  const std::string* key,
+                  bool is_array_element,
+                  size_t level,
+                  std::string* out) const;
+  void write_children(InfoTree::ptrc node, size_t level, std::string* out) const;
+  static void write_value(const Any& value, std::string* out);
+  static void write_string(std::string_view str, std::string* out);
+  static void write_member_name(std::string_view name, size_t level, std::string* out);
+};
+
+}  // namespace json
+}  // namespace infotree
+}  // namespace switcher
+#endif
@@ -0,0 +1,456 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include "./msgpack-serializer.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <unordered_set>
+
+namespace switcher {
+namespace infotree {
+namespace msgpack {
+
+namespace {
+// fixext 8 types of the arithmetic types without MessagePack format
+const std::int8_t kLongLongExt = 1;
+const std::int8_t kUnsignedLongLongExt = 2;
+const std::int8_t kLongDoubleExt = 3;
+// nodes are decoded recursively, deeper data is considered malformed
+const size_t kMaxDepth = 512;
+
+template <typename T>
+void write_big_endian(T val, std::string* out) {
+  char buf[sizeof(T)];
+  for (size_t i = 0; i < sizeof(T); ++i)
+    buf[sizeof(T) - 1 - i] = static_cast<char>((val >> (8 * i)) & 0xff);
+  out->append(buf, sizeof(T));
+}
+
+void write_tag(std::uint8_t tag, std::string* out) { out->push_back(static_cast<char>(tag)); }
+
+void write_string(std::string_view str, std::string* out) {
+  auto size = str.size();
+  if (size < 32) {
+    write_tag(0xa0 | size, out);
+  } else if (size <= 0xff) {
+    write_tag(0xd9, out);
+    write_tag(size, out);
+  } else if (size <= 0xffff) {
+    write_tag(0xda, out);
+    write_big_endian(static_cast<std::uint16_t>(size), out);
+  } else {
+    write_tag(0xdb, out);
+    write_big_endian(static_cast<std::uint32_t>(size), out);
+  }
+  out->append(str);
+}
+
+void write_map_header(size_t size, std::string* out) {
+  if (size < 16) {
+    write_tag(0x80 | size, out);
+  } else if (size <= 0xffff) {
+    write_tag(0xde, out);
+    write_big_endian(static_cast<std::uint16_t>(size), out);
+  } else {
+    write_tag(0xdf, out);
+    write_big_endian(static_cast<std::uint32_t>(size), out);
+  }
+}
+
+void write_ext(std::int8_t type, std::uint64_t val, std::string* out) {
+  write_tag(0xd7, out);
+  write_tag(type, out);
+  write_big_endian(val, out);
+}
+
+std::uint32_t float_bits(float val) {
+  std::uint32_t bits;
+  std::memcpy(&bits, &val, sizeof(bits));
+  return bits;
+}
+
+std::uint64_t double_bits(double val) {
+  std::uint64_t bits;
+  std::memcpy(&bits, &val, sizeof(bits));
+  return bits;
+}
+
+}  // namespace
+
+// reads and builds InfoTree nodes, InfoTree friend
+class Codec {
+ public:
+  explicit Codec(std::string_view in) : in_(in), version_(InfoTree::next_version()) {}
+
+  static void write_node(InfoTree::ptrc node, std::string* out) {
+    std::lock_guard<std::recursive_mutex> lock(node->mutex_);
+    if (node->children_.empty() && !node->is_array_) {
+      write_value(node->data_, out);
+      return;
+    }
+    write_tag(0x93, out);
+    write_value(node->data_, out);
+    write_tag(node->is_array_ ? 0xc3 : 0xc2, out);
+    size_t size = 0;
+    for (auto& it : node->children_)
+      if (it.second) ++size;
+    write_map_header(size, out);
+    for (auto& it : node->children_) {
+      if (!it.second) continue;
+      write_string(it.first, out);
+      write_node(it.second.get(), out);
+    }
+  }
+
+  InfoTree::ptr read() {
+    auto res = read_node(0);
+    if (res && pos_ != in_.size()) return fail("unexpected data after the tree");
+    return res;
+  }
+
+  const std::string& get_error() const { return error_; }
+
+ private:
+  std::string_view in_;
+  size_t pos_{0};
+  std::uint64_t version_;
+  std::string error_{};
+
+  static void write_value(const Any& value, std::string* out) {
+    switch (value.get_category()) {
+      case AnyCategory::NONE:
+        write_tag(0xc0, out);
+        return;
+      case AnyCategory::BOOLEAN:
+        write_tag(value.copy_as<bool>() ? 0xc3 : 0xc2, out);
+        return;
+      case AnyCategory::INTEGRAL:
+      case AnyCategory::FLOATING_POINT:
+        if (write_arithmetic(value, out)) return;
+        break;
+      case AnyCategory::OTHER:
+        if (value.is<std::string>()) {
+          write_string(value.as<std::string>(), out);
+          return;
+        }
+        break;
+    }
+    write_string(Any::to_string(value), out);
+  }
+
+  static bool write_arithmetic(const Any& value, std::string* out) {
+    switch (value.get_arithmetic_type()) {
+      case AnyArithmeticType::INT: {
+        auto val = value.copy_as<int>();
+        if (val >= -32 && val <= 127) {
+          write_tag(static_cast<std::uint8_t>(val), out);  // positive or negative fixint
+        } else {
+          write_tag(0xd2, out);
+          write_big_endian(static_cast<std::uint32_t>(val), out);
+        }
+        return true;
+      }
+      case AnyArithmeticType::SHORT:
+        write_tag(0xd1, out);
+        write_big_endian(static_cast<std::uint16_t>(value.copy_as<short>()), out);
+        return true;
+      case AnyArithmeticType::LONG:
+        write_tag(0xd3, out);
+        write_big_endian(static_cast<std::uint64_t>(value.copy_as<long>()), out);
+        return true;
+      case AnyArithmeticType::LONG_LONG:
+        write_ext(kLongLongExt, static_cast<std::uint64_t>(value.copy_as<long long>()), out);
+        return true;
+      case AnyArithmeticType::UNSIGNED_SHORT:
+        write_tag(0xcd, out);
+        write_big_endian(static_cast<std::uint16_t>(value.copy_as<unsigned short>()), out);
+        return true;
+      case AnyArithmeticType::UNSIGNED_INT:
+        write_tag(0xce, out);
+        write_big_endian(static_cast<std::uint32_t>(value.copy_as<unsigned int>()), out);
+        return true;
+      case AnyArithmeticType::UNSIGNED_LONG:
+        write_tag(0xcf, out);
+        write_big_endian(static_cast<std::uint64_t>(value.copy_as<unsigned long>()), out);
+        return true;
+      case AnyArithmeticType::UNSIGNED_LONG_LONG:
+        write_ext(kUnsignedLongLongExt,
+                  static_cast<std::uint64_t>(value.copy_as<unsigned long long>()),
+                  out);
+        return true;
+      case AnyArithmeticType::FLOAT:
+        write_tag(0xca, out);
+        write_big_endian(float_bits(value.copy_as<float>()), out);
+        return true;
+      case AnyArithmeticType::DOUBLE:
+        write_tag(0xcb, out);
+        write_big_endian(double_bits(value.copy_as<double>()), out);
+        return true;
+      case AnyArithmeticType::LONG_DOUBLE:
+        write_ext(kLongDoubleExt, double_bits(value.copy_as<double>()), out);
+        return true;
+      case AnyArithmeticType::NOT_DEFINED:
+        break;
+    }
+    return false;
+  }
+
+  InfoTree::ptr fail(const std::string& message) {
+    if (error_.empty()) error_ = message + " at offset " + std::to_string(pos_);
+    return nullptr;
+  }
+
+  bool read_bytes(size_t size, const char** data) {
+    if (in_.size() - pos_ < size) {
+      fail("unexpected end of data");
+      return false;
+    }
+    *data = in_.data() + pos_;
+    pos_ += size;
+    return true;
+  }
+
+  template <typename T>
+  bool read_big_endian(T* val) {
+    const char* data = nullptr;
+    if (!read_bytes(sizeof(T), &data)) return false;
+    *val = 0;
+    for (size_t i = 0; i < sizeof(T); ++i)
+      *val = static_cast<T>((*val << 8) | static_cast<std::uint8_t>(data[i]));
+    return true;
+  }
+
+  bool read_tag(std::uint8_t* tag) { return read_big_endian(tag); }
+
+  bool read_string(std::uint8_t tag, std::string_view* str) {
+    size_t size = 0;
+    if (tag >= 0xa0 && tag <= 0xbf) {
+      size = tag & 0x1f;
+    } else if (0xd9 == tag) {
+      std::uint8_t val;
+      if (!read_big_endian(&val)) return false;
+      size = val;
+    } else if (0xda == tag) {
+      std::uint16_t val;
+      if (!read_big_endian(&val)) return false;
+      size = val;
+    } else if (0xdb == tag) {
+      std::uint32_t val;
+      if (!read_big_endian(&val)) return false;
+      size = val;
+    } else {
+      fail("string expected");
+      return false;
+    }
+    const char* data = nullptr;
+    if (!read_bytes(size, &data)) return false;
+    *str = std::string_view(data, size);
+    return true;
+  }
+
+  bool read_map_header(size_t* size) {
+    std::uint8_t tag;
+    if (!read_tag(&tag)) return false;
+    if (tag >= 0x80 && tag <= 0x8f) {
+      *size = tag & 0x0f;
+    } else if (0xde == tag) {
+      std::uint16_t val;
+      if (!read_big_endian(&val)) return false;
+      *size = val;
+    } else if (0xdf == tag) {
+      std::uint32_t val;
+      if (!read_big_endian(&val)) return false;
+      *size = val;
+    } else {
+      fail("map expected");
+      return false;
+    }
+    // a member is at least two bytes long
+    if (*size > (in_.size() - pos_) / 2) {
+      fail("unexpected end of data");
+      return false;
+    }
+    return true;
+  }
+
+  template <typename Bits, typename T>
+  bool read_number(Any* value) {
+    Bits val;
+    if (!read_big_endian(&val)) return false;
+    *value = static_cast<T>(val);
+    return true;
+  }
+
+  template <typename Bits, typename T>
+  bool read_floating_point(Any* value) {
+    Bits bits;
+    if (!read_big_endian(&bits)) return false;
+    T val;
+    std::memcpy(&val, &bits, sizeof(val));
+    // Any gets the arithmetic type from rvalues only
+    *value = static_cast<T>(val);
+    return true;
+  }
+
+  bool read_ext(Any* value) {
+    std::uint8_t type;
+    std::uint64_t val;
+    if (!read_tag(&type) || !read_big_endian(&val)) return false;
+    switch (static_cast<std::int8_t>(type)) {
+      case kLongLongExt:
+        *value = static_cast<long long>(val);
+        return true;
+      case kUnsignedLongLongExt:
+        *value = static_cast<unsigned long long>(val);
+        return true;
+      case kLongDoubleExt: {
+        double dbl;
+        std::memcpy(&dbl, &val, sizeof(dbl));
+        *value = static_cast<long double>(dbl);
+        return true;
+      }
+    }
+    fail("unsupported extension type");
+    return false;
+  }
+
+  bool read_value(std::uint8_t tag, Any* value) {
+    if (tag <= 0x7f) {
+      *value = static_cast<int>(tag);
+      return true;
+    }
+    if (tag >= 0xe0) {
+      *value = static_cast<int>(static_cast<std::int8_t>(tag));
+      return true;
+    }
+    if ((tag >= 0xa0 && tag <= 0xbf) || (tag >= 0xd9 && tag <= 0xdb)) {
+      std::string_view str;
+      if (!read_string(tag, &str)) return false;
+      *value = std::string(str);
+      return true;
+    }
+    switch (tag) {
+      case 0xc0:
+        *value = nullptr;
+        return true;
+      case 0xc2:
+        *value = false;
+        return true;
+      case 0xc3:
+        *value = true;
+        return true;
+      case 0xca:
+        return read_floating_point<std::uint32_t, float>(value);
+      case 0xcb:
+        return read_floating_point<std::uint64_t, double>(value);
+      case 0xcc:
+        return read_number<std::uint8_t, int>(value);
+      case 0xcd:
+        return read_number<std::uint16_t, unsigned short>(value);
+      case 0xce:
+        return read_number<std::uint32_t, unsigned int>(value);
+      case 0xcf:
+        return read_number<std::uint64_t, unsigned long>(value);
+      case 0xd0: {
+        std::uint8_t val;
+        if (!read_big_endian(&val)) return false;
+        *value = static_cast<int>(static_cast<std::int8_t>(val));
+        return true;
+      }
+      case 0xd1:
+        return read_number<std::uint16_t, short>(value);
+      case 0xd2:
+        return read_number<std::uint32_t, int>(value);
+      case 0xd3:
+        return read_number<std::uint64_t, long>(value);
+      case 0xd7:
+        return read_ext(value);
+    }
+    fail("unsupported value type");
+    return false;
+  }
+
+  InfoTree::ptr read_node(size_t depth) {
+    if (depth > kMaxDepth) return fail("tree too deep");
+    std::uint8_t tag;
+    if (!read_tag(&tag)) return nullptr;
+    auto node = InfoTree::make();
+    node->changed_ = version_;
+    node->version_ = version_;
+    if (0x93 != tag) {
+      if (!read_value(tag, &node->data_)) return nullptr;
+      return node;
+    }
+    std::uint8_t is_array;
+    size_t size = 0;
+    if (!read_tag(&tag) || !read_value(tag, &node->data_) || !read_tag(&is_array)) return nullptr;
+    if (0xc2 != is_array && 0xc3 != is_array) return fail("array tag expected");
+    node->is_array_ = 0xc3 == is_array;
+    if (!read_map_header(&size)) return nullptr;
+    node->children_.reserve(size);
+    // keys of large maps are checked for duplicates with a set, small ones are scanned
+    std::unordered_set<std::string_view> keys;
+    const bool use_key_set = size >= InfoTree::kChildIndexThreshold;
+    for (size_t i = 0; i < size; ++i) {
+      std::string_view key;
+      if (!read_tag(&tag) || !read_string(tag, &key)) return nullptr;
+      const bool duplicate =
+          use_key_set ? !keys.insert(key).second
+                      : node->children_.end() !=
+                            std::find_if(node->children_.begin(),
+                                         node->children_.end(),
+                                         [&](const auto& child) { return child.first == key; });
+      if (duplicate) return fail("duplicate key");
+      auto child = read_node(depth + 1);
+      if (!child) return nullptr;
+      node->adopt(child.get());
+      node->children_.emplace_back(std::string(key), std::move(child));
+    }
+    if (node->children_.size() >= InfoTree::kChildIndexThreshold) node->index_children();
+    return node;
+  }
+};
+
+void append(InfoTree::ptrc tree, std::string* out) {
+  if (!tree) {
+    write_tag(0xc0, out);
+    return;
+  }
+  Codec::write_node(tree, out);
+}
+
+std::string serialize(InfoTree::ptrc tree) {
+  std::string result;
+  append(tree, &result);
+  return result;
+}
+
+InfoTree::ptr deserialize(std::string_view serialized, bool include_parsing_error) {
+  Codec codec(serialized);
+  auto res = codec.read();
+  if (res) return res;
+  res = InfoTree::make();
+  if (include_parsing_error) res->vgraft("parsing_error", codec.get_error());
+  return res;
+}
+
+}  // namespace msgpack
+}  // namespace infotree
+}  // namespace switcher
@@ -0,0 +1,85 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * @file   msgpack-serializer.hpp
+ *
+ * @brief serialize and deserialize an information tree using MessagePack
+ *
+ * The binary encoding is more compact than JSON and is decoded directly from
+ * the serialized buffer, without intermediate document. Unlike JSON, it keeps
+ * the arithmetic type of the values, the array tags and the keys of array
+ * elements, so that a decoded tree is identical to the serialized one.
+ *
+ * A node is encoded as its value when it has no children and is not tagged
+ * as an array. Otherwise it is encoded as an array of three elements: the
+ * value, the array tag and a map of the children.
+ *
+ * Values are nil, booleans and strings, or numbers in the MessagePack format
+ * of their type: int as fixint or int 32, short as int 16, long as int 64,
+ * unsigned short, unsigned int and unsigned long as uint 16, 32 and 64, float
+ * as float 32 and double as float 64. Long long, unsigned long long and long
+ * double use fixext 8 with type 1, 2 and 3, long double being stored as a
+ * double. Other values are encoded as their string representation.
+ */
+
+#ifndef __SWITCHER_INFORMATION_TREE_MSGPACK_H__
+#define __SWITCHER_INFORMATION_TREE_MSGPACK_H__
+
+#include <string>
+#include <string_view>
+#include "./information-tree.hpp"
+
+namespace switcher {
+namespace infotree {
+namespace msgpack {
+
+/**
+ * Serialize an InfoTree into MessagePack.
+ *
+ * \param tree Tree to serialize
+ *
+ * \return Serialized bytes
+ */
+std::string serialize(InfoTree::ptrc tree);
+
+/**
+ * Append the MessagePack serialization of an InfoTree to a string.
+ *
+ * \param tree Tree to serialize
+ * \param out  String receiving the serialization
+ */
+void append(InfoTree::ptrc tree, std::string* out);
+
+/**
+ * Decode MessagePack bytes and create an InfoTree.
+ *
+ * \param serialized Serialized bytes, not copied during decoding
+ * \param include_parsing_error If true, then decoding error message
+ * will be writen in the tree. The message will be located at
+ * the ".parsing_error" branch.
+ *
+ * \return Tree resulting from the deserialization, empty if the bytes are malformed
+ */
+InfoTree::ptr deserialize(std::string_view serialized, bool include_parsing_error = false);
+
+}  // namespace msgpack
+}  // namespace infotree
+}  // namespace switcher
+#endif
@@ -0,0 +1,129 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * @file  node-allocator.hpp
+ *
+ * @brief allocator recycling the memory of InfoTree nodes
+ *
+ * Used with std::allocate_shared, a node and its reference counts are
+ * allocated in a single block. Freed blocks are kept in a per thread pool,
+ * so that building trees that replace other ones, like periodic stat updates
+ * or tree copies, does not go through the system allocator.
+ *
+ */
+
+#ifndef __SWITCHER_INFOTREE_NODE_ALLOCATOR_H__
+#define __SWITCHER_INFOTREE_NODE_ALLOCATOR_H__
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace switcher {
+namespace infotree {
+
+template <typename T>
+class NodeAllocator {
+ public:
+  using value_type = T;
+  // number of free blocks a thread keeps for each block type
+  static constexpr std::size_t kMaxPooledBlocks = 1024;
+
+  NodeAllocator() = default;
+  template <typename U>
+  NodeAllocator(const NodeAllocator<U>&) {}
+
+  T* allocate(std::size_t n) {
+    static_assert(sizeof(T) >= sizeof(Block), "block too small for the free list");
+    auto& pool = get_pool();
+    if (1 == n && nullptr != pool.blocks) {
+      auto block = pool.blocks;
+      pool.blocks = block->next;
+      --pool.size;
+      return reinterpret_cast<T*>(block);
+    }
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T* ptr, std::size_t n) {
+    auto& pool = get_pool();
+    if (1 == n && pool.size < kMaxPooledBlocks) {
+      auto block = reinterpret_cast<Block*>(ptr);
+      block->next = pool.blocks;
+      pool.blocks = block;
+      ++pool.size;
+      return;
+    }
+    ::operator delete(ptr);
+  }
+
+  // nodes have private constructors, NodeAllocator is a friend of InfoTree
+  template <typename U, typename... Args>
+  void construct(U* ptr, Args&&... args) {
+    ::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+  }
+
+  template <typename U>
+  void destroy(U* ptr) {
+    ptr->~U();
+  }
+
+ private:
+  struct Block {
+    Block* next;
+  };
+  // trivially destructible, so that nodes freed during thread exit can still use it
+  struct Pool {
+    Block* blocks;
+    std::size_t size;
+  };
+  // releases the blocks when the thread exits, and disables the pool for later deallocations
+  struct Releaser {
+    Pool* pool;
+    ~Releaser() {
+      while (nullptr != pool->blocks) {
+        auto block = pool->blocks;
+        pool->blocks = block->next;
+        ::operator delete(block);
+      }
+      pool->size = kMaxPooledBlocks;
+    }
+  };
+
+  static Pool& get_pool() {
+    static thread_local Pool pool{nullptr, 0};
+    static thread_local Releaser releaser{&pool};
+    return *releaser.pool;
+  }
+};
+
+template <typename T, typename U>
+bool operator==(const NodeAllocator<T>&, const NodeAllocator<U>&) {
+  return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const NodeAllocator<T>&, const NodeAllocator<U>&) {
+  return false;
+}
+
+}  // namespace infotree
+}  // namespace switcher
+#endif
@@ -0,0 +1,61 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include "./path.hpp"
+
+namespace switcher {
+namespace infotree {
+
+Path::Path(const std::string& path) : path_(path), is_root_(path == "." || path == "..") {
+  PathCursor cursor(path);
+  while (cursor.next()) {
+    keys_.emplace_back(cursor.key());
+    hashes_.push_back(cursor.hash());
+  }
+}
+
+Path::Path(const char* path) : Path(std::string(path)) {}
+
+PathCursor::PathCursor(const std::string& path)
+    : remaining_(path), is_root_(path == "." || path == "..") {}
+
+PathCursor::PathCursor(const Path& path) : compiled_(&path), is_root_(path.is_root()) {}
+
+bool PathCursor::next() {
+  if (compiled_) {
+    if (index_ == compiled_->size()) return false;
+    key_ = compiled_->key(index_);
+    hash_ = compiled_->hash(index_);
+    ++index_;
+    return true;
+  }
+  while (!remaining_.empty()) {
+    auto dot = remaining_.find('.');
+    key_ = remaining_.substr(0, dot);
+    remaining_ = std::string_view::npos == dot ? std::string_view() : remaining_.substr(dot + 1);
+    // in case of two or more consecutive dots
+    if (key_.empty()) continue;
+    hash_ = Path::hash_key(key_);
+    return true;
+  }
+  return false;
+}
+
+}  // namespace infotree
+}  // namespace switcher
@@ -0,0 +1,103 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * @file  path.hpp
+ *
+ * @brief pre-tokenized path for accessing InfoTree nodes
+ *
+ * An InfoTree path is a concatenation of keys separated by dots. A Path
+ * splits the keys and computes their hashes once, so that it can be reused
+ * for several lookups in an InfoTree without parsing again.
+ *
+ */
+
+#ifndef __SWITCHER_INFOTREE_PATH_H__
+#define __SWITCHER_INFOTREE_PATH_H__
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace switcher {
+namespace infotree {
+
+class Path {
+ public:
+  using hash_t = std::size_t;
+
+  /**
+   * Construct a Path from its dotted string representation. Empty keys
+   * (consecutive dots) are ignored.
+   *
+   * \param path The dotted path, for instance ".shmdata.writer"
+   */
+  explicit Path(const std::string& path);
+  explicit Path(const char* path);
+
+  /**
+   * Test if the path designates the tree root, i.e. "." or "..".
+   */
+  bool is_root() const { return is_root_; }
+  std::size_t size() const { return keys_.size(); }
+  const std::string& key(std::size_t i) const { return keys_[i]; }
+  hash_t hash(std::size_t i) const { return hashes_[i]; }
+  const std::string& str() const { return path_; }
+
+  /**
+   * Hash function used for keys, shared by Path and InfoTree child indexes.
+   */
+  static hash_t hash_key(std::string_view key) { return std::hash<std::string_view>()(key); }
+
+ private:
+  std::string path_;
+  std::vector<std::string> keys_{};
+  std::vector<hash_t> hashes_{};
+  bool is_root_{false};
+};
+
+/**
+ * Iterates over keys of either a Path or a dotted string, without
+ * allocation. Keys and hashes are valid until the next call to next.
+ */
+class PathCursor {
+ public:
+  PathCursor(const std::string& path);
+  PathCursor(const Path& path);
+
+  bool is_root() const { return is_root_; }
+  // move to the next key, return false when no more keys are available
+  bool next();
+  std::string_view key() const { return key_; }
+  Path::hash_t hash() const { return hash_; }
+
+ private:
+  const Path* compiled_{nullptr};
+  std::size_t index_{0};
+  std::string_view remaining_{};
+  std::string_view key_{};
+  Path::hash_t hash_{0};
+  bool is_root_{false};
+};
+
+}  // namespace infotree
+}  // namespace switcher
+#endif
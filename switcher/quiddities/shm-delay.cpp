@@ -18,7 +18,8 @@
  */
 
 #include "./shm-delay.hpp"
-#include "../utils/scope-exit.hpp"
+#include <algorithm>
+#include <cstring>
 
 namespace switcher {
 namespace quiddities {
@@ -66,6 +67,7 @@ ShmDelay::ShmDelay(quiddity::Config&& conf)
           "time_delay",
           [this](const double& val) {
             time_delay_ = val;
+            notify_writing_thread();
             return true;
           },
           [this]() { return time_delay_; },
@@ -112,6 +114,8 @@ ShmDelay::ShmDelay(quiddity::Config&& conf)
           "Input data capabilities must comply with the selected caps type (None means any)",
           restrict_caps_)) {}
 
+ShmDelay::~ShmDelay() { stop_writing(); }
+
 bool ShmDelay::on_shmdata_connect(const std::string& shmpath, claw::sfid_t sfid) {
   // Get the value of the delay from a shmdata
   if (claw_.get_follower_label(sfid) == "ltc-diff") {
@@ -133,7 +137,7 @@ bool ShmDelay::on_shmdata_connect(const std::string& shmpath, claw::sfid_t sfid)
   } else {
     // We do not delay using an ltc-diff shmdata.
     if (shm_follower_) {
-      writing_task_.reset();
+      stop_writing();
       shmw_.reset();
       shm_follower_.reset();
     }
@@ -149,40 +153,15 @@ bool ShmDelay::on_shmdata_connect(const std::string& shmpath, claw::sfid_t sfid)
           auto current_time = std::chrono::duration_cast<std::chrono::milliseconds>(
                                   std::chrono::system_clock::now().time_since_epoch())
                                   .count();
-          delay_content_.push(ShmContent(static_cast<double>(current_time), data, data_size));
+          delay_content_.push(static_cast<double>(current_time), data, data_size);
+          notify_writing_thread();
         },
         [this](const std::string& str_caps) {
-          GstCaps* caps = gst_caps_from_string(str_caps.c_str());
-          On_scope_exit {
-            if (nullptr != caps) gst_caps_unref(caps);
-          };
-
+          stop_writing();
           // We are only delaying so the caps will be identical to the received shmdata
           shmw_ = std::make_unique<shmdata::Writer>(
               this, claw_.get_shmpath_from_writer_label("delayed-shm"), 1, str_caps);
-
-          // Task checking if a previously recorded shmdata is a candidate to be written.
-          writing_task_ = std::make_unique<PeriodicTask<std::chrono::microseconds>>(
-              [this]() {
-                auto current_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                        std::chrono::system_clock::now().time_since_epoch())
-                                        .count();
-                // Look for the closest shmdata content in time to our target time
-                auto closest = delay_content_.find_closest(current_time - time_delay_);
-
-                if (!closest.data_size_) return;
-
-                // Same frame as before, we do not forward it.
-                if (closest.timestamp_ == last_timestamp_) return;
-
-                // We record the timestamp of the shmdata we are now forwarding.
-                last_timestamp_ = closest.timestamp_;
-
-                shmw_->writer<&::shmdata::Writer::copy_to_shm>(closest.content_.data(),
-                                                                     closest.data_size_);
-                shmw_->bytes_written(closest.data_size_);
-              },
-              std::chrono::microseconds(100));
+          start_writing();
         },
         nullptr,
         shmdata::Stat::kDefaultUpdateInterval,
@@ -198,72 +177,157 @@ bool ShmDelay::on_shmdata_disconnect(claw::sfid_t sfid) {
     diff_follower_.reset();
     pmanage<&property::PBag::enable>(time_delay_id_);
   } else {
-    writing_task_.reset();
+    stop_writing();
     shmw_.reset();
     shm_follower_.reset();
   }
   return true;
 }
 
-ShmDelay::ShmContent::ShmContent(double timestamp, void* content, size_t data_size)
-    : data_size_(data_size), timestamp_(timestamp) {
-  content_.resize(data_size);
+void ShmDelay::start_writing() {
+  stop_writing_ = false;
+  writing_thread_ = std::thread([this]() { write_delayed_frames(); });
+}
 
-  // We serialize the shmdata into a vector
-  memcpy(content_.data(), content, data_size);
+void ShmDelay::stop_writing() {
+  if (!writing_thread_.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lock(writing_m_);
+    stop_writing_ = true;
+  }
+  writing_cv_.notify_one();
+  writing_thread_.join();
 }
 
-void ShmDelay::ShmBuffer::push(const ShmContent& content) {
-  std::lock_guard<std::mutex> lock(buffer_m_);
-  buffer_.push_back(content);
-  total_size_ += content.get_size();
+void ShmDelay::notify_writing_thread() {
+  // taking the lock ensures the notification is not sent while the writing thread is between
+  // checking the buffer and waiting
+  { std::lock_guard<std::mutex> lock(writing_m_); }
+  writing_cv_.notify_one();
+}
 
-  // If the new sample made us go over the buffer physical limit, we remove frames until they all
-  // fit the buffer
-  while (total_size_ > max_size_) {
-    total_size_ -= buffer_.front().get_size();
-    buffer_.pop_front();
+void ShmDelay::write_delayed_frames() {
+  std::unique_lock<std::mutex> lock(writing_m_);
+  while (!stop_writing_) {
+    auto next_timestamp = delay_content_.next_timestamp(last_timestamp_);
+    if (0 == next_timestamp) {
+      // wait for a new frame
+      writing_cv_.wait(lock);
+      continue;
+    }
+    auto due = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::duration<double, std::milli>(next_timestamp + time_delay_)));
+    auto now = std::chrono::system_clock::now();
+    if (now < due) {
+      // wait for the frame to be due, or for a delay update
+      writing_cv_.wait_until(lock, due);
+      continue;
+    }
+    // Write the most recent due frame. Older frames that are also due are skipped, since we are
+    // late for them.
+    auto target_timestamp =
+        std::chrono::duration<double, std::milli>(now.time_since_epoch()).count() - time_delay_;
+    lock.unlock();
+    auto timestamp = delay_content_.access_closest(
+        target_timestamp, last_timestamp_, [this](const void* data, size_t data_size) {
+          shmw_->copy_to_shm(data, data_size);
+        });
+    lock.lock();
+    // We record the timestamp of the shmdata we are now forwarding.
+    if (0 != timestamp) last_timestamp_ = timestamp;
   }
 }
 
-void ShmDelay::ShmBuffer::set_buffer_size(const size_t& size) {
+void ShmDelay::ShmBuffer::push(double timestamp, const void* data, size_t data_size) {
   std::lock_guard<std::mutex> lock(buffer_m_);
-  max_size_ = size * (1 << 20);  // Convert megabytes to bytes.
+  // The frame cannot fit into the buffer
+  if (data_size > max_size_) return;
+  if (!arena_) {
+    // not value-initialized: only the pages frames are written to get committed
+    arena_ = std::unique_ptr<u_int8_t[]>(new u_int8_t[max_size_]);
+    arena_size_ = max_size_;
+  }
 
-  // Remove older frames until they all fit the new size
-  while (total_size_ > max_size_) {
-    total_size_ -= buffer_.front().get_size();
-    buffer_.pop_front();
+  // If the frame does not fit at the end of the arena, older frames located at the end are
+  // dropped and the frame is written at the beginning.
+  auto offset = write_offset_;
+  if (offset + data_size > arena_size_) {
+    while (!frames_.empty() && frames_.front().offset_ >= write_offset_) frames_.pop_front();
+    offset = 0;
   }
+  // Drop older frames overlapping with the new one
+  while (!frames_.empty() && frames_.front().offset_ < offset + data_size &&
+         frames_.front().offset_ + frames_.front().size_ > offset)
+    frames_.pop_front();
+
+  memcpy(arena_.get() + offset, data, data_size);
+  frames_.push_back(Frame{timestamp, offset, data_size});
+  write_offset_ = offset + data_size;
 }
 
-ShmDelay::ShmContent ShmDelay::ShmBuffer::find_closest(double target_timestamp) const {
-  // Arbitrary initialization of the difference between the target timestamp and the frames from the
-  // buffer
-  double diff = 1000;
+void ShmDelay::ShmBuffer::set_buffer_size(const size_t& size) {
+  std::lock_guard<std::mutex> lock(buffer_m_);
+  auto max_size = size * (1 << 20);  // Convert megabytes to bytes.
+  if (max_size == max_size_) return;
+  max_size_ = max_size;
+  if (!arena_) return;
 
-  // Used to detect that we are getting closer to the target timestamp
-  bool getting_closer = false;
+  // Keep the most recent frames that fit the new size.
+  size_t kept_size = 0;
+  auto first_kept = frames_.size();
+  while (first_kept > 0 && kept_size + frames_[first_kept - 1].size_ <= max_size_) {
+    --first_kept;
+    kept_size += frames_[first_kept].size_;
+  }
+  frames_.erase(frames_.begin(), frames_.begin() + first_kept);
+  if (frames_.empty()) {
+    // nothing to keep, the arena is allocated again with the new size by the next push
+    arena_.reset();
+    arena_size_ = 0;
+    write_offset_ = 0;
+    return;
+  }
 
-  std::lock_guard<std::mutex> lock(buffer_m_);
-  if (buffer_.empty()) return ShmContent();
-  auto closest = buffer_.front();
-  for (auto& item : buffer_) {
-    // We take the absolute value of the difference with the
-    auto new_diff = item.timestamp_ - target_timestamp;
-    if (new_diff < 0) new_diff = -new_diff;
-    // We are getting closer to the target timestamp
-    if (new_diff < diff) {
-      diff = new_diff;
-      closest = item;
-      getting_closer = true;
-    } else if (getting_closer && new_diff > diff) {
-      // We were getting closer and now getting further, so we will return the previous item.
-      break;
-    }
+  // Move the kept frames into an arena with the new size. It is not value-initialized, so only
+  // the pages receiving the kept frames get committed.
+  auto arena = std::unique_ptr<u_int8_t[]>(new u_int8_t[max_size_]);
+  size_t offset = 0;
+  for (auto& frame : frames_) {
+    memcpy(arena.get() + offset, arena_.get() + frame.offset_, frame.size_);
+    frame.offset_ = offset;
+    offset += frame.size_;
   }
+  arena_ = std::move(arena);
+  arena_size_ = max_size_;
+  write_offset_ = offset;
+}
+
+double ShmDelay::ShmBuffer::next_timestamp(double after) const {
+  std::lock_guard<std::mutex> lock(buffer_m_);
+  auto next = std::upper_bound(
+      frames_.begin(), frames_.end(), after, [](double timestamp, const Frame& frame) {
+        return timestamp < frame.timestamp_;
+      });
+  if (frames_.end() == next) return 0;
+  return next->timestamp_;
+}
 
-  return closest;
+double ShmDelay::ShmBuffer::access_closest(
+    double target_timestamp,
+    double after,
+    const std::function<void(const void*, size_t)>& access) const {
+  std::lock_guard<std::mutex> lock(buffer_m_);
+  // first frame more recent than the target
+  auto next = std::upper_bound(
+      frames_.begin(), frames_.end(), target_timestamp, [](double timestamp, const Frame& frame) {
+        return timestamp < frame.timestamp_;
+      });
+  if (frames_.begin() == next) return 0;
+  auto closest = std::prev(next);
+  if (closest->timestamp_ <= after) return 0;
+  access(arena_.get() + closest->offset_, closest->size_);
+  return closest->timestamp_;
 }
 
 }  // namespace quiddities
@@ -20,12 +20,13 @@
 #ifndef SWITCHER_SHMDELAY_HPP
 #define SWITCHER_SHMDELAY_HPP
 
+#include <condition_variable>
 #include <deque>
+#include <thread>
 #include "../gst/utils.hpp"
 #include "../quiddity/quiddity.hpp"
 #include "../shmdata/follower.hpp"
 #include "../shmdata/writer.hpp"
-#include "../utils/periodic-task.hpp"
 
 namespace switcher {
 namespace quiddities {
@@ -36,43 +37,61 @@ using namespace quiddity;
 class ShmDelay : public Quiddity {
  public:
   ShmDelay(quiddity::Config&& conf);
-  ~ShmDelay() = default;
+  ~ShmDelay();
 
  private:
-  struct ShmContent {
-    ShmContent(double timestamp, void* content, size_t data_size);
-    ShmContent() = default;
-    ~ShmContent() = default;
-    /** Get physical size of the shmdata
-    * content (overhead not accounted for because not relevant in size compared to the data)
-    */
-    size_t get_size() const { return content_.size(); }
-    std::vector<u_int8_t> content_{};  //!< Vector containing received shm data frames
-    size_t data_size_{0};              //!< Size of the shmdata.
-    double timestamp_{0};              //!< Timestamp at the time of shmdata reception.
-  };
-
   /**
-   * ShmBuffer , contains a vector of ShmContent and is limited in physical size.
-   * Can be searched for closest timestamped object.
+   * ShmBuffer, stores received shmdata frames into a ring arena limited in physical size. The
+   * arena is allocated once, and frames are indexed by timestamp in order to be searched with a
+   * binary search.
    */
-  struct ShmBuffer {
+  class ShmBuffer {
+   public:
     ShmBuffer(size_t buffer_size) : max_size_(buffer_size * (1 << 20)) {}
     ~ShmBuffer() = default;
-    void push(const ShmContent& content);  //!< Push a ShmContent object in the buffer
+    /**
+     * Copy a frame into the arena, dropping older frames if there is not enough room.
+     * Timestamps are expected to be increasing.
+     */
+    void push(double timestamp, const void* data, size_t data_size);
     void set_buffer_size(const size_t& size);
-    ShmContent find_closest(
-        double timestamp) const;  //!< Find the closest shmdata to the provided timestamp
+    /**
+     * Get the timestamp of the oldest frame more recent than the given timestamp.
+     * \return The timestamp, or 0 if no such frame is available.
+     */
+    double next_timestamp(double after) const;
+    /**
+     * Give access to the most recent frame that is not more recent than target_timestamp. The
+     * frame is given by reference, and is valid only during the call to the access function.
+     * \param target_timestamp  The target timestamp
+     * \param after             Frames that are not more recent than this are ignored
+     * \param access            Function called with the frame data and size
+     * \return The timestamp of the frame given to access, or 0 if no frame was found.
+     */
+    double access_closest(double target_timestamp,
+                          double after,
+                          const std::function<void(const void*, size_t)>& access) const;
 
    private:
-    mutable std::mutex buffer_m_{};    //!< Mutex here to protect the buffer accesses.
-    std::deque<ShmContent> buffer_{};  //!< Buffer of shmdata frames.
-    size_t total_size_{0};  //!< Current total size of the buffer (not accounting for overhead)
-    size_t max_size_{0};    //!< Maximum size in bytes of the buffer.
+    struct Frame {
+      double timestamp_{0};  //!< Timestamp at the time of shmdata reception.
+      size_t offset_{0};     //!< Position of the frame in the arena.
+      size_t size_{0};       //!< Size of the shmdata.
+    };
+    mutable std::mutex buffer_m_{};  //!< Mutex here to protect the buffer accesses.
+    std::unique_ptr<u_int8_t[]> arena_{};  //!< Frames data, allocated with the first frame.
+    size_t arena_size_{0};                 //!< Size of the allocated arena.
+    std::deque<Frame> frames_{};           //!< Index of frames, ordered by timestamp.
+    size_t write_offset_{0};  //!< Position in the arena following the most recent frame.
+    size_t max_size_{0};      //!< Maximum size in bytes of the buffer.
   };
 
   bool on_shmdata_connect(const std::string& shmpath, claw::sfid_t sfid);
   bool on_shmdata_disconnect(claw::sfid_t sfid);
+  void start_writing();
+  void stop_writing();
+  void write_delayed_frames();
+  void notify_writing_thread();
 
   static const std::string kConnectionSpec;  //!< Shmdata specifications
 
@@ -80,8 +99,10 @@ class ShmDelay : public Quiddity {
   std::unique_ptr<shmdata::Follower> shm_follower_{nullptr};          //!< Shmdata to be delayed
   std::unique_ptr<shmdata::Follower> diff_follower_{nullptr};         //!< Timecode delay
   std::unique_ptr<shmdata::Writer> shmw_{};                           //!< Shmdata writer.
-  std::unique_ptr<PeriodicTask<std::chrono::microseconds>> writing_task_{
-      nullptr};  //!< Shmdata writing task (high frequency to be accurate on timestamp checking)
+  std::thread writing_thread_{};  //!< Writes frames when they are due, according to the delay
+  std::mutex writing_m_{};
+  std::condition_variable writing_cv_{};  //!< Notified with new frames or delay updates
+  bool stop_writing_{false};
   double last_timestamp_{0};  //!< Timestamp of the last written shmdata.
 
   // Properties
@@ -187,7 +187,9 @@ Timelapse::Timelapse(quiddity::Config&& conf)
               for (auto& it : shmdatas) start_timelapse(claw_.get_follower_shmpath(it), it);
             }
           },
-          std::chrono::milliseconds(200)),
+          std::chrono::milliseconds(200),
+          // relaunching pipelines may block, this is not run along with the short periodic tasks
+          Scheduler::get_blocking()),
       timelapse_config_{std::string(), std::string()} {}
 
 bool Timelapse::on_shmdata_disconnect(claw::sfid_t sfid) {
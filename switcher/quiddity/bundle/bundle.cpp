@@ -212,7 +212,7 @@ bool Bundle::make_quiddities(const std::vector<bundle::quiddity_spec_t>& quids)
     quiddity_removal_cb_ids_.push_back(
         manager_->qcontainer_->register_removal_cb([this](quiddity::qid_t id) {
           sw_debug("The bundle {} was destroyed because one of its quiddities ({}) was destroyed",
-                   nickname_,
+                   get_nickname(),
                    manager_->qcontainer_->get_nickname(id));
           // We only self destruct it once so we unregister all the removal callbacks.
           manager_->qcontainer_->reset_create_remove_cb();
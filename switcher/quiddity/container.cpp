@@ -45,13 +45,13 @@ Qrox Container::create(const std::string& quiddity_kind,
 
   // Copy the registered callbacks map
   // @NOTE: This is required in case a callback modifies it
-  auto on_created_map = on_created_cbs_;
+  auto on_created_map = get_callbacks(on_created_cbs_);
   // Iterate over callbacks
   for(auto& pair : on_created_map) {
     // Call second element of the pair which is the callback,
     // passing the current quiddity id as an argument.
     pair.second(res.get_id());
-    if (on_created_cbs_.empty()) break;
+    if (!has_callbacks(on_created_cbs_)) break;
   }
   // return the qrox
   return res;
@@ -68,24 +68,32 @@ Qrox Container::quiet_create(const std::string& quiddity_kind,
   // searching for a free id
   // note id is added into ids before creation because it is possibly used by quiddities
   // during initialization, if initilization fails, id will be removed searching for an available id
-  auto cur_id = ids_.allocate_id();
-  if (Ids::kInvalid == cur_id) {
-    Qrox(false, "no more id available for Quiddity creation");
-  }
-
-  // nickname
+  // the nickname is reserved the same way, so that concurrent creations cannot share it
+  qid_t cur_id;
   std::string nick;
-  if (raw_nickname.empty()) {
-    nick = quiddity_kind + std::to_string(cur_id);
-  } else {
-    nick = raw_nickname;
-    for (const auto& it : quiddities_) {
-      if (nick == it.second->get_nickname()) {
-        ids_.release_last_allocated_id();
-        return Qrox(false, "nickname unavailable");
-      }
+  {
+    std::unique_lock<std::shared_mutex> lock(quiddities_mtx_);
+    cur_id = ids_.allocate_id();
+    if (Ids::kInvalid == cur_id) {
+      return Qrox(false, "no more id available for Quiddity creation");
+    }
+    nick = raw_nickname.empty() ? quiddity_kind + std::to_string(cur_id) : raw_nickname;
+    if (!nicknames_.emplace(nick, cur_id).second) {
+      ids_.release_id(cur_id);
+      return Qrox(false, "nickname unavailable");
     }
   }
+  auto release_reservation = [&]() {
+    std::unique_lock<std::shared_mutex> lock(quiddities_mtx_);
+    ids_.release_id(cur_id);
+    // the quiddity may have been renamed during its initialization
+    for (auto it = nicknames_.begin(); it != nicknames_.end(); ++it) {
+      if (cur_id == it->second) {
+        nicknames_.erase(it);
+        break;
+      }
+    }
+  };
 
   // building configuration for quiddity creation
   InfoTree::ptr tree;
@@ -101,15 +109,19 @@ Qrox Container::quiet_create(const std::string& quiddity_kind,
       Config(
           cur_id, nick, quiddity_kind, InfoTree::merge(tree.get(), override_config).get(), this));
   if (!quiddity) {
-    ids_.release_last_allocated_id();
+    release_reservation();
     return Qrox(false, "Quiddity creation error");
   }
 
   if (!(*quiddity.get())) {
-    ids_.release_last_allocated_id();
+    release_reservation();
     return Qrox(false, "Quiddity initialization error");
   }
-  quiddities_[cur_id] = quiddity;
+  {
+    std::unique_lock<std::shared_mutex> lock(quiddities_mtx_);
+    quiddities_[cur_id] = quiddity;
+    nick = quiddity->nickname_;
+  }
 
   return Qrox(true, nick, cur_id, quiddity.get());
 }
@@ -122,20 +134,22 @@ Qrox Container::quiet_create(const std::string& quiddity_kind,
 */
 void Container::notify_quiddity_created(Quiddity *quid) {
   // We work on a copy in case a callback modifies the map of registered callbacks
-  auto cbs_map = on_created_cbs_;
+  auto cbs_map = get_callbacks(on_created_cbs_);
   for (auto& pair : cbs_map) {
     auto callback = pair.second;
     callback(quid->get_id());
-    if (on_created_cbs_.empty()) break;  // In case the map gets reset in the callback, e.g bundle
+    // In case the map gets reset in the callback, e.g bundle
+    if (!has_callbacks(on_created_cbs_)) break;
   }
 };
 
 BoolLog Container::remove(qid_t id) {
   // We work on a copy in case a callback modifies the map of registered callbacks
-  const auto tmp_removed_cbs_ = on_removed_cbs_;
+  const auto tmp_removed_cbs_ = get_callbacks(on_removed_cbs_);
   for (const auto& cb : tmp_removed_cbs_) {
     cb.second(id);
-    if (on_removed_cbs_.empty()) break;  // In case the map gets reset in the callback, e.g. bundle
+    // In case the map gets reset in the callback, e.g. bundle
+    if (!has_callbacks(on_removed_cbs_)) break;
   }
   auto res = quiet_remove(id);
   if (!res) return res;
@@ -143,43 +157,59 @@ BoolLog Container::remove(qid_t id) {
 }
 
 BoolLog Container::quiet_remove(qid_t id) {
-  if (!ids_.release_id(id)) return BoolLog(false, "quiddity not found");
-  quiddities_.erase(id);
+  // the quiddity is destroyed out of the lock, since its destructor may use the container
+  Quiddity::ptr quid;
+  {
+    std::unique_lock<std::shared_mutex> lock(quiddities_mtx_);
+    auto found = quiddities_.find(id);
+    if (quiddities_.end() == found) return BoolLog(false, "quiddity not found");
+    quid = std::move(found->second);
+    quiddities_.erase(found);
+    nicknames_.erase(quid->nickname_);
+    ids_.release_id(id);
+  }
   return BoolLog(true);
 }
 
 std::vector<std::string> Container::get_nicknames() const {
+  std::shared_lock<std::shared_mutex> lock(quiddities_mtx_);
   std::vector<std::string> res;
-  for (const auto& it : quiddities_) res.push_back(it.second->get_nickname());
+  res.reserve(quiddities_.size());
+  for (const auto& it : quiddities_) res.push_back(it.second->nickname_);
   return res;
 }
 
-std::vector<qid_t> Container::get_ids() const { return ids_.get_ids(); }
+std::vector<qid_t> Container::get_ids() const {
+  std::shared_lock<std::shared_mutex> lock(quiddities_mtx_);
+  return ids_.get_ids();
+}
 
 InfoTree::ptr Container::get_quiddities_description() {
   auto tree = InfoTree::make();
   tree->graft("quiddities", InfoTree::make());
   tree->tag_as_array("quiddities", true);
   auto subtree = tree->get_tree("quiddities");
+  std::shared_lock<std::shared_mutex> lock(quiddities_mtx_);
   for (const auto& it : quiddities_) {
     if (it.second) {
       auto quid = it.second;
       const auto id = std::to_string(quid->get_id());
       subtree->graft(id + ".id", InfoTree::make(quid->get_id()));
       subtree->graft(id + ".kind", InfoTree::make(quid->get_kind()));
-      subtree->graft(id + ".nickname", InfoTree::make(quid->get_nickname()));
+      subtree->graft(id + ".nickname", InfoTree::make(quid->nickname_));
     }
   }
   return tree;
 }
 
 InfoTree::ptr Container::get_quiddity_description(qid_t id) {
-  auto it = quiddities_.find(id);
-  if (quiddities_.end() == it) return InfoTree::make();
-  return it->second->get_description();
+  auto quid = get_quiddity(id);
+  if (!quid) return InfoTree::make();
+  return quid->get_description();
 }
 
 Quiddity::ptr Container::get_quiddity(qid_t id) {
+  std::shared_lock<std::shared_mutex> lock(quiddities_mtx_);
   auto it = quiddities_.find(id);
   if (quiddities_.end() == it) {
     logger_->sw_debug("quiddity {} not found, cannot provide ptr", std::to_string(id));
@@ -190,6 +220,7 @@ Quiddity::ptr Container::get_quiddity(qid_t id) {
 }
 
 unsigned int Container::register_creation_cb(void_func_t cb) {
+  std::lock_guard<std::mutex> lock(cbs_mtx_);
   static unsigned int id = 0;
   id %= std::numeric_limits<unsigned int>::max();
   me_.lock();
@@ -198,6 +229,7 @@ unsigned int Container::register_creation_cb(void_func_t cb) {
 }
 
 unsigned int Container::register_removal_cb(void_func_t cb) {
+  std::lock_guard<std::mutex> lock(cbs_mtx_);
   static unsigned int id = 0;
   id %= std::numeric_limits<unsigned int>::max();
   me_.lock();
@@ -206,33 +238,62 @@ unsigned int Container::register_removal_cb(void_func_t cb) {
 }
 
 void Container::unregister_creation_cb(unsigned int id) {
+  std::lock_guard<std::mutex> lock(cbs_mtx_);
   me_.lock();
   auto it = on_created_cbs_.find(id);
   if (it != on_created_cbs_.end()) on_created_cbs_.erase(it);
 }
 
 void Container::unregister_removal_cb(unsigned int id) {
+  std::lock_guard<std::mutex> lock(cbs_mtx_);
   me_.lock();
   auto it = on_removed_cbs_.find(id);
   if (it != on_removed_cbs_.end()) on_removed_cbs_.erase(it);
 }
 
 void Container::reset_create_remove_cb() {
+  std::lock_guard<std::mutex> lock(cbs_mtx_);
   me_.lock();
   on_created_cbs_.clear();
   on_removed_cbs_.clear();
 }
 
+std::map<unsigned int, Container::void_func_t> Container::get_callbacks(
+    const std::map<unsigned int, void_func_t>& cbs) const {
+  std::lock_guard<std::mutex> lock(cbs_mtx_);
+  return cbs;
+}
+
+bool Container::has_callbacks(const std::map<unsigned int, void_func_t>& cbs) const {
+  std::lock_guard<std::mutex> lock(cbs_mtx_);
+  return !cbs.empty();
+}
+
 qid_t Container::get_id(const std::string& nickname) const {
-  for (const auto& it : quiddities_) {
-    if (nickname == it.second->get_nickname()) return it.first;
-  }
-  // not found
-  return 0;
+  std::shared_lock<std::shared_mutex> lock(quiddities_mtx_);
+  auto found = nicknames_.find(nickname);
+  // not found, or reserved by a quiddity still under creation
+  if (nicknames_.end() == found || 0 == quiddities_.count(found->second)) return 0;
+  return found->second;
 }
 
 std::string Container::get_nickname(qid_t id) const {
-  return quiddities_.find(id)->second->get_nickname();
+  std::shared_lock<std::shared_mutex> lock(quiddities_mtx_);
+  auto found = quiddities_.find(id);
+  if (quiddities_.end() == found) return std::string();
+  return found->second->nickname_;
+}
+
+bool Container::rename(Quiddity* quid, const std::string& nickname) {
+  std::unique_lock<std::shared_mutex> lock(quiddities_mtx_);
+  const auto id = quid->get_id();
+  auto found = nicknames_.find(nickname);
+  if (nicknames_.end() != found) return id == found->second;
+  auto previous = nicknames_.find(quid->nickname_);
+  if (nicknames_.end() != previous && id == previous->second) nicknames_.erase(previous);
+  nicknames_.emplace(nickname, id);
+  quid->nickname_ = nickname;
+  return true;
 }
 
 Qrox Container::get_qrox(qid_t id) {
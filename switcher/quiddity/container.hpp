@@ -20,7 +20,11 @@
 #ifndef __SWITCHER_QUIDDITY_CONTAINER_H__
 #define __SWITCHER_QUIDDITY_CONTAINER_H__
 
+#include <map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
 #include <thread>
 #include <unordered_map>
 
@@ -40,8 +44,14 @@ class Switcher;
 namespace quiddity {
 class Bundle;
 
+/**
+ * Container owns the quiddities of a Switcher instance. Quiddities are indexed by id and by
+ * nickname, both tables being protected by a reader-writer lock: concurrent lookups do not block
+ * each other, creation and removal lock the tables only while updating them.
+ */
 class Container {
   friend class Bundle;
+  friend class Quiddity;  // nickname changes are applied through the nickname index
 
  public:
   /**
@@ -152,6 +162,7 @@ class Container {
 
   // forwarding accessor and return constructor on error
   std::pair<bool, Quiddity*> find_quiddity(qid_t id) const {
+    std::shared_lock<std::shared_mutex> lock(quiddities_mtx_);
     auto it = quiddities_.find(id);
     if (quiddities_.end() == it) {
       return std::make_pair(false, nullptr);
@@ -165,15 +176,35 @@ class Container {
     return ReturnType();
   }
 
+  /**
+   * Change the nickname of a quiddity, updating the nickname index.
+   *
+   * \param quid     The quiddity to rename.
+   * \param nickname The new nickname.
+   *
+   * \return false if the nickname is already used by another quiddity.
+   */
+  bool rename(Quiddity* quid, const std::string& nickname);
+
+  // callback maps are accessed with these, quiddities being created concurrently by load_state
+  std::map<unsigned int, void_func_t> get_callbacks(
+      const std::map<unsigned int, void_func_t>& cbs) const;
+  bool has_callbacks(const std::map<unsigned int, void_func_t>& cbs) const;
+
   const logger::Logger* logger_;
   quiddity::Factory* factory_;
+  mutable std::mutex cbs_mtx_{};  // protects on_created_cbs_ and on_removed_cbs_
   std::map<unsigned int, void_func_t> on_created_cbs_{};
   std::map<unsigned int, void_func_t> on_removed_cbs_{};
   CounterMap counters_{};
   std::weak_ptr<Container> me_{};
   Switcher* switcher_;
+  // protects ids_, quiddities_, nicknames_ and the nickname of the quiddities
+  mutable std::shared_mutex quiddities_mtx_{};
   Ids ids_{};
   std::unordered_map<qid_t, std::shared_ptr<Quiddity>> quiddities_{};
+  // nicknames are reserved here before the creation of the quiddity, and released on removal
+  std::unordered_map<std::string, qid_t> nicknames_{};
 };
 
 }  // namespace quiddity
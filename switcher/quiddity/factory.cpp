@@ -20,6 +20,14 @@
 #include "./factory.hpp"
 #include <gio/gio.h>
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <mutex>
+
+#include "../infotree/json-serializer.hpp"
+#include "../utils/file-utils.hpp"
+
 // the quiddities to register (line sorted)
 #include "../quiddities/audio-test-source.hpp"
 #include "../quiddities/dummy-sink.hpp"
@@ -39,6 +47,8 @@
 namespace switcher {
 namespace quiddity {
 
+namespace fs = std::filesystem;
+
 quiddity::Factory::Factory(logger::Logger* logger) : logger_(logger) {
   abstract_factory_.register_kind<quiddities::AudioTestSource>(
       DocumentationRegistry::get()->get_type_from_kind("AudioTestSource"));
@@ -68,9 +78,11 @@ quiddity::Factory::Factory(logger::Logger* logger) : logger_(logger) {
       DocumentationRegistry::get()->get_type_from_kind("Uridecodebin"));
   abstract_factory_.register_kind<quiddities::VideoTestSource>(
       DocumentationRegistry::get()->get_type_from_kind("VideoTestSource"));
+  load_manifest();
 }
 
 bool quiddity::Factory::scan_dir(const std::string& directory_path) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
   GFile* dir = g_file_new_for_commandline_arg(directory_path.c_str());
   gboolean res;
   GError* error;
@@ -86,7 +98,8 @@ bool quiddity::Factory::scan_dir(const std::string& directory_path) {
     GFile* descend = g_file_get_child(dir, g_file_info_get_name(info));
     char* absolute_path = g_file_get_path(descend);  // g_file_get_relative_path (dir, descend);
     // trying to load the module
-    if (g_str_has_suffix(absolute_path, ".so") || g_str_has_suffix(absolute_path, ".dylib")) {
+    if ((g_str_has_suffix(absolute_path, ".so") || g_str_has_suffix(absolute_path, ".dylib")) &&
+        !register_from_manifest(absolute_path)) {
       logger_->sw_debug("loading module {}", absolute_path);
       load_plugin(absolute_path);
     }
@@ -101,6 +114,7 @@ bool quiddity::Factory::scan_dir(const std::string& directory_path) {
   g_object_unref(dir);
 
   plugin_dirs_.emplace_back(directory_path);
+  if (manifest_changed_) save_manifest();
   return true;
 }
 
@@ -111,6 +125,8 @@ std::string quiddity::Factory::get_default_plugin_dir() const {
 std::vector<std::string> quiddity::Factory::get_plugin_dirs() const { return plugin_dirs_; }
 
 InfoTree::ptr quiddity::Factory::get_kinds_doc() const {
+  // opening a plugin registers its documentation
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   auto kinds_str = std::string(".kinds.");
   auto res = InfoTree::make();
   res->graft(kinds_str, InfoTree::make());
@@ -130,7 +146,8 @@ InfoTree::ptr quiddity::Factory::get_kinds_doc() const {
 }
 
 bool quiddity::Factory::exists(const std::string& kind) const {
-  return abstract_factory_.key_exists(kind);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return abstract_factory_.key_exists(kind) || lazy_plugins_.end() != lazy_plugins_.find(kind);
 }
 
 bool quiddity::Factory::load_plugin(const std::string& filename) {
@@ -140,31 +157,152 @@ bool quiddity::Factory::load_plugin(const std::string& filename) {
     return false;
   }
   std::string kind = plugin->get_kind();
-  // ignore already loaded plugin
-  if (plugins_.end() != plugins_.find(kind)) {
+  // ignore already loaded plugin, or already registered from the manifest
+  if (plugins_.end() != plugins_.find(kind) || lazy_plugins_.end() != lazy_plugins_.find(kind)) {
     logger_->sw_debug("ignoring already loaded plugin ({} from file {})", kind, filename);
     return false;
   }
 
   abstract_factory_.register_kind_with_custom_factory(kind, plugin->create_, plugin->destroy_);
   plugins_.emplace(kind, std::move(plugin));
+
+  // recording the plugin in the manifest, with the documentation registered when opening it
+  auto stamp = get_file_stamp(filename);
+  auto recorded = manifest_.find(filename);
+  if (manifest_.end() == recorded || recorded->second.stamp != stamp ||
+      recorded->second.kind != kind) {
+    const auto& docs = DocumentationRegistry::get()->get_docs();
+    auto doc = docs.find(kind);
+    manifest_[filename] =
+        ManifestEntry{stamp, kind, docs.end() != doc ? doc->second : quiddity::Doc()};
+    manifest_changed_ = true;
+  }
+  return true;
+}
+
+bool quiddity::Factory::register_from_manifest(const std::string& filename) {
+  auto found = manifest_.find(filename);
+  if (manifest_.end() == found || found->second.stamp != get_file_stamp(filename)) return false;
+  const auto& entry = found->second;
+  if (abstract_factory_.key_exists(entry.kind) ||
+      lazy_plugins_.end() != lazy_plugins_.find(entry.kind)) {
+    logger_->sw_debug("ignoring already registered plugin ({} from file {})", entry.kind, filename);
+    return true;
+  }
+  lazy_plugins_.emplace(entry.kind, filename);
+  DocumentationRegistry::get()->register_doc(entry.kind, entry.doc);
   return true;
 }
 
 Quiddity::ptr quiddity::Factory::create(const std::string& kind, quiddity::Config&& config) {
-  return abstract_factory_.create(kind, std::forward<quiddity::Config>(config));
+  // the quiddity is constructed out of the lock, since bundles create quiddities
+  auto create_quiddity = [&]() {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return abstract_factory_.get_create(kind);
+  }();
+  if (!create_quiddity) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto lazy = lazy_plugins_.find(kind);
+    if (lazy_plugins_.end() != lazy) {
+      // first quiddity of a plugin kind, opening the plugin
+      auto filename = lazy->second;
+      lazy_plugins_.erase(lazy);
+      logger_->sw_debug("loading module {}", filename);
+      if (!load_plugin(filename)) {
+        // the plugin will be opened during the next scan
+        manifest_.erase(filename);
+        manifest_changed_ = true;
+      }
+      if (manifest_changed_) save_manifest();
+    }
+    create_quiddity = abstract_factory_.get_create(kind);
+  }
+  if (!create_quiddity) return nullptr;
+  return create_quiddity(std::forward<quiddity::Config>(config));
 }
 
 std::vector<std::string> quiddity::Factory::get_kinds() const {
-  return abstract_factory_.get_keys();
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto res = abstract_factory_.get_keys();
+  for (const auto& it : lazy_plugins_) res.push_back(it.first);
+  std::sort(res.begin(), res.end());
+  return res;
 }
 
 void quiddity::Factory::register_kind_with_custom_factory(
     const std::string& kind,
     Quiddity* (*custom_create)(quiddity::Config&&),
     void (*custom_destroy)(Quiddity*)) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
   abstract_factory_.register_kind_with_custom_factory(kind, custom_create, custom_destroy);
 }
 
+fs::path quiddity::Factory::get_manifest_path() {
+  // check for $XDG_CACHE_HOME variable, or use recommended fallback as a default
+  const auto env_xch = std::getenv("XDG_CACHE_HOME");
+  const fs::path xch = env_xch ? fs::path(env_xch) : fs::path(std::getenv("HOME")) / ".cache";
+  return xch / "switcher" / "plugin-manifest.json";
+}
+
+std::string quiddity::Factory::get_file_stamp(const std::string& filename) {
+  std::error_code ec;
+  auto mtime = fs::last_write_time(filename, ec);
+  if (ec) return std::string();
+  auto size = fs::file_size(filename, ec);
+  if (ec) return std::string();
+  return std::to_string(mtime.time_since_epoch().count()) + "-" + std::to_string(size);
+}
+
+void quiddity::Factory::load_manifest() {
+  const auto path = get_manifest_path();
+  std::error_code ec;
+  if (!fs::exists(path, ec)) return;
+  auto tree = infotree::json::deserialize(fileutils::get_content(path));
+  auto plugins = tree->get_tree(".plugins");
+  if (!plugins) return;
+  for (const auto& it : plugins->get_child_keys(".")) {
+    auto entry = plugins->get_tree(it);
+    auto get = [&](const std::string& key) -> std::string { return entry->branch_get_value(key); };
+    auto filename = get(".file");
+    auto kind = get(".kind");
+    if (filename.empty() || kind.empty()) continue;
+    manifest_[filename] = ManifestEntry{
+        get(".stamp"),
+        kind,
+        quiddity::Doc(
+            get(".name"), get(".doc_kind"), get(".description"), get(".license"), get(".author"))};
+  }
+}
+
+void quiddity::Factory::save_manifest() {
+  manifest_changed_ = false;
+  auto tree = InfoTree::make();
+  tree->graft(".plugins", InfoTree::make());
+  tree->tag_as_array(".plugins", true);
+  size_t index = 0;
+  for (const auto& it : manifest_) {
+    // forgetting removed plugins
+    std::error_code ec;
+    if (!fs::exists(it.first, ec)) continue;
+    auto entry = ".plugins." + std::to_string(index++);
+    tree->vgraft(entry + ".file", it.first);
+    tree->vgraft(entry + ".stamp", it.second.stamp);
+    tree->vgraft(entry + ".kind", it.second.kind);
+    tree->vgraft(entry + ".name", it.second.doc.get_long_name());
+    tree->vgraft(entry + ".doc_kind", it.second.doc.get_kind());
+    tree->vgraft(entry + ".description", it.second.doc.get_description());
+    tree->vgraft(entry + ".license", it.second.doc.get_license());
+    tree->vgraft(entry + ".author", it.second.doc.get_author());
+  }
+  // written then renamed, so that other processes never read a partial manifest
+  const auto path = get_manifest_path();
+  std::error_code ec;
+  fs::create_directories(path.parent_path(), ec);
+  const auto tmp_path = path.string() + "." + std::to_string(getpid());
+  auto saved = fileutils::save(infotree::json::serialize(tree.get()), tmp_path);
+  if (saved) fs::rename(tmp_path, path, ec);
+  if (!saved || ec) logger_->sw_debug("plugin manifest {} not saved", path.string());
+}
+
 }  // namespace quiddity
 }  // namespace switcher
@@ -20,7 +20,10 @@
 #ifndef __SWITCHER_QUIDDITY_FACTORY_H__
 #define __SWITCHER_QUIDDITY_FACTORY_H__
 
+#include <filesystem>
+#include <map>
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -29,10 +32,18 @@
 #include "../logger/logger.hpp"
 #include "../utils/abstract-factory.hpp"
 #include "./config.hpp"
+#include "./doc.hpp"
 #include "./plugin-loader.hpp"
 
 namespace switcher {
 namespace quiddity {
+/**
+ * Factory creates quiddities from their kind. Plugins found when scanning directories are
+ * recorded in a manifest, kept in the user cache directory, with their kind and documentation.
+ * A plugin listed in the manifest is opened only when a quiddity of its kind is created for the
+ * first time. A plugin is opened during the scan if it is not in the manifest, or if its file
+ * changed since it was recorded.
+ */
 class Factory {
   friend class Container;
  public:
@@ -48,16 +59,38 @@ class Factory {
                                          Quiddity* (*custom_create)(quiddity::Config&&),
                                          void (*custom_destroy)(Quiddity*));
 
+  /**
+   * Get the path of the plugin manifest, $XDG_CACHE_HOME/switcher/plugin-manifest.json
+   * by default.
+   */
+  static std::filesystem::path get_manifest_path();
+
  private:
+  // plugin manifest entry, recorded when the plugin is opened
+  struct ManifestEntry {
+    std::string stamp;  // modification time and size of the plugin file
+    std::string kind;
+    quiddity::Doc doc;
+  };
+
   const logger::Logger* logger_;
   // create is private because it must be called from quiddity container only
   std::shared_ptr<Quiddity> create(const std::string& kind, quiddity::Config&& config);
   bool load_plugin(const std::string& filename);
   void close_plugin(const std::string& kind);
+  bool register_from_manifest(const std::string& filename);
+  void load_manifest();
+  void save_manifest();
+  static std::string get_file_stamp(const std::string& filename);
 
+  // protects the kinds registered, since quiddities are created from several threads
+  mutable std::shared_mutex mutex_{};
   std::vector<std::string> plugin_dirs_{};
   AbstractFactory<Quiddity, std::string, quiddity::Config&&> abstract_factory_{};
   std::unordered_map<std::string, PluginLoader::uptr> plugins_{};
+  std::unordered_map<std::string, std::string> lazy_plugins_{};  //!< plugin file by kind
+  std::map<std::string, ManifestEntry> manifest_{};              //!< by plugin file
+  bool manifest_changed_{false};
 };
 
 }  // namespace quiddity
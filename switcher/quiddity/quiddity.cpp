@@ -121,6 +121,8 @@ std::string Quiddity::get_kind() const { return kind_; }
 
 std::string Quiddity::get_manager_name() { return qcontainer_->get_switcher()->name_; }
 
+bool Quiddity::get_shm_huge_pages() { return qcontainer_->get_switcher()->get_shm_huge_pages(); }
+
 std::string Quiddity::get_quiddity_caps() {
   auto caps_str = qcontainer_->get_switcher()->get_switcher_caps();
   caps_str = caps_str + ",quiddity-id=(int)" + std::to_string(id_);
@@ -210,18 +212,22 @@ bool Quiddity::toggle_property_saving(const std::string& prop) {
 }
 
 bool Quiddity::set_nickname(const std::string& nickname) {
-  nickname_ = nickname;
+  // nicknames are unique, the container keeps its nickname index up to date
+  if (!qcontainer_->rename(this, nickname)) return false;
   smanage<&signal::SBag::notify>(on_nicknamed_id_, InfoTree::make(nickname));
   return true;
 }
 
-std::string Quiddity::get_nickname() const { return nickname_; }
+std::string Quiddity::get_nickname() const {
+  std::shared_lock<std::shared_mutex> lock(qcontainer_->quiddities_mtx_);
+  return nickname_;
+}
 
 InfoTree::ptr Quiddity::get_description() {
   auto tree = InfoTree::make();
   tree->graft(".id", InfoTree::make(id_));
   tree->graft(".kind", InfoTree::make(kind_));
-  tree->graft(".nickname", InfoTree::make(nickname_));
+  tree->graft(".nickname", InfoTree::make(get_nickname()));
   return tree;
 }
 
@@ -149,6 +149,7 @@ class Quiddity : public SafeBoolIdiom, public logger::Logger {
 
   std::string get_manager_name();
   std::string get_quiddity_caps();
+  bool get_shm_huge_pages();
 
   /**
    * Force notification of on-user-data-grafted signal. Note the signal is already triggered when
@@ -0,0 +1,84 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include "./dispatcher.hpp"
+
+namespace switcher {
+namespace quiddity {
+namespace signal {
+
+Dispatcher::ptr Dispatcher::get_default() {
+  static std::mutex mtx;
+  static std::weak_ptr<Dispatcher> dispatcher;
+  std::lock_guard<std::mutex> lock(mtx);
+  auto res = dispatcher.lock();
+  if (res) return res;
+  res = std::make_shared<Dispatcher>();
+  dispatcher = res;
+  return res;
+}
+
+Dispatcher::Dispatcher() : thread_([state = state_]() { work(state); }) {}
+
+Dispatcher::~Dispatcher() {
+  {
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->quit = true;
+  }
+  state_->cv.notify_one();
+  // the last reference to the dispatcher can be released by a task
+  if (is_dispatcher_thread())
+    thread_.detach();
+  else
+    thread_.join();
+}
+
+void Dispatcher::post(clock::time_point due, task_t task) {
+  {
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->pending.push(Pending{due, state_->next_order++, std::move(task)});
+  }
+  state_->cv.notify_one();
+}
+
+void Dispatcher::work(std::shared_ptr<State> state) {
+  std::unique_lock<std::mutex> lock(state->mtx);
+  while (!state->quit) {
+    if (state->pending.empty()) {
+      state->cv.wait(lock);
+      continue;
+    }
+    auto due = state->pending.top().due;
+    if (clock::now() < due) {
+      state->cv.wait_until(lock, due);
+      continue;
+    }
+    auto task = std::move(const_cast<Pending&>(state->pending.top()).task);
+    state->pending.pop();
+    lock.unlock();
+    task();
+    // the task may hold the last reference to the dispatcher
+    task = nullptr;
+    lock.lock();
+  }
+}
+
+}  // namespace signal
+}  // namespace quiddity
+}  // namespace switcher
@@ -0,0 +1,93 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __SWITCHER_SIGNAL_DISPATCHER_H__
+#define __SWITCHER_SIGNAL_DISPATCHER_H__
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace switcher {
+namespace quiddity {
+namespace signal {
+
+/**
+ * Dispatcher runs one-shot tasks at a given time from its own thread. It serves signal
+ * subscriptions that are not delivered immediately, so that notifying threads never run
+ * subscriber code.
+ */
+class Dispatcher {
+ public:
+  using ptr = std::shared_ptr<Dispatcher>;
+  using task_t = std::function<void()>;
+  using clock = std::chrono::steady_clock;
+
+  /**
+   * Get the dispatcher shared by all signals. It is created when needed and destroyed when no
+   * more subscription is using it.
+   */
+  static Dispatcher::ptr get_default();
+
+  Dispatcher();
+  ~Dispatcher();
+  Dispatcher(const Dispatcher&) = delete;
+  Dispatcher& operator=(const Dispatcher&) = delete;
+
+  /**
+   * Run a task from the dispatcher thread. Tasks with the same due time run in posting order.
+   * \param due  Time of the execution.
+   * \param task The function to execute.
+   */
+  void post(clock::time_point due, task_t task);
+
+  bool is_dispatcher_thread() const { return std::this_thread::get_id() == thread_.get_id(); }
+
+ private:
+  struct Pending {
+    clock::time_point due;
+    size_t order;
+    task_t task;
+    bool operator>(const Pending& other) const {
+      return due != other.due ? due > other.due : order > other.order;
+    }
+  };
+  // shared with the thread, which outlives the dispatcher when it releases the last reference
+  struct State {
+    std::mutex mtx{};
+    std::condition_variable cv{};
+    std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>> pending{};
+    size_t next_order{0};
+    bool quit{false};
+  };
+  std::shared_ptr<State> state_{std::make_shared<State>()};
+  std::thread thread_;
+
+  static void work(std::shared_ptr<State> state);
+};
+
+}  // namespace signal
+}  // namespace quiddity
+}  // namespace switcher
+#endif
@@ -54,6 +54,20 @@ register_id_t SBag::subscribe_by_name(const std::string& name, notify_cb_t fun)
   return subscribe(get_id(name), std::forward<notify_cb_t>(fun));
 }
 
+register_id_t SBag::subscribe_with_delivery(sig_id_t id,
+                                            notify_cb_t fun,
+                                            Delivery delivery) const {
+  auto sig = sigs_.find(id);
+  if (sig == sigs_.end()) return 0;
+  return sig->second->subscribe(std::forward<notify_cb_t>(fun), delivery);
+}
+
+register_id_t SBag::subscribe_by_name_with_delivery(const std::string& name,
+                                                    notify_cb_t fun,
+                                                    Delivery delivery) const {
+  return subscribe_with_delivery(get_id(name), std::forward<notify_cb_t>(fun), delivery);
+}
+
 bool SBag::unsubscribe(sig_id_t id, register_id_t rid) const {
   auto sig = sigs_.find(id);
   if (sig == sigs_.end()) return false;
@@ -50,6 +50,12 @@ class SBag {
 
   register_id_t subscribe(sig_id_t id, notify_cb_t fun) const;
   register_id_t subscribe_by_name(const std::string& name, notify_cb_t fun) const;
+  // subscriptions with a delivery policy other than Delivery::immediate are served from the
+  // dispatcher thread
+  register_id_t subscribe_with_delivery(sig_id_t id, notify_cb_t fun, Delivery delivery) const;
+  register_id_t subscribe_by_name_with_delivery(const std::string& name,
+                                                notify_cb_t fun,
+                                                Delivery delivery) const;
   bool unsubscribe(sig_id_t id, register_id_t rid) const;
   bool unsubscribe_by_name(const std::string& name, register_id_t rid) const;
 
@@ -18,24 +18,124 @@
  */
 
 #include "./sig.hpp"
+#include <algorithm>
 
 namespace switcher {
 namespace quiddity {
 namespace signal {
-register_id_t Sig::subscribe(notify_cb_t fun) const {
-  to_notify_[++counter_] = fun;
+
+Queue::Queue(Delivery delivery) : delivery_(delivery) {}
+
+Queue::id_t Queue::add(notify_cb_t fun) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  subscribers_.emplace(++counter_, std::move(fun));
+  return counter_;
+}
+
+void Queue::remove(id_t id, bool wait) {
+  notify_cb_t fun;  // released out of the lock
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto found = subscribers_.find(id);
+    if (subscribers_.end() == found) return;
+    fun = std::move(found->second);
+    subscribers_.erase(found);
+    auto removed = std::remove_if(
+        pending_.begin(), pending_.end(), [&](const Pending& it) { return it.id == id; });
+    if (pending_.end() != removed) {
+      pending_.erase(removed, pending_.end());
+      pending_index_.clear();
+    }
+  }
+  if (!wait || dispatcher_->is_dispatcher_thread()) return;
+  std::lock_guard<std::mutex> delivery_lock(delivery_mtx_);
+}
+
+void Queue::enqueue(id_t id, InfoTree::ptr tree) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  if (subscribers_.end() == subscribers_.find(id)) return;
+  // merging with a notification that precedes one of another subscriber would reorder them
+  if (!pending_.empty() && pending_.back().id != id) pending_index_.clear();
+  if (tree->is_leaf()) {
+    auto key = Any::to_string(tree->read_data());
+    auto found = pending_index_.find(key);
+    if (pending_index_.end() != found) {
+      pending_[found->second].tree = std::move(tree);
+      return;
+    }
+    pending_index_.emplace(std::move(key), pending_.size());
+  }
+  pending_.push_back(Pending{id, std::move(tree)});
+  if (scheduled_) return;
+  scheduled_ = true;
+  auto now = Dispatcher::clock::now();
+  auto due = Delivery::Mode::coalesce == delivery_.mode
+                 ? now + delivery_.period
+                 : std::max(now, last_delivery_ + delivery_.period);
+  dispatcher_->post(due, [weak = weak_from_this()]() {
+    auto self = weak.lock();
+    if (self) self->deliver();
+  });
+}
+
+void Queue::deliver() {
+  std::lock_guard<std::mutex> delivery_lock(delivery_mtx_);
+  std::vector<Pending> pending;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    std::swap(pending, pending_);
+    pending_index_.clear();
+    scheduled_ = false;
+    last_delivery_ = Dispatcher::clock::now();
+  }
+  for (auto& it : pending) {
+    notify_cb_t fun;
+    {
+      // the subscriber may have been removed by a previous invocation
+      std::lock_guard<std::mutex> lock(mtx_);
+      auto found = subscribers_.find(it.id);
+      if (subscribers_.end() == found) continue;
+      fun = found->second;
+    }
+    fun(it.tree);
+  }
+}
+
+Sig::~Sig() {
+  for (auto& it : deferred_) it.second.first->remove(it.second.second, false);
+}
+
+register_id_t Sig::subscribe(notify_cb_t fun, Delivery delivery) const {
+  if (delivery.queue) {
+    auto id = delivery.queue->add(fun);
+    deferred_.emplace(++counter_, std::make_pair(delivery.queue, id));
+  } else if (Delivery::Mode::immediate == delivery.mode) {
+    to_notify_[++counter_] = fun;
+  } else {
+    auto queue = std::make_shared<Queue>(delivery);
+    auto id = queue->add(fun);
+    deferred_.emplace(++counter_, std::make_pair(queue, id));
+  }
   return counter_;
 }
 
 bool Sig::unsubscribe(register_id_t rid) const {
   auto it = to_notify_.find(rid);
-  if (to_notify_.end() == it) return false;
-  to_notify_.erase(it);
+  if (to_notify_.end() != it) {
+    to_notify_.erase(it);
+    return true;
+  }
+  auto deferred = deferred_.find(rid);
+  if (deferred_.end() == deferred) return false;
+  auto subscription = deferred->second;
+  deferred_.erase(deferred);
+  subscription.first->remove(subscription.second);
   return true;
 }
 
 void Sig::notify(InfoTree::ptr tree) const {
   for (auto& it : to_notify_) it.second(tree);
+  for (auto& it : deferred_) it.second.first->enqueue(it.second.second, tree);
 }
 
 }  // namespace signal
@@ -20,8 +20,16 @@
 #ifndef __SWITCHER_SIG_H__
 #define __SWITCHER_SIG_H__
 
+#include <chrono>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "../../infotree/information-tree.hpp"
+#include "./dispatcher.hpp"
 
 namespace switcher {
 namespace quiddity {
@@ -30,17 +38,115 @@ using register_id_t = size_t;
 using notify_cb_t = std::function<void(const InfoTree::ptr&)>;
 using sig_id_t = size_t;
 
+class Queue;
+
+/**
+ * Delivery policy of a subscription. Immediate delivery invokes the subscriber from the
+ * notifying thread. Other policies only enqueue notifications, which are delivered in order from
+ * the dispatcher thread. While pending, notifications with the same leaf value (the path for
+ * the tree signals) are merged into the latest one.
+ */
+struct Delivery {
+  enum class Mode { immediate, coalesce, max_rate };
+  static Delivery immediate() { return Delivery(); }
+  /**
+   * Deliver pending notifications once the window has elapsed since the first of them.
+   */
+  static Delivery coalesce(std::chrono::milliseconds window) {
+    return Delivery{Mode::coalesce, window};
+  }
+  /**
+   * Deliver pending notifications at most rate times per second.
+   */
+  static Delivery max_rate(double rate) {
+    return Delivery{Mode::max_rate,
+                    std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(1 / rate))};
+  }
+  /**
+   * Deliver through a queue shared with other subscriptions, possibly to other signals, following
+   * the policy of the queue. Notifications to these subscriptions are delivered in the order
+   * they were emitted.
+   */
+  static Delivery through(std::shared_ptr<Queue> queue) {
+    Delivery res;
+    res.queue = std::move(queue);
+    return res;
+  }
+
+  Mode mode{Mode::immediate};
+  std::chrono::steady_clock::duration period{0};
+  std::shared_ptr<Queue> queue{};
+};
+
+/**
+ * Queue of deferred notifications, delivered from the dispatcher thread. Pending notifications
+ * are merged only with the ones of the same subscription that directly precede them in the
+ * queue, so that notifications of different subscriptions are never reordered.
+ */
+class Queue : public std::enable_shared_from_this<Queue> {
+ public:
+  using id_t = size_t;
+  /**
+   * Construct a Queue.
+   * \param delivery The delivery policy, either Delivery::coalesce or Delivery::max_rate.
+   */
+  explicit Queue(Delivery delivery);
+  Queue(const Queue&) = delete;
+  Queue& operator=(const Queue&) = delete;
+
+  id_t add(notify_cb_t fun);
+  /**
+   * Remove a subscriber. Its pending notifications are dropped. If a delivery is running, wait
+   * for it to finish, unless wait is false or invoked from the dispatcher thread.
+   */
+  void remove(id_t id, bool wait = true);
+  void enqueue(id_t id, InfoTree::ptr tree);
+
+ private:
+  struct Pending {
+    id_t id;
+    InfoTree::ptr tree;
+  };
+  Delivery delivery_;
+  Dispatcher::ptr dispatcher_{Dispatcher::get_default()};
+  std::mutex mtx_{};
+  id_t counter_{0};
+  std::map<id_t, notify_cb_t> subscribers_{};
+  std::vector<Pending> pending_{};
+  // leaf value to pending_ index, for the subscriber of the last pending notification
+  std::unordered_map<std::string, size_t> pending_index_{};
+  bool scheduled_{false};
+  Dispatcher::clock::time_point last_delivery_{};
+  std::mutex delivery_mtx_{};  //!< Held while subscribers are invoked.
+
+  void deliver();
+};
+
 class Sig {
  public:
   Sig() = default;
+  /**
+   * Destroying a Sig drops the pending deferred notifications, but does not wait for a running
+   * deferred delivery. The destruction may happen from a thread the subscriber needs, such as
+   * one holding the Python GIL.
+   */
+  ~Sig();
+  Sig(const Sig&) = delete;
+  Sig& operator=(const Sig&) = delete;
 
-  register_id_t subscribe(notify_cb_t fun) const;
+  register_id_t subscribe(notify_cb_t fun, Delivery delivery = Delivery()) const;
+  /**
+   * Remove a subscription. If a deferred delivery to this subscription is running, wait for it
+   * to finish, unless invoked from the dispatcher thread.
+   */
   bool unsubscribe(register_id_t rid) const;
   void notify(InfoTree::ptr tree) const;
 
  private:
   mutable register_id_t counter_{0};
   mutable std::map<register_id_t, notify_cb_t> to_notify_{};
+  mutable std::map<register_id_t, std::pair<std::shared_ptr<Queue>, Queue::id_t>> deferred_{};
 };
 
 }  // namespace signal
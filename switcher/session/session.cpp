@@ -23,12 +23,18 @@
 #include <fstream>
 #include "./session.hpp"
 #include "../switcher.hpp"
+#include "../infotree/msgpack-serializer.hpp"
 #include "../utils/file-utils.hpp"
 
 namespace fs = std::filesystem;
 
 namespace switcher::session {
 
+namespace {
+const fs::path kJsonExtension(".json");
+const fs::path kMsgpackExtension(".msgpack");
+}  // namespace
+
 Session::Session(Switcher* instance) : switcher_(instance) {
   // retrieve current configuration tree
   auto config_tree = this->switcher_->conf<&Configuration::get>();
@@ -50,9 +56,14 @@ Session::Session(Switcher* instance) : switcher_(instance) {
     // retrieve switcher current state
     auto state = this->switcher_->get_state();
     // compute filepath relative to basedir
-    fs::path fname = filename, fpath = this->basedir_ / fname.filename();
-    // check for json extension
-    if (fpath.extension() != ".json") fpath.replace_extension(fs::path(".json"));
+    fs::path fpath = get_path(filename);
+    if (fpath.extension() == kMsgpackExtension) {
+      // write binary content to file at `fpath`
+      std::ofstream ofs(fpath.c_str(), std::ios::binary);
+      ofs << infotree::msgpack::serialize(state.get());
+      ofs.close();
+      return fpath;
+    }
     // retrieve current switcher configuration json string
     const std::string serialized = infotree::json::serialize(state.get());
     // write json content to file at `fpath`
@@ -64,16 +75,20 @@ Session::Session(Switcher* instance) : switcher_(instance) {
   };
   
   bool Session::copy(const std::string& src, const std::string& dst) {
-    fs::path a = this->basedir_ / fs::path(src).filename(),
-             b = this->basedir_ / fs::path(dst).filename();
-    // check for json extensions
-    if (a.extension() != ".json") a.replace_extension(fs::path(".json"));
-    if (b.extension() != ".json") b.replace_extension(fs::path(".json"));
+    fs::path a = get_path(src), b = get_path(dst);
     // check for path existence
     if (!fs::exists(a)) return false;
+    // a session file is not converted from a format to the other
+    if (a.extension() != b.extension()) return false;
     // read file content
     const std::string content = fileutils::get_content(a);
     // write content to destination file
+    if (a.extension() == kMsgpackExtension) {
+      std::ofstream ofs(b, std::ios::binary);
+      ofs << content;
+      ofs.close();
+      return true;
+    }
     std::ofstream ofs(b);
     ofs << content << "\n";
     ofs.close();
@@ -96,21 +111,21 @@ Session::Session(Switcher* instance) : switcher_(instance) {
 
   bool Session::load(const std::string& filename) {
     // compute file path
-    fs::path fpath = this->basedir_ / fs::path(filename).filename();
-    if (fpath.extension() != ".json") fpath.replace_extension(fs::path(".json"));
+    fs::path fpath = get_path(filename);
     // check for path existence
     if (!fs::exists(fpath)) return false;
     // read file content
     const std::string content = fileutils::get_content(fpath);
     // parse the session file content and set switcher state
     switcher_->sw_debug("loading state from session file {}", fpath.string());
+    if (fpath.extension() == kMsgpackExtension)
+      return this->switcher_->load_state(infotree::msgpack::deserialize(content).get());
     return this->switcher_->load_state(infotree::json::deserialize(content).get());
   };
 
   const std::string Session::read(const std::string& filename) {
     // compute file path
-    fs::path fpath = this->basedir_ / fs::path(filename).filename();
-    if (fpath.extension() != ".json") fpath.replace_extension(fs::path(".json"));
+    fs::path fpath = get_path(filename);
     // check for path existence, return empty content for inexistant file
     if (!fs::exists(fpath)) {
       switcher_->sw_warning("session file {} was not found", fpath.string());
@@ -125,12 +140,23 @@ Session::Session(Switcher* instance) : switcher_(instance) {
 
   bool Session::write(const std::string& content, const std::string& filename) {
     // compute file path
-    fs::path fpath = this->basedir_ / fs::path(filename).filename();
-    if (fpath.extension() != ".json") fpath.replace_extension(fs::path(".json"));
+    fs::path fpath = get_path(filename);
 
     // write file content
     switcher_->sw_debug("writing content to session file {}", fpath.string());
     return fileutils::save(content, fpath);
   };
 
+  bool Session::is_msgpack(const std::string& filename) {
+    return fs::path(filename).extension() == kMsgpackExtension;
+  };
+
+  fs::path Session::get_path(const std::string& filename) const {
+    fs::path fpath = this->basedir_ / fs::path(filename).filename();
+    // check for json extension, unless binary
+    if (fpath.extension() != kJsonExtension && fpath.extension() != kMsgpackExtension)
+      fpath.replace_extension(kJsonExtension);
+    return fpath;
+  };
+
 };  // namespace switcher::session
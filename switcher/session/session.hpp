@@ -78,6 +78,10 @@ namespace switcher {
     /**
      * @brief Write Switcher's current state in a new file
      *
+     *        The state is saved as JSON, unless the file name has the
+     *        `.msgpack` extension, in which case the binary MessagePack
+     *        encoding is used. Binary session files are faster to load.
+     *
      * @param filename The name for the newly created file
      *
      * @return An absolute path to the saved session file
@@ -140,6 +144,15 @@ namespace switcher {
      */
     bool write(const std::string& content, const std::string& filename);
 
+    /**
+     * @brief Test if a session file uses the binary MessagePack encoding
+     *
+     * @param filename The name of the session file
+     *
+     * @return True if the file name has the `.msgpack` extension
+     */
+    static bool is_msgpack(const std::string& filename);
+
    private:
     /**
      * @brief An absolute path to the `session base directory` under which
@@ -156,6 +169,12 @@ namespace switcher {
      */
     Switcher* switcher_;
 
+    /**
+     * @brief Compute the path of a session file in the session base directory,
+     *        with the `.json` extension unless it has the `.msgpack` one.
+     */
+    fs::path get_path(const std::string& filename) const;
+
   };  // class Session
   }; // namesepace session
 }; // namesepace switcher
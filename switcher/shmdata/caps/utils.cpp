@@ -20,6 +20,7 @@
 #include "./utils.hpp"
 
 #include <algorithm>
+#include <any>
 #include <shmdata/type.hpp>
 
 namespace switcher {
@@ -66,6 +67,44 @@ std::string get_switcher_name(const std::string& caps) {
   return std::any_cast<std::string>(name);
 }
 
+namespace {
+size_t round_up(size_t value, size_t multiple) {
+  return (value + multiple - 1) / multiple * multiple;
+}
+}  // namespace
+
+size_t get_raw_video_frame_size(const std::string& caps) {
+  if (0 != caps.find("video/x-raw")) return 0;
+  ::shmdata::Type type(caps);
+  auto width = type.get("width");
+  auto height = type.get("height");
+  if (!width.has_value() || width.type() != typeid(int) || !height.has_value() ||
+      height.type() != typeid(int))
+    return 0;
+  auto format = type.get("format");
+  std::string fmt = format.has_value() && format.type() == typeid(std::string)
+                        ? std::any_cast<std::string>(format)
+                        : std::string();
+  const size_t w = std::max(0, std::any_cast<int>(width));
+  const size_t h = std::max(0, std::any_cast<int>(height));
+  // line strides and plane heights as laid out by GStreamer, rows being padded to 4 bytes and
+  // subsampled planes of odd sizes being rounded up
+  if (fmt == "GRAY8") return round_up(w, 4) * h;
+  if (fmt == "I420" || fmt == "YV12")
+    return round_up(w, 4) * round_up(h, 2) +
+           2 * round_up(round_up(w, 2) / 2, 4) * (round_up(h, 2) / 2);
+  if (fmt == "NV12" || fmt == "NV21") return round_up(w, 4) * (round_up(h, 2) + round_up(h, 2) / 2);
+  if (fmt == "Y42B") return (round_up(w, 4) + round_up(w, 8)) * h;
+  if (fmt == "NV16") return 2 * round_up(w, 4) * h;
+  if (fmt == "Y444") return 3 * round_up(w, 4) * h;
+  if (fmt == "YUY2" || fmt == "UYVY" || fmt == "YVYU") return round_up(round_up(w, 2) * 2, 4) * h;
+  if (fmt == "RGB16" || fmt == "BGR16" || fmt == "GRAY16_LE" || fmt == "GRAY16_BE")
+    return round_up(w * 2, 4) * h;
+  if (fmt == "RGB" || fmt == "BGR" || fmt == "v308") return round_up(w * 3, 4) * h;
+  // 4 bytes per pixel, the largest common size, for other formats
+  return w * h * 4;
+}
+
 }  // namespace caps
 }  // namespace shmdata
 }  // namespace switcher
@@ -20,6 +20,7 @@
 #ifndef __SWITCHER_SHMDATA_CAPS_H__
 #define __SWITCHER_SHMDATA_CAPS_H__
 
+#include <cstddef>
 #include <string>
 
 #include "switcher/quiddity/quid-id-t.hpp"
@@ -34,6 +35,13 @@ switcher::quiddity::qid_t get_quiddity_id(const std::string& caps);
 
 std::string get_switcher_name(const std::string& caps);
 
+/**
+ * Get the size of a frame described by raw video caps.
+ * \param caps The caps.
+ * \return The frame size in bytes, 0 if caps are not raw video or if the size is unknown.
+ */
+size_t get_raw_video_frame_size(const std::string& caps);
+
 }  // namespace caps
 }  // namespace shmdata
 }  // namespace switcher
@@ -0,0 +1,259 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include "./follower-hub.hpp"
+#include <atomic>
+#include <map>
+#include <shmdata/follower.hpp>
+#include <thread>
+#include <vector>
+#include "../utils/threaded-wrapper.hpp"
+#include "./switcher-logger.hpp"
+
+namespace switcher {
+namespace shmdata {
+
+struct FollowerHub::Source {
+  struct Subscriber {
+    Subscriber(::shmdata::Reader::onData data,
+               ::shmdata::Reader::onServerConnected connected,
+               ::shmdata::Reader::onServerDisconnected disconnected);
+    template <typename F>
+    void invoke(const F& fun);
+
+    ::shmdata::Reader::onData od;
+    ::shmdata::Reader::onServerConnected osc;
+    ::shmdata::Reader::onServerDisconnected osd;
+    std::atomic<bool> removed{false};
+    std::atomic<size_t> queued{0};  //!< Tasks posted to the worker and not done yet.
+    bool dropping{false};           //!< Only accessed with the source mtx locked.
+    // held during callbacks, recursive since subscribers may unsubscribe from their callbacks
+    std::recursive_mutex invoke_mtx{};
+    std::thread::id worker_id{};
+    // last member, its pending tasks are executed before other members are destroyed
+    std::unique_ptr<ThreadedWrapper<>> worker{std::make_unique<ThreadedWrapper<>>()};
+  };
+  using recipients_t = std::vector<std::shared_ptr<Subscriber>>;
+
+  // buffers queued for a subscriber beyond this number are dropped for it
+  static constexpr size_t kMaxQueuedBuffers = 4;
+
+  Source(const std::string& shmpath, const logger::Logger& log);
+  // the follower thread is stopped before the workers, which deliver pending events
+  ~Source() {
+    follower.reset();
+    retired.clear();
+  }
+
+  void on_data(void* data, size_t size);
+  void on_server_connected(const std::string& type);
+  void on_server_disconnected();
+  // queue the invocation of fun for subscriber, to be called with mtx locked
+  template <typename F>
+  void post(Subscriber* subscriber, F fun);
+  void erase(size_t id);
+
+  const std::string path;
+  logger::Logger logger;
+  SwitcherLogger shmlogger{&logger};
+  std::mutex mtx{};
+  std::map<size_t, std::shared_ptr<Subscriber>> subscribers{};
+  // removed from their own worker thread, which cannot be joined from there
+  recipients_t retired{};
+  size_t next_id{0};
+  std::string data_type{};  //!< Empty when the writer is not connected.
+  std::unique_ptr<::shmdata::Follower> follower{};
+};
+
+FollowerHub::Source::Subscriber::Subscriber(::shmdata::Reader::onData data,
+                                            ::shmdata::Reader::onServerConnected connected,
+                                            ::shmdata::Reader::onServerDisconnected disconnected)
+    : od(std::move(data)), osc(std::move(connected)), osd(std::move(disconnected)) {
+  worker->run([this]() { worker_id = std::this_thread::get_id(); });
+}
+
+template <typename F>
+void FollowerHub::Source::Subscriber::invoke(const F& fun) {
+  std::lock_guard<std::recursive_mutex> lock(invoke_mtx);
+  if (!removed) fun(*this);
+}
+
+FollowerHub::Source::Source(const std::string& shmpath, const logger::Logger& log)
+    : path(shmpath), logger(log) {
+  follower = std::make_unique<::shmdata::Follower>(
+      path,
+      [this](void* data, size_t size) { on_data(data, size); },
+      [this](const std::string& type) { on_server_connected(type); },
+      [this]() { on_server_disconnected(); },
+      &shmlogger);
+}
+
+void FollowerHub::Source::on_data(void* data, size_t size) {
+  std::unique_lock<std::mutex> lock(mtx);
+  recipients_t recipients;
+  for (const auto& it : subscribers)
+    if (it.second->od) recipients.push_back(it.second);
+  if (recipients.empty()) return;
+  // a single idle subscriber reads in place, as with a ::shmdata::Follower
+  if (1 == recipients.size() && 0 == recipients.front()->queued) {
+    lock.unlock();
+    recipients.front()->invoke([&](Subscriber& it) { it.od(data, size); });
+    return;
+  }
+  // otherwise one copy is shared by the workers and the writer does not wait for them
+  std::shared_ptr<const std::vector<char>> copy;
+  for (const auto& it : recipients) {
+    if (it->queued >= kMaxQueuedBuffers) {
+      if (!it->dropping)
+        logger.sw_debug("{}: subscriber late by {} buffers, dropping", path, kMaxQueuedBuffers);
+      it->dropping = true;
+      continue;
+    }
+    it->dropping = false;
+    if (!copy)
+      copy = std::make_shared<const std::vector<char>>(static_cast<char*>(data),
+                                                       static_cast<char*>(data) + size);
+    post(it.get(), [copy](Subscriber& sub) {
+      sub.od(const_cast<char*>(copy->data()), copy->size());
+    });
+  }
+}
+
+void FollowerHub::Source::on_server_connected(const std::string& type) {
+  std::lock_guard<std::mutex> lock(mtx);
+  data_type = type;
+  for (const auto& it : subscribers)
+    if (it.second->osc) post(it.second.get(), [type](Subscriber& sub) { sub.osc(type); });
+}
+
+void FollowerHub::Source::on_server_disconnected() {
+  std::lock_guard<std::mutex> lock(mtx);
+  data_type.clear();
+  for (const auto& it : subscribers)
+    if (it.second->osd) post(it.second.get(), [](Subscriber& sub) { sub.osd(); });
+}
+
+template <typename F>
+void FollowerHub::Source::post(Subscriber* subscriber, F fun) {
+  // the subscriber outlives its worker, which executes pending tasks when destroyed
+  ++subscriber->queued;
+  subscriber->worker->run_async([subscriber, fun = std::move(fun)]() {
+    subscriber->invoke(fun);
+    --subscriber->queued;
+  });
+}
+
+void FollowerHub::Source::erase(size_t id) {
+  std::shared_ptr<Subscriber> subscriber;
+  recipients_t retiring;
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto found = subscribers.find(id);
+    if (subscribers.end() == found) return;
+    subscriber = found->second;
+    subscribers.erase(found);
+    retiring.swap(retired);
+  }
+  subscriber->removed = true;
+  {
+    // wait for a callback in progress, unless invoked from a callback
+    std::lock_guard<std::recursive_mutex> lock(subscriber->invoke_mtx);
+  }
+  retiring.push_back(std::move(subscriber));
+  // workers are joined out of the lock, except from their own thread
+  recipients_t kept;
+  for (auto& it : retiring) {
+    if (std::this_thread::get_id() == it->worker_id) kept.push_back(std::move(it));
+  }
+  retiring.clear();
+  if (kept.empty()) return;
+  std::lock_guard<std::mutex> lock(mtx);
+  for (auto& it : kept) retired.push_back(std::move(it));
+}
+
+FollowerHub::Subscription::Subscription(FollowerHub::ptr hub,
+                                        std::shared_ptr<Source> source,
+                                        size_t id)
+    : hub_(std::move(hub)), source_(std::move(source)), id_(id) {}
+
+FollowerHub::Subscription::~Subscription() {
+  source_->erase(id_);
+  auto path = source_->path;
+  // releasing the last subscription stops the follower, out of the hub lock
+  source_.reset();
+  hub_->forget(path);
+}
+
+FollowerHub::ptr FollowerHub::get_default() {
+  static std::mutex mtx;
+  static std::weak_ptr<FollowerHub> hub;
+  std::lock_guard<std::mutex> lock(mtx);
+  auto res = hub.lock();
+  if (res) return res;
+  res = std::make_shared<FollowerHub>();
+  hub = res;
+  return res;
+}
+
+std::unique_ptr<FollowerHub::Subscription> FollowerHub::subscribe(
+    const std::string& path,
+    const logger::Logger& logger,
+    ::shmdata::Reader::onData od,
+    ::shmdata::Reader::onServerConnected osc,
+    ::shmdata::Reader::onServerDisconnected osd) {
+  std::shared_ptr<Source> source;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto& followed = sources_[path];
+    source = followed.lock();
+    if (!source) {
+      source = std::make_shared<Source>(path, logger);
+      followed = source;
+    }
+  }
+  auto subscriber =
+      std::make_shared<Source::Subscriber>(std::move(od), std::move(osc), std::move(osd));
+  std::lock_guard<std::mutex> lock(source->mtx);
+  auto id = source->next_id++;
+  source->subscribers.emplace(id, subscriber);
+  // the writer was connected before this subscription
+  if (subscriber->osc && !source->data_type.empty()) {
+    source->post(subscriber.get(),
+                 [type = source->data_type](Source::Subscriber& it) { it.osc(type); });
+  }
+  return std::unique_ptr<Subscription>(new Subscription(shared_from_this(), source, id));
+}
+
+size_t FollowerHub::get_num_followed() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  size_t res = 0;
+  for (const auto& it : sources_)
+    if (!it.second.expired()) ++res;
+  return res;
+}
+
+void FollowerHub::forget(const std::string& path) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto found = sources_.find(path);
+  // a new source may have been created for the path meanwhile
+  if (sources_.end() != found && found->second.expired()) sources_.erase(found);
+}
+
+}  // namespace shmdata
+}  // namespace switcher
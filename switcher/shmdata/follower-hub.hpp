@@ -0,0 +1,115 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __SWITCHER_SHMDATA_FOLLOWER_HUB_H__
+#define __SWITCHER_SHMDATA_FOLLOWER_HUB_H__
+
+#include <memory>
+#include <mutex>
+#include <shmdata/reader.hpp>
+#include <string>
+#include <unordered_map>
+
+#include "../logger/logger.hpp"
+
+namespace switcher {
+namespace shmdata {
+
+/**
+ * FollowerHub shares one ::shmdata::Follower between all the in-process subscribers of a
+ * shmpath, so that several quiddities tapping the same source do not each own a socket
+ * connection and a wake up per buffer. The follower is started with the first subscription
+ * and stopped with the last one.
+ *
+ * The callbacks of a subscription are invoked one at a time, in the order of the events. When a
+ * single subscriber receives buffers and has nothing pending, it reads them in place from the
+ * follower thread, as with a ::shmdata::Follower. Otherwise the buffer is copied once and the
+ * copy is shared by the subscribers, each processing it from its own worker thread: the writer
+ * waits for the copy only, and subscribers do not wait for each other. A subscriber late by
+ * more than a few buffers misses the next ones until it catches up, which bounds the memory
+ * used by copies.
+ */
+class FollowerHub : public std::enable_shared_from_this<FollowerHub> {
+ private:
+  struct Source;
+
+ public:
+  using ptr = std::shared_ptr<FollowerHub>;
+
+  /**
+   * Get the hub shared by all Follower instances of the process. It is created when needed and
+   * destroyed with the last subscription.
+   */
+  static FollowerHub::ptr get_default();
+
+  /**
+   * A subscription to a shmpath. Its callbacks are not invoked anymore once it is destroyed.
+   * As with a ::shmdata::Follower, the last subscription of a shmpath must not be destroyed
+   * from its own callbacks.
+   */
+  class Subscription {
+   public:
+    ~Subscription();
+    Subscription(const Subscription&) = delete;
+    Subscription& operator=(const Subscription&) = delete;
+
+   private:
+    friend class FollowerHub;
+    FollowerHub::ptr hub_;
+    std::shared_ptr<Source> source_;
+    size_t id_;
+    Subscription(FollowerHub::ptr hub, std::shared_ptr<Source> source, size_t id);
+  };
+
+  FollowerHub() = default;
+  FollowerHub(const FollowerHub&) = delete;
+  FollowerHub& operator=(const FollowerHub&) = delete;
+
+  /**
+   * Subscribe to a shmpath. If the shmpath is already followed and connected, the server
+   * connected callback is invoked afterward from the worker thread, as for other events.
+   * \param path   The shmpath to follow.
+   * \param logger Logger of the follower, if the shmpath is not already followed.
+   * \param od     Invoked for each buffer, the data is valid during the invocation only and
+   *               must not be modified, since it may be shared with other subscribers.
+   * \param osc    Invoked when the writer is connected, with its data type.
+   * \param osd    Invoked when the writer is disconnected.
+   * \return The subscription.
+   */
+  std::unique_ptr<Subscription> subscribe(const std::string& path,
+                                          const logger::Logger& logger,
+                                          ::shmdata::Reader::onData od,
+                                          ::shmdata::Reader::onServerConnected osc,
+                                          ::shmdata::Reader::onServerDisconnected osd);
+
+  /**
+   * Get the number of shmpaths currently followed, i.e. the number of ::shmdata::Follower.
+   */
+  size_t get_num_followed() const;
+
+ private:
+  mutable std::mutex mtx_{};
+  std::unordered_map<std::string, std::weak_ptr<Source>> sources_{};
+
+  void forget(const std::string& path);
+};
+
+}  // namespace shmdata
+}  // namespace switcher
+#endif
@@ -32,37 +32,34 @@ Follower::Follower(quiddity::Quiddity* quid,
                    Direction dir,
                    bool get_shmdata_on_connect)
     : quid_(quid),
-      shmlogger_(quid),
       od_(od),
       osc_(osc),
       osd_(osd),
       tree_path_(dir == Direction::reader ? ".shmdata.reader." + path : ".shmdata.writer." + path),
       dir_(dir),
       get_shmdata_on_connect_(get_shmdata_on_connect),
-      follower_(std::make_unique<::shmdata::Follower>(
-          path,
-          [this](void* data, size_t size) { this->on_data(data, size); },
-          [this](const std::string& data_type) { this->on_server_connected(data_type); },
-          [this]() { this->on_server_disconnected(); },
-          &shmlogger_)),
       task_(std::make_unique<PeriodicTask<>>([this]() { this->update_quid_stats(); },
                                              update_interval)) {
   // adding default informations for this shmdata
   if (!get_shmdata_on_connect_) {
     initialize_tree(tree_path_);
   }
+  // last, callbacks may be invoked from the hub threads as soon as subscribed
+  subscription_ = FollowerHub::get_default()->subscribe(
+      path,
+      *quid,
+      [this](void* data, size_t size) { this->on_data(data, size); },
+      [this](const std::string& data_type) { this->on_server_connected(data_type); },
+      [this]() { this->on_server_disconnected(); });
 }
 
 Follower::~Follower() {
-  follower_.reset(nullptr);
+  subscription_.reset(nullptr);
   if (!data_type_.empty()) quid_->prune_tree(tree_path_);
 }
 
 void Follower::on_data(void* data, size_t size) {
-  {
-    std::unique_lock<std::mutex> lock(bytes_mutex_);
-    shm_stat_.count_buffer(size);
-  }
+  shm_stat_.count_buffer(size);
   if (!od_) return;
   od_(data, size);
 }
@@ -87,9 +84,8 @@ void Follower::on_server_disconnected() {
 }
 
 void Follower::update_quid_stats() {
-  std::unique_lock<std::mutex> lock(bytes_mutex_);
-  Stat::make_tree_updater(quid_, tree_path_, (dir_ == Direction::writer ? true : false))(shm_stat_);
-  shm_stat_.reset();
+  Stat::make_tree_updater(
+      quid_, tree_path_, (dir_ == Direction::writer ? true : false))(shm_stat_.collect());
 }
 
 void Follower::initialize_tree(const std::string& tree_path) {
@@ -27,12 +27,18 @@
 #include <string>
 
 #include "../utils/periodic-task.hpp"
+#include "./follower-hub.hpp"
 #include "./stat.hpp"
 #include "./switcher-logger.hpp"
 
 namespace switcher {
 namespace shmdata {
 
+/**
+ * Follower reads a shmdata on behalf of a quiddity and maintains its information in the
+ * quiddity tree. Followers of the same shmpath in the process share the reading through the
+ * default FollowerHub.
+ */
 class Follower {
  public:
   enum class Direction { writer, reader };
@@ -51,10 +57,8 @@ class Follower {
  private:
   quiddity::Quiddity* quid_;
   // shmdata stats
-  Stat shm_stat_{};
-  std::mutex bytes_mutex_{};
+  StatCounter shm_stat_{};
   // shmdata follower related members:
-  SwitcherLogger shmlogger_;
   std::string data_type_{};
   ::shmdata::Reader::onData od_;
   ::shmdata::Reader::onServerConnected osc_;
@@ -62,7 +66,7 @@ class Follower {
   std::string tree_path_;
   Direction dir_;
   bool get_shmdata_on_connect_{false};
-  std::unique_ptr<::shmdata::Follower> follower_;
+  std::unique_ptr<FollowerHub::Subscription> subscription_;
   std::unique_ptr<PeriodicTask<>> task_;
 
   void on_data(void* data, size_t data_size);
@@ -18,6 +18,7 @@
  */
 
 #include "./stat.hpp"
+#include <cstdlib>
 
 namespace switcher {
 namespace shmdata {
@@ -27,42 +28,90 @@ namespace shmdata {
 const std::chrono::milliseconds Stat::kDefaultUpdateInterval =
     std::chrono::milliseconds(3000);
 
-void Stat::count_buffer(size_t buffer_size) {
-  bytes_ += buffer_size;
-  ++accesses_;
-}
-
-void Stat::reset() {
-  bytes_ = 0;
-  accesses_ = 0;
-}
-
 std::function<void(const Stat&)> Stat::make_tree_updater(quiddity::Quiddity* quid,
                                                                        const std::string& key,
                                                                        bool do_signal) {
   return [quid, key, do_signal](const Stat& stat) {
     auto tree = InfoTree::make();
-    tree->graft(
-        ".byte_rate",
-        InfoTree::make(stat.bytes_ /
-                       std::chrono::duration<float>(Stat::kDefaultUpdateInterval).count()));
-    tree->graft(
-        ".rate",
-        InfoTree::make(stat.accesses_ /
-                       std::chrono::duration<float>(Stat::kDefaultUpdateInterval).count()));
+    stat.graft_values(tree.get(), std::string());
     quid->graft_tree(key + ".stat", tree, do_signal);
   };
 }
 
 void Stat::update_tree(const InfoTree::ptr& tree, const std::string& key) const {
-  tree->graft(
-      key + ".stat.byte_rate",
-      InfoTree::make(bytes_ /
-                     std::chrono::duration<float>(Stat::kDefaultUpdateInterval).count()));
-  tree->graft(
-      key + ".stat.rate",
-      InfoTree::make(accesses_ /
-                     std::chrono::duration<float>(Stat::kDefaultUpdateInterval).count()));
+  graft_values(tree.get(), key + ".stat");
+}
+
+void Stat::graft_values(InfoTree* tree, const std::string& prefix) const {
+  const auto interval = std::chrono::duration<float>(Stat::kDefaultUpdateInterval).count();
+  const auto to_ms = [](std::chrono::microseconds dur) {
+    return std::chrono::duration<float, std::milli>(dur).count();
+  };
+  tree->graft(prefix + ".byte_rate", InfoTree::make(bytes_ / interval));
+  tree->graft(prefix + ".rate", InfoTree::make(accesses_ / interval));
+  // unknown values are omitted rather than published as 0
+  if (!measured_) return;
+  tree->graft(prefix + ".max_gap_ms", InfoTree::make(to_ms(max_gap_)));
+  tree->graft(prefix + ".jitter_ms", InfoTree::make(to_ms(jitter_)));
+  tree->graft(prefix + ".gap_p50_ms", InfoTree::make(to_ms(gap_p50_)));
+  tree->graft(prefix + ".gap_p99_ms", InfoTree::make(to_ms(gap_p99_)));
+  tree->graft(prefix + ".size_p50", InfoTree::make(size_p50_));
+  tree->graft(prefix + ".size_p99", InfoTree::make(size_p99_));
+  tree->graft(prefix + ".size_max", InfoTree::make(size_max_));
+}
+
+void StatCounter::count_buffer(size_t buffer_size) {
+  const int64_t now =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch())
+          .count();
+  bytes_.fetch_add(buffer_size, std::memory_order_relaxed);
+  accesses_.fetch_add(1, std::memory_order_relaxed);
+  sizes_.record(buffer_size);
+  const auto previous = last_arrival_.exchange(now, std::memory_order_relaxed);
+  if (0 == previous) return;
+  const auto gap = now - previous;
+  gaps_.record(static_cast<uint64_t>(gap / 1000));
+  auto max = max_gap_.load(std::memory_order_relaxed);
+  while (gap > max && !max_gap_.compare_exchange_weak(max, gap, std::memory_order_relaxed)) {
+  }
+  const auto previous_gap = last_gap_.exchange(gap, std::memory_order_relaxed);
+  if (previous_gap < 0) return;
+  gap_variations_.fetch_add(static_cast<uint64_t>(std::llabs(gap - previous_gap)),
+                            std::memory_order_relaxed);
+  num_gap_variations_.fetch_add(1, std::memory_order_relaxed);
+}
+
+Stat StatCounter::collect() {
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  using std::chrono::nanoseconds;
+  Stat res;
+  res.measured_ = true;
+  res.bytes_ = bytes_.exchange(0, std::memory_order_relaxed);
+  res.accesses_ = accesses_.exchange(0, std::memory_order_relaxed);
+
+  // a stall is reported while it is happening, not only when the next buffer arrives
+  int64_t max_gap = max_gap_.exchange(0, std::memory_order_relaxed);
+  const auto last = last_arrival_.load(std::memory_order_relaxed);
+  if (0 != last) {
+    const auto now = duration_cast<nanoseconds>(clock::now().time_since_epoch()).count();
+    if (now - last > max_gap) max_gap = now - last;
+  }
+  res.max_gap_ = duration_cast<microseconds>(nanoseconds(max_gap));
+
+  const auto variations = gap_variations_.exchange(0, std::memory_order_relaxed);
+  const auto num_variations = num_gap_variations_.exchange(0, std::memory_order_relaxed);
+  if (0 != num_variations)
+    res.jitter_ = duration_cast<microseconds>(nanoseconds(variations / num_variations));
+
+  const auto gaps = gaps_.take();
+  res.gap_p50_ = microseconds(gaps.value_at(50));
+  res.gap_p99_ = microseconds(gaps.value_at(99));
+  const auto sizes = sizes_.take();
+  res.size_p50_ = sizes.value_at(50);
+  res.size_p99_ = sizes.value_at(99);
+  res.size_max_ = sizes.max();
+  return res;
 }
 
 }  // namespace shmdata
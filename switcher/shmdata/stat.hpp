@@ -20,22 +20,69 @@
 #ifndef __SWITCHER_SHMDATA_STAT_H__
 #define __SWITCHER_SHMDATA_STAT_H__
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include "../quiddity/quiddity.hpp"
+#include "../utils/histogram.hpp"
 
 namespace switcher {
 namespace shmdata {
+/**
+ * Statistics of a shmdata over an update interval. Timing and size distribution are only
+ * available when collected with a StatCounter, they are not published otherwise.
+ */
 struct Stat {
   static const std::chrono::milliseconds kDefaultUpdateInterval;
 
   size_t bytes_{0};
   size_t accesses_{0};
-  void count_buffer(size_t buffer_size);
-  void reset();
+  std::chrono::microseconds max_gap_{0};  //!< Longest time without buffer, including ongoing.
+  std::chrono::microseconds jitter_{0};   //!< Mean difference between successive gaps.
+  std::chrono::microseconds gap_p50_{0};
+  std::chrono::microseconds gap_p99_{0};
+  size_t size_p50_{0};
+  size_t size_p99_{0};
+  size_t size_max_{0};
+  bool measured_{false};  //!< Timing and size distribution are set.
   void update_tree(const InfoTree::ptr& tree, const std::string& key) const;
   static std::function<void(const Stat&)> make_tree_updater(quiddity::Quiddity* quid,
                                                                    const std::string& key,
                                                                    bool do_signal = true);
+
+ private:
+  void graft_values(InfoTree* tree, const std::string& prefix) const;
+};
+
+/**
+ * Count buffers from the shmdata thread, and collect a Stat from another thread. Counting is
+ * lock-free.
+ */
+class StatCounter {
+ public:
+  /**
+   * Count a buffer, timestamped with its arrival.
+   * \param buffer_size Size of the buffer.
+   */
+  void count_buffer(size_t buffer_size);
+
+  /**
+   * Get the statistics since the previous collection.
+   * \return The statistics.
+   */
+  Stat collect();
+
+ private:
+  using clock = std::chrono::steady_clock;
+  std::atomic<size_t> bytes_{0};
+  std::atomic<size_t> accesses_{0};
+  std::atomic<int64_t> last_arrival_{0};  //!< Nanoseconds in the clock epoch, 0 if none yet.
+  std::atomic<int64_t> last_gap_{-1};     //!< Nanoseconds, negative if none yet.
+  std::atomic<uint64_t> gap_variations_{0};
+  std::atomic<uint64_t> num_gap_variations_{0};
+  std::atomic<int64_t> max_gap_{0};
+  Histogram gaps_{};   //!< Microseconds.
+  Histogram sizes_{};  //!< Bytes.
 };
 
 }  // namespace shmdata
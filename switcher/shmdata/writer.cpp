@@ -18,11 +18,19 @@
  */
 
 #include "./writer.hpp"
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include "./caps/utils.hpp"
 
 namespace switcher {
 namespace shmdata {
 
+const size_t Writer::kHeadroomDivisor = 4;
+const size_t Writer::kHugePageSize = 2 * 1024 * 1024;
+
 Writer::Writer(quiddity::Quiddity* quid,
                const std::string& path,
                size_t memsize,
@@ -31,10 +39,19 @@ Writer::Writer(quiddity::Quiddity* quid,
       shmpath_(path),
       data_type_(data_descr),
       shmlog_(quid),
-      shm_(shmpath_, memsize, data_type_, &shmlog_),
+      huge_pages_(nullptr != quid_ && quid_->get_shm_huge_pages()),
+      // placeholder sizes are replaced by the frame size when known from the caps
+      shm_(shmpath_,
+           get_alloc_size(std::max(memsize, caps::get_raw_video_frame_size(data_type_))),
+           data_type_,
+           &shmlog_),
       task_(shm_ ? std::make_unique<PeriodicTask<>>([this]() { this->update_quid_stats(); },
                                                     Stat::kDefaultUpdateInterval)
                  : nullptr) {
+  if (shm_) {
+    alloc_size_ = shm_.alloc_size();
+    if (huge_pages_) advise_huge_pages(shm_.get_one_write_access()->get_mem());
+  }
   if (shm_ && nullptr != quid_) {
     auto parent_path = ".shmdata.writer." + shmpath_;
     auto tree = quid_->prune_tree(parent_path, false);
@@ -51,6 +68,8 @@ Writer::Writer(quiddity::Quiddity* quid,
     quid_->graft_tree(parent_path + ".caps", InfoTree::make(caps), false);
     quid_->graft_tree(
         parent_path + ".category", InfoTree::make(caps::get_category(caps)), false);
+    quid_->graft_tree(parent_path + ".stat.alloc_size", InfoTree::make(alloc_size_.load()), false);
+    quid_->graft_tree(parent_path + ".stat.reallocations", InfoTree::make(size_t(0)), false);
     quid_->notify_tree_updated(parent_path);
   }
 }
@@ -59,19 +78,71 @@ Writer::~Writer() {
   if (shm_ && nullptr != quid_) quid_->prune_tree(std::string(".shmdata.writer.") + shmpath_);
 }
 
+Writer::Reservation::Reservation(Writer* writer,
+                                 std::unique_ptr<::shmdata::OneWriteAccess> access,
+                                 size_t size)
+    : writer_(writer), access_(std::move(access)), size_(access_ ? size : 0) {}
+
+void* Writer::Reservation::data() const { return access_ ? access_->get_mem() : nullptr; }
+
+void Writer::Reservation::commit(size_t size) {
+  if (!access_) return;
+  access_->notify_clients(size);
+  access_.reset();
+  writer_->bytes_written(size);
+}
+
+Writer::Reservation Writer::reserve(size_t size) {
+  if (!shm_) return Reservation(this, nullptr, 0);
+  if (size <= alloc_size_) return Reservation(this, shm_.get_one_write_access(), size);
+  // resizing makes the followers reconnect, so the memory is only grown
+  auto access = shm_.get_one_write_access_resize(get_alloc_size(size));
+  if (access) {
+    alloc_size_ = shm_.alloc_size();
+    ++reallocations_;
+    if (huge_pages_) advise_huge_pages(access->get_mem());
+  }
+  return Reservation(this, std::move(access), size);
+}
+
+bool Writer::copy_to_shm(const void* data, size_t size) {
+  auto reservation = reserve(size);
+  if (!reservation) return false;
+  std::memcpy(reservation.data(), data, size);
+  reservation.commit(size);
+  return true;
+}
+
 void Writer::bytes_written(size_t size) {
-  std::unique_lock<std::mutex> lock(bytes_mutex_);
   shm_stats_.count_buffer(size);
 }
 
+size_t Writer::get_alloc_size(size_t size) const {
+  size += size / kHeadroomDivisor;
+  // only segments of at least a huge page are rounded to huge pages, small ones would waste it
+  const size_t page = huge_pages_ && size >= kHugePageSize
+                          ? kHugePageSize
+                          : static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return (size + page - 1) / page * page;
+}
+
+void Writer::advise_huge_pages(void* mem) const {
+#ifdef MADV_HUGEPAGE
+  // honored when transparent huge pages are enabled for shared memory. The kernel maps the
+  // segment, so only its parts aligned on huge pages can use them.
+  if (alloc_size_ >= kHugePageSize && 0 != madvise(mem, alloc_size_, MADV_HUGEPAGE) &&
+      nullptr != quid_)
+    quid_->sw_debug("huge pages not available for {}: {}", shmpath_, strerror(errno));
+#endif
+}
+
 void Writer::update_quid_stats() {
-  decltype(shm_stats_) stats;
-  {
-    std::unique_lock<std::mutex> lock(bytes_mutex_);
-    stats = shm_stats_;
-    shm_stats_.reset();
-  }
-  Stat::make_tree_updater(quid_, ".shmdata.writer." + shmpath_)(stats);
+  if (nullptr == quid_) return;
+  auto tree = InfoTree::make();
+  shm_stats_.collect().update_tree(tree, std::string());
+  tree->graft(".stat.alloc_size", InfoTree::make(alloc_size_.load()));
+  tree->graft(".stat.reallocations", InfoTree::make(reallocations_.load()));
+  quid_->graft_tree(".shmdata.writer." + shmpath_ + ".stat", tree->prune(".stat"));
 }
 
 }  // namespace shmdata
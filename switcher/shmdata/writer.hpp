@@ -20,6 +20,8 @@
 #ifndef __SWITCHER_SHMDATA_WRITER_H__
 #define __SWITCHER_SHMDATA_WRITER_H__
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <shmdata/writer.hpp>
 #include "../quiddity/quiddity.hpp"
@@ -43,25 +45,76 @@ class Writer : public SafeBoolIdiom {
   Writer& operator=(const Writer&) = delete;
   Writer& operator=(Writer&&) = default;
 
+  /**
+   * Writable region inside the shared memory, obtained with Writer::reserve. Data written in
+   * the region is published to followers by commit, without intermediate copy. Followers cannot
+   * read while a reservation is alive, so it must be committed or dropped without delay.
+   * A reservation dropped without commit publishes nothing.
+   */
+  class Reservation : public SafeBoolIdiom {
+   public:
+    Reservation(Reservation&&) = default;
+    Reservation& operator=(Reservation&&) = default;
+    void* data() const;
+    size_t size() const { return size_; }
+    /**
+     * Publish the data written from the start of the region. The bytes are accounted in the
+     * writer stats. The reservation is released and cannot be used afterward.
+     * \param size Number of bytes written, not more than the reserved size.
+     */
+    void commit(size_t size);
+
+   private:
+    friend class Writer;
+    Writer* writer_;
+    std::unique_ptr<::shmdata::OneWriteAccess> access_;
+    size_t size_;
+    Reservation(Writer* writer, std::unique_ptr<::shmdata::OneWriteAccess> access, size_t size);
+    bool safe_bool_idiom() const final { return static_cast<bool>(access_); }
+  };
+
   Make_delegate(Writer, ::shmdata::Writer, &shm_, writer);
+  /**
+   * Reserve a writable region in the shared memory, growing it if needed. This avoids building
+   * the data in a private buffer before copying it with copy_to_shm.
+   * \param size Number of bytes required.
+   * \return The reservation, false if the shared memory cannot be accessed.
+   */
+  Reservation reserve(size_t size);
+  /**
+   * Copy data into the shared memory and publish it, growing the memory if needed. The bytes
+   * are accounted in the writer stats.
+   * \param data The data.
+   * \param size Number of bytes.
+   * \return True if the data has been published.
+   */
+  bool copy_to_shm(const void* data, size_t size);
   // FIXME use consultable Global Wrapping
   // this is used in order to monitor traffic in the shmdata,
   // i.e. you need to update this at each write with the size writen,
-  // regardless of the ::shmdata::Writer method you are using
+  // regardless of the ::shmdata::Writer method you are using, except with reserve and
+  // copy_to_shm
   void bytes_written(size_t size);
   std::string get_path() const { return shmpath_; }
 
  private:
+  // growing the memory makes the followers reconnect, so the memory is grown with some headroom
+  static const size_t kHeadroomDivisor;  //!< A quarter of the required size is added.
+  static const size_t kHugePageSize;
   quiddity::Quiddity* quid_;
   std::string shmpath_;
   std::string data_type_;
   SwitcherLogger shmlog_;
+  bool huge_pages_;
   ::shmdata::Writer shm_;
+  std::atomic<size_t> alloc_size_{0};
+  std::atomic<size_t> reallocations_{0};
   std::unique_ptr<PeriodicTask<>> task_;
-  Stat shm_stats_{};
-  std::mutex bytes_mutex_{};
+  StatCounter shm_stats_{};
 
   bool safe_bool_idiom() const final { return static_cast<bool>(shm_); };
+  size_t get_alloc_size(size_t size) const;
+  void advise_huge_pages(void* mem) const;
   void update_quid_stats();
 };
 
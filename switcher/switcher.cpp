@@ -19,9 +19,12 @@
 
 #include "./switcher.hpp"
 
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 
 #include "./gst/utils.hpp"
 #include "./infotree/json-serializer.hpp"
@@ -30,6 +33,7 @@
 #include "./session/session.hpp"
 #include "./utils/file-utils.hpp"
 #include "./utils/scope-exit.hpp"
+#include "./utils/task-graph.hpp"
 
 namespace switcher {
 
@@ -102,117 +106,159 @@ bool Switcher::load_state(InfoTree* state) {
   auto custom_states = state->get_tree(".custom_states");
   auto nicknames = state->get_tree(".nicknames");
 
-  // making quiddities
+  // one configuration task per quiddity named in the state
+  std::vector<std::string> names;
+  std::unordered_map<std::string, TaskGraph::id_t> tasks;
+  for (const auto& tree : {quiddities, nicknames, properties, quiddities_user_data, readers}) {
+    if (!tree) continue;
+    for (auto& name : tree->get_child_keys(".")) {
+      if (tasks.emplace(name, names.size()).second) names.push_back(name);
+    }
+  }
+  std::vector<double> create_durations(names.size(), 0.);
+  std::vector<double> load_durations(names.size(), 0.);
+  using clock = std::chrono::steady_clock;
+  // independent quiddities are loaded concurrently, GStreamer pipeline construction being the
+  // main loading cost
+  const auto num_threads = std::thread::hardware_concurrency();
+
+  // making every quiddity before configuring any of them, so that custom states and properties
+  // may refer to other quiddities of the state
   if (quiddities) {
-    auto quids = quiddities->get_child_keys(".");
-    // creating quiddities
-    for (auto& it : quids) {
-      std::string quid_kind = quiddities->branch_get_value(it);
-      auto created = qcontainer_->create(quid_kind, it, nullptr);
-      if (!created) {
-        sw_warning("error creating quiddity {} (kind {}): ", it, quid_kind, created.msg());
-      }
+    TaskGraph creation;
+    for (size_t i = 0; i < names.size(); ++i) {
+      if (!quiddities->branch_has_data(names[i])) continue;
+      creation.add_task([&, i]() {
+        const auto& name = names[i];
+        const auto start = clock::now();
+        std::string quid_kind = quiddities->branch_get_value(name);
+        auto created = qcontainer_->create(quid_kind, name, nullptr);
+        if (!created) {
+          sw_warning("error creating quiddity {} (kind {}): {}", name, quid_kind, created.msg());
+        }
+        create_durations[i] =
+            std::chrono::duration<double, std::milli>(clock::now() - start).count();
+      });
     }
+    creation.run(num_threads);
+  }
 
-    // loading custom state
-    for (auto& it : quids) {
-      if (0 == qcontainer_->get_id(it)) continue;
-      if (custom_states && !custom_states->empty()) {
-        qcontainer_->get_quiddity(qcontainer_->get_id(it))->on_loading(custom_states->get_tree(it));
-      } else {
-        qcontainer_->get_quiddity(qcontainer_->get_id(it))->on_loading(InfoTree::make());
+  // configuring each quiddity
+  TaskGraph graph;
+  for (size_t i = 0; i < names.size(); ++i) {
+    graph.add_task([&, i]() {
+      const auto& name = names[i];
+      const auto start = clock::now();
+
+      // loading custom state
+      if (quiddities && quiddities->branch_has_data(name)) {
+        auto quid = qcontainer_->get_quiddity(qcontainer_->get_id(name));
+        if (quid) {
+          if (custom_states && !custom_states->empty()) {
+            quid->on_loading(custom_states->get_tree(name));
+          } else {
+            quid->on_loading(InfoTree::make());
+          }
+        }
       }
-    }
-  }
 
-  // nicknames
-  if (nicknames) {
-    for (auto& it : nicknames->get_child_keys(".")) {
-      std::string nickname = nicknames->branch_get_value(it);
-      auto nicknamed_quid = qcontainer_->get_quiddity(qcontainer_->get_id(it));
-      if (!nicknamed_quid || !nicknamed_quid->set_nickname(nickname)) {
-        sw_warning("error applying nickname {} for {}", nickname, it);
+      // nickname
+      if (nicknames && nicknames->branch_has_data(name)) {
+        std::string nickname = nicknames->branch_get_value(name);
+        auto nicknamed_quid = qcontainer_->get_quiddity(qcontainer_->get_id(name));
+        if (!nicknamed_quid || !nicknamed_quid->set_nickname(nickname)) {
+          sw_warning("error applying nickname {} for {}", nickname, name);
+        }
       }
-    }
-  }
 
-  // applying properties
-  std::vector<std::string> quid_to_start;
-  if (properties) {
-    auto quids = properties->get_child_keys(".");
-    for (auto& name : quids) {
-      auto props = properties->get_child_keys(name);
-      for (auto& prop : props) {
-        if (prop == "started" && properties->branch_get_value(name + ".started")) {
-          quid_to_start.push_back(name);
-        } else {
-          auto quid = qcontainer_->get_quiddity(qcontainer_->get_id(name));
-          if (!quid || !quid->prop<&quiddity::property::PBag::set_str_str>(
-                           prop, Any::to_string(properties->branch_get_value(name + "." + prop)))) {
-            sw_warning("failed to apply value, quiddity is {}, property is {}, value is {}",
-                       name,
-                       prop,
-                       Any::to_string(properties->branch_get_value(name + "." + prop)));
+      // applying properties
+      bool to_start = false;
+      if (properties) {
+        auto props = properties->get_child_keys(name);
+        for (auto& prop : props) {
+          if (prop == "started" && properties->branch_get_value(name + ".started")) {
+            to_start = true;
+          } else {
+            auto quid = qcontainer_->get_quiddity(qcontainer_->get_id(name));
+            if (!quid ||
+                !quid->prop<&quiddity::property::PBag::set_str_str>(
+                    prop, Any::to_string(properties->branch_get_value(name + "." + prop)))) {
+              sw_warning("failed to apply value, quiddity is {}, property is {}, value is {}",
+                         name,
+                         prop,
+                         Any::to_string(properties->branch_get_value(name + "." + prop)));
+            }
           }
         }
       }
-    }
-  }
 
-  // applying user data to quiddities
-  if (quiddities_user_data) {
-    auto quids = quiddities_user_data->get_child_keys(".");
-    for (auto& it : quids) {
-      auto quid_id = qcontainer_->get_id(it);
-      if (0 != quid_id) {
-        auto child_keys = quiddities_user_data->get_child_keys(it);
-        for (auto& kit : child_keys) {
-          qcontainer_->user_data<&InfoTree::graft>(
-              quid_id, kit, quiddities_user_data->get_tree(it + "." + kit));
+      // applying user data
+      if (quiddities_user_data) {
+        auto quid_id = qcontainer_->get_id(name);
+        if (0 != quid_id) {
+          auto child_keys = quiddities_user_data->get_child_keys(name);
+          for (auto& kit : child_keys) {
+            qcontainer_->user_data<&InfoTree::graft>(
+                quid_id, kit, quiddities_user_data->get_tree(name + "." + kit));
+          }
         }
       }
-    }
-  }
-  // starting quiddities
-  for (auto& name : quid_to_start) {
-    auto quid = qcontainer_->get_quiddity(qcontainer_->get_id(name));
-    if (!quid) {
-      sw_warning("failed to get quiddity {}", name);
-      continue;
-    }
-    if (!quid || !quid->prop<&quiddity::property::PBag::set_str_str>("started", "true")) {
-      sw_warning("failed to start quiddity {}", name);
-    }
+
+      // starting quiddity
+      if (to_start) {
+        auto quid = qcontainer_->get_quiddity(qcontainer_->get_id(name));
+        if (!quid) {
+          sw_warning("failed to get quiddity {}", name);
+        } else if (!quid->prop<&quiddity::property::PBag::set_str_str>("started", "true")) {
+          sw_warning("failed to start quiddity {}", name);
+        }
+      }
+
+      // connecting to shmdata, the quiddities read from are already loaded
+      if (readers) {
+        auto quid_id = qcontainer_->get_id(name);
+        auto quidreaders = readers->get_child_keys(name + ".shm_from_quid");
+        auto connect_quid_id =
+            qcontainer_->meths<&quiddity::method::MBag::get_id>(quid_id, "connect-quid");
+        for (auto& reader : quidreaders) {
+          qcontainer_->meths<
+              &quiddity::method::MBag::invoke<std::function<bool(std::string, std::string)>>>(
+              quid_id,
+              connect_quid_id,
+              std::make_tuple(Any::to_string(readers->branch_get_value(
+                                  name + ".shm_from_quid." + reader + ".name")),
+                              Any::to_string(readers->branch_get_value(
+                                  name + ".shm_from_quid." + reader + ".suffix"))));
+        }
+        auto rawreaders = readers->get_child_keys(name + ".raw_shm");
+        for (auto& reader : rawreaders) {
+          qcontainer_->meths<&quiddity::method::MBag::invoke<std::function<bool(std::string)>>>(
+              quid_id,
+              qcontainer_->meths<&quiddity::method::MBag::get_id>(quid_id, "connect"),
+              std::make_tuple(Any::to_string(readers->branch_get_value(name + "." + reader))));
+        }
+      }
+      load_durations[i] =
+          create_durations[i] +
+          std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    });
   }
 
-  // Connect to raw shmdata
+  // a reader is loaded after the quiddities it reads from
   if (readers) {
-    auto quids = readers->get_child_keys(".");
-    for (auto& quid : quids) {
-      auto quid_id = qcontainer_->get_id(quid);
-      auto quidreaders = readers->get_child_keys(quid + ".shm_from_quid");
-      auto connect_quid_id =
-          qcontainer_->meths<&quiddity::method::MBag::get_id>(quid_id, "connect-quid");
-      for (auto& reader : quidreaders) {
-        qcontainer_->meths<&quiddity::method::MBag::invoke<std::function<bool(std::string, std::string)>>>(
-            quid_id,
-            connect_quid_id,
-            std::make_tuple(Any::to_string(readers->branch_get_value(quid + ".shm_from_quid." +
-                                                                     reader + ".name")),
-                            Any::to_string(readers->branch_get_value(quid + ".shm_from_quid." +
-                                                                     reader + ".suffix"))));
-      }
-      auto rawreaders = readers->get_child_keys(quid + ".raw_shm");
-      for (auto& reader : rawreaders) {
-        qcontainer_->meths<&quiddity::method::MBag::invoke<std::function<bool(std::string)>>>(
-            qcontainer_->get_id(quid),
-            qcontainer_->meths<&quiddity::method::MBag::get_id>(qcontainer_->get_id(quid),
-                                                                      "connect"),
-            std::make_tuple(Any::to_string(readers->branch_get_value(quid + "." + reader))));
+    for (auto& name : readers->get_child_keys(".")) {
+      for (auto& reader : readers->get_child_keys(name + ".shm_from_quid")) {
+        auto found = tasks.find(Any::to_string(
+            readers->branch_get_value(name + ".shm_from_quid." + reader + ".name")));
+        auto task = tasks[name];
+        if (tasks.end() != found && task != found->second)
+          graph.add_dependency(task, found->second);
       }
     }
   }
 
+  graph.run(num_threads);
+
   // on_loaded
   if (quiddities) {
     auto quids = quiddities->get_child_keys(".");
@@ -222,9 +268,29 @@ bool Switcher::load_state(InfoTree* state) {
       qcontainer_->get_quiddity(quid_id)->on_loaded();
     }
   }
+
+  // reporting loading durations, in milliseconds
+  auto timings = InfoTree::make();
+  for (size_t i = 0; i < names.size(); ++i) {
+    sw_debug("quiddity {} loaded in {} ms, including {} ms for creation",
+             names[i],
+             std::to_string(load_durations[i]),
+             std::to_string(create_durations[i]));
+    timings->vgraft(names[i] + ".create", create_durations[i]);
+    timings->vgraft(names[i] + ".load", load_durations[i]);
+  }
+  {
+    std::lock_guard<std::mutex> lock(info_tree_mtx_);
+    info_tree_->graft(".load_timings", timings);
+  }
   return true;
 }
 
+InfoTree::ptr Switcher::get_info_tree() const {
+  std::lock_guard<std::mutex> lock(info_tree_mtx_);
+  return info_tree_->get_copy();
+}
+
 InfoTree::ptr Switcher::get_state() const {
   auto quiddities = qcontainer_->get_ids();
   InfoTree::ptr tree = InfoTree::make();
@@ -22,6 +22,7 @@
 
 #include <cstdlib>
 #include <filesystem>
+#include <mutex>
 #include <regex>
 #include <string>
 #include <vector>
@@ -35,6 +36,7 @@
 #include "quiddity/quid-id-t.hpp"
 #include "session/session.hpp"
 #include "utils/make-consultable.hpp"
+#include "utils/scheduler.hpp"
 #include "utils/string-utils.hpp"
 
 namespace fs = std::filesystem;
@@ -89,7 +91,20 @@ class Switcher : public gst::Initialized,
 
   // State
   InfoTree::ptr get_state() const;
+  /**
+   * Load a state obtained from get_state. Every quiddity is created before any of them is
+   * configured. Quiddities are created and configured concurrently, except that a quiddity is
+   * configured only once the quiddities it reads shmdata from are configured and started.
+   * The loading duration of each quiddity, in milliseconds, is published in the information
+   * tree under .load_timings.<nickname>.create and .load_timings.<nickname>.load.
+   */
   bool load_state(InfoTree* state);
+  /**
+   * Get information about this Switcher instance, such as the loading durations of the last
+   * load_state.
+   * \return A copy of the information tree.
+   */
+  InfoTree::ptr get_info_tree() const;
   void reset_state(bool remove_created_quiddities);
 
   // Quiddity Factory
@@ -104,6 +119,10 @@ class Switcher : public gst::Initialized,
   // shmpaths
   const std::string get_shm_dir() const { return conf_.get_value(".shm.directory"); }
   const std::string get_shm_prefix() const { return conf_.get_value(".shm.prefix"); }
+  bool get_shm_huge_pages() const {
+    auto huge_pages = conf_.get_value(".shm.huge_pages");
+    return huge_pages.is<bool>() && huge_pages.copy_as<bool>();
+  }
 
   // Bundles
   bool load_bundle_from_config(const std::string& bundle_description);
@@ -137,9 +156,13 @@ class Switcher : public gst::Initialized,
   void register_bundle_from_configuration();
   static void init_gst();
 
+  // keeps the scheduler shared by periodic tasks alive while quiddities come and go
+  Scheduler::ptr scheduler_{Scheduler::get_default()};
   quiddity::Factory qfactory_;
   quiddity::Container::ptr qcontainer_;
   std::vector<quiddity::qid_t> quiddities_at_reset_{};
+  mutable std::mutex info_tree_mtx_{};
+  InfoTree::ptr info_tree_{InfoTree::make()};
   std::weak_ptr<Switcher> me_{};
   int control_port_{0};
 };
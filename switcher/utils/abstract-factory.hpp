@@ -24,6 +24,7 @@
 #ifndef __SWITCHER_ABSTRACT_FACTORY_H__
 #define __SWITCHER_ABSTRACT_FACTORY_H__
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <vector>
@@ -44,6 +45,8 @@ class AbstractFactory {
   bool unregister_kind(Key Id);
   std::vector<Key> get_keys() const;
   std::shared_ptr<T> create(Key Id, ATs... args);
+  // the creation function for a kind, that can be invoked without accessing the factory
+  std::function<std::shared_ptr<T>(ATs...)> get_create(Key Id) const;
   bool key_exists(Key Id) const;
 
  private:
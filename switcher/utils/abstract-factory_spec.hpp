@@ -66,17 +66,27 @@ bool AbstractFactory<T, Key, ATs...>::unregister_kind(Key Id) {
 
 template <typename T, typename Key, typename... ATs>
 std::shared_ptr<T> AbstractFactory<T, Key, ATs...>::create(Key Id, ATs... args) {
-  std::shared_ptr<T> pointer;
+  auto create_fun = get_create(Id);
+  if (!create_fun) return std::shared_ptr<T>();
+  return create_fun(std::forward<ATs>(args)...);
+}
+
+template <typename T, typename Key, typename... ATs>
+std::function<std::shared_ptr<T>(ATs...)> AbstractFactory<T, Key, ATs...>::get_create(
+    Key Id) const {
   auto constructor_it = constructor_map_.find(Id);
+  if (constructor_it == constructor_map_.end()) return nullptr;
+  auto creator = constructor_it->second;
   auto destructor_it = destructor_map_.find(Id);
-  if (constructor_it != constructor_map_.end()) {
-    if (destructor_it != destructor_map_.end())
-      pointer.reset(constructor_it->second->Create(std::forward<ATs>(args)...),
-                    destructor_it->second);
+  auto destructor = destructor_it != destructor_map_.end() ? destructor_it->second : nullptr;
+  return [creator, destructor](ATs... args) {
+    std::shared_ptr<T> pointer;
+    if (destructor)
+      pointer.reset(creator->Create(std::forward<ATs>(args)...), destructor);
     else
-      pointer.reset(constructor_it->second->Create(std::forward<ATs>(args)...));
-  }
-  return pointer;
+      pointer.reset(creator->Create(std::forward<ATs>(args)...));
+    return pointer;
+  };
 }
 
 template <typename T, typename Key, typename... ATs>
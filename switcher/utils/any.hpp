@@ -20,6 +20,9 @@
 #ifndef __SWITCHER_ANY_H__
 #define __SWITCHER_ANY_H__
 
+#include <cstddef>
+#include <cstdint>
+#include <new>
 #include <ostream>  // FIXME use serialize-string.hpp instead
 #include <sstream>
 #include <string>
@@ -54,6 +57,9 @@ struct AnyValueBase {
     // AnyValueBase (const AnyValueBase &) = delete;
     virtual ~AnyValueBase() {}
     virtual AnyValueBase* clone() const = 0;
+    // construct in the inline storage of an Any
+    virtual AnyValueBase* clone_into(void* storage) const = 0;
+    virtual AnyValueBase* move_into(void* storage) = 0;
     virtual std::string to_string() const = 0;
     AnyCategory category_{AnyCategory::NONE};
     AnyArithmeticType arithmetic_type_{AnyArithmeticType::NOT_DEFINED};
@@ -76,6 +82,14 @@ struct AnyValueDerived : AnyValueBase {
       return new AnyValueDerived<T>(value_, category_, arithmetic_type_);
     }
 
+    AnyValueBase* clone_into(void* storage) const {
+      return new (storage) AnyValueDerived<T>(value_, category_, arithmetic_type_);
+    }
+
+    AnyValueBase* move_into(void* storage) {
+      return new (storage) AnyValueDerived<T>(std::move(value_), category_, arithmetic_type_);
+    }
+
     std::string to_string() const { return serialize::apply<T>(value_); }
 };
 
@@ -85,31 +99,45 @@ struct AnyValueDerived<std::nullptr_t> : AnyValueBase {
     AnyValueDerived(U&& value) : value_(std::forward<U>(value)) {}
     std::nullptr_t value_;
     AnyValueBase* clone() const { return new AnyValueDerived<std::nullptr_t>(value_); }
+    AnyValueBase* clone_into(void* storage) const {
+      return new (storage) AnyValueDerived<std::nullptr_t>(value_);
+    }
+    AnyValueBase* move_into(void* storage) { return clone_into(storage); }
     std::string to_string() const { return std::string("null"); }
 };
 
+// Values small enough, such as arithmetic values and strings, are stored inside the Any instead
+// of being allocated. References obtained with as are therefore invalidated when the Any is
+// moved.
 struct Any {
     bool is_null() const { return !ptr_; }
     bool not_null() const { return ptr_; }
 
     AnyCategory get_category() const { return ptr_ ? ptr_->category_ : AnyCategory::NONE; }
 
+    AnyArithmeticType get_arithmetic_type() const {
+      return ptr_ ? ptr_->arithmetic_type_ : AnyArithmeticType::NOT_DEFINED;
+    }
+
     // default ctor
     template <typename U>
     Any(U&& value, typename std::enable_if<!std::is_arithmetic<U>::value>::type* = nullptr)
-            : ptr_(new AnyValueDerived<StorageType<U>>(std::forward<U>(value))) {
+    {
+      emplace<StorageType<U>>(std::forward<U>(value));
       ptr_->category_ = AnyCategory::OTHER;
     }
 
     // bool ctor
     template <typename U = bool>
-    Any(bool value) : ptr_(new AnyValueDerived<StorageType<U>>(std::forward<U>(value))) {
+    Any(bool value) {
+      emplace<StorageType<U>>(std::forward<U>(value));
       ptr_->category_ = AnyCategory::BOOLEAN;
     }
 
     // char ctor
     template <typename U = char>
-    Any(char value) : ptr_(new AnyValueDerived<StorageType<U>>(std::forward<U>(value))) {
+    Any(char value) {
+      emplace<StorageType<U>>(std::forward<U>(value));
       ptr_->category_ = AnyCategory::OTHER;
     }
 
@@ -117,8 +145,8 @@ struct Any {
     template <typename U>
     Any(U&& value,
         typename std::enable_if<!std::is_same<U, bool>::value && !std::is_same<U, char>::value &&
-                                std::is_integral<U>::value>::type* = nullptr)
-            : ptr_(new AnyValueDerived<StorageType<U>>(std::forward<U>(value))) {
+                                std::is_integral<U>::value>::type* = nullptr) {
+      emplace<StorageType<U>>(std::forward<U>(value));
       ptr_->category_ = AnyCategory::INTEGRAL;
       if (std::is_same<U, int>::value)
         ptr_->arithmetic_type_ = AnyArithmeticType::INT;
@@ -144,8 +172,8 @@ struct Any {
     template <typename U>
     Any(U&& value,
         typename std::enable_if<!std::is_same<U, bool>::value &&
-                                std::is_floating_point<U>::value>::type* = nullptr)
-            : ptr_(new AnyValueDerived<StorageType<U>>(std::forward<U>(value))) {
+                                std::is_floating_point<U>::value>::type* = nullptr) {
+      emplace<StorageType<U>>(std::forward<U>(value));
       ptr_->category_ = AnyCategory::FLOATING_POINT;
       if (std::is_same<U, float>::value)
         ptr_->arithmetic_type_ = AnyArithmeticType::FLOAT;
@@ -272,31 +300,31 @@ struct Any {
 
     Any() : ptr_(nullptr) {}
 
-    Any(Any& that) : ptr_(that.clone()) {}
+    Any(Any& that) { copy_from(that); }
 
-    Any(Any&& that) : ptr_(that.ptr_) { that.ptr_ = nullptr; }
+    Any(Any&& that) { move_from(that); }
 
-    Any(const Any& that) : ptr_(that.clone()) {}
+    Any(const Any& that) { copy_from(that); }
 
-    Any(const Any&& that) : ptr_(that.clone()) {}
+    Any(const Any&& that) { copy_from(that); }
 
     Any& operator=(const Any& a) {
-      if (ptr_ == a.ptr_) return *this;
-      auto old_ptr = ptr_;
-      ptr_ = a.clone();
-      if (old_ptr) delete old_ptr;
+      if (this == &a) return *this;
+      // the copy is made first, a can be owned by the current value
+      Any copy(a);
+      reset();
+      move_from(copy);
       return *this;
     }
 
     Any& operator=(Any&& a) {
-      if (ptr_ == a.ptr_) return *this;
-      std::swap(ptr_, a.ptr_);
+      if (this == &a) return *this;
+      reset();
+      move_from(a);
       return *this;
     }
 
-    ~Any() {
-      if (ptr_) delete ptr_;
-    }
+    ~Any() { reset(); }
 
     static std::string to_string(const Any& any) {
       std::stringstream ss;
@@ -305,14 +333,60 @@ struct Any {
     }
 
 private:
-    AnyValueBase* clone() const {
-      if (ptr_)
-        return ptr_->clone();
+    // large enough for a std::string, short strings are then not allocated either
+    static constexpr std::size_t kStorageSize = sizeof(AnyValueDerived<std::string>);
+
+    template <typename T>
+    static constexpr bool fits_storage() {
+      return sizeof(AnyValueDerived<T>) <= kStorageSize &&
+             alignof(AnyValueDerived<T>) <= alignof(void*) &&
+             std::is_nothrow_move_constructible<T>::value;
+    }
+
+    template <typename T, typename U>
+    void emplace(U&& value) {
+      if constexpr (fits_storage<T>())
+        ptr_ = new (storage_) AnyValueDerived<T>(std::forward<U>(value));
+      else
+        ptr_ = new AnyValueDerived<T>(std::forward<U>(value));
+    }
+
+    bool is_stored() const {
+      auto ptr = reinterpret_cast<std::uintptr_t>(ptr_);
+      auto storage = reinterpret_cast<std::uintptr_t>(storage_);
+      return ptr >= storage && ptr < storage + kStorageSize;
+    }
+
+    void copy_from(const Any& that) {
+      if (!that.ptr_)
+        ptr_ = nullptr;
+      else if (that.is_stored())
+        ptr_ = that.ptr_->clone_into(storage_);
+      else
+        ptr_ = that.ptr_->clone();
+    }
+
+    void move_from(Any& that) {
+      if (that.is_stored()) {
+        ptr_ = that.ptr_->move_into(storage_);
+        that.reset();
+        return;
+      }
+      ptr_ = that.ptr_;
+      that.ptr_ = nullptr;
+    }
+
+    void reset() {
+      if (!ptr_) return;
+      if (is_stored())
+        ptr_->~AnyValueBase();
       else
-        return nullptr;
+        delete ptr_;
+      ptr_ = nullptr;
     }
 
     AnyValueBase* ptr_;
+    alignas(void*) char storage_[kStorageSize];
     friend std::ostream& operator<<(std::ostream& os, const Any& any) {
       if (any.ptr_)
         os << any.ptr_->to_string();
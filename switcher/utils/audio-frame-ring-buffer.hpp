@@ -0,0 +1,104 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __SWITCHER_AUDIO_FRAME_RING_BUFFER_H__
+#define __SWITCHER_AUDIO_FRAME_RING_BUFFER_H__
+
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+namespace switcher {
+namespace utils {
+
+/**
+ * A ring buffer class for multithreaded exchange of multichannel audio. Samples are stored as
+ * interleaved frames, so that all channels are added and removed together and stay aligned.
+ *
+ * As with AudioRingBuffer, this is a single producer, single consumer queue: put_frames must be
+ * called from a single thread, and pop_frames and shrink_to from a single other thread.
+ * \tparam SampleType Audio sample type.
+ */
+template <typename SampleType>
+class AudioFrameRingBuffer {
+ public:
+  /**
+   * Construct an AudioFrameRingBuffer object.
+   * \param channels       Number of channels per frame.
+   * \param size_in_frames Total lenght of the ring buffer, in frames.
+   */
+  AudioFrameRingBuffer(unsigned int channels, std::size_t size_in_frames = 96000);
+  ~AudioFrameRingBuffer() = default;
+  /**
+   * Add interleaved frames to the ring buffer.
+   * \param   src              Buffer of interleaved samples.
+   * \param   num              Number of frames to add.
+   * \return Number of frames actually processed.
+   **/
+  std::size_t put_frames(const SampleType* src, std::size_t num);
+  /**
+   * Pop frames from the ring buffer, de-interleaving them into one buffer per channel.
+   * \param   num              Number of frames to pop.
+   * \param   dests            One destination buffer per channel. A null destination skips the
+   *                           channel. If dests is null, frames are just removed.
+   * \return Number of frames actually processed.
+   **/
+  std::size_t pop_frames(std::size_t num, SampleType* const* dests);
+  /**
+   * Shrink the ring buffer. Removing starts from the older frame.
+   * \param size             Number of frames to keep in the ring buffer.
+   * \return Number of frames dropped.
+   **/
+  std::size_t shrink_to(std::size_t size);
+  /**
+   * Get usage.
+   * \return Number of frames available in the ring buffer.
+   **/
+  std::size_t get_usage() const;
+  unsigned int get_channels() const { return channels_; }
+
+ private:
+  static constexpr std::size_t kCacheLineSize{64};
+  // Frames de-interleaved together, small enough for their samples to stay in L1 cache while
+  // each channel is copied.
+  static constexpr std::size_t kBlockFrames{32};
+  const unsigned int channels_;     //!< Number of samples per frame.
+  const std::size_t buffer_size_;   //!< Buffer size, in frames.
+  std::vector<SampleType> buffer_;  //!< Interleaved frames.
+  // Playheads count frames since construction, their position in buffer_ is modulo buffer_size_.
+  alignas(kCacheLineSize) std::atomic<std::size_t> read_{0};   //!< Updated by the consumer.
+  alignas(kCacheLineSize) std::atomic<std::size_t> write_{0};  //!< Updated by the producer.
+
+  /**
+   * De-interleave contiguous frames from the buffer.
+   * \param pos       Position, in frames, of the first frame in buffer_.
+   * \param num       Number of frames to copy, not crossing the end of buffer_.
+   * \param dests     One destination buffer per channel.
+   * \param offset    Position, in samples, where to start writing in each destination.
+   **/
+  void copy_out(std::size_t pos,
+                std::size_t num,
+                SampleType* const* dests,
+                std::size_t offset) const;
+};
+
+}  // namespace utils
+}  // namespace switcher
+#include "./audio-frame-ring-buffer_spec.hpp"
+#endif
@@ -0,0 +1,100 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <algorithm>
+
+namespace switcher {
+namespace utils {
+
+template <typename SampleType>
+AudioFrameRingBuffer<SampleType>::AudioFrameRingBuffer(unsigned int channels,
+                                                       std::size_t size_in_frames)
+    : channels_(channels), buffer_size_(size_in_frames), buffer_(size_in_frames * channels) {}
+
+template <typename SampleType>
+std::size_t AudioFrameRingBuffer<SampleType>::put_frames(const SampleType* src, std::size_t num) {
+  auto write = write_.load(std::memory_order_relaxed);
+  auto available = buffer_size_ - (write - read_.load(std::memory_order_acquire));
+  std::size_t res = std::min(num, available);
+  if (0 == res) return res;
+  auto pos = write % buffer_size_;
+  // copy the end of the buffer, then the remaining frames at the beginning
+  auto first_write = std::min(res, buffer_size_ - pos);
+  std::memcpy(static_cast<void*>(buffer_.data() + pos * channels_),
+              src,
+              first_write * channels_ * sizeof(SampleType));
+  std::memcpy(static_cast<void*>(buffer_.data()),
+              src + first_write * channels_,
+              (res - first_write) * channels_ * sizeof(SampleType));
+  write_.store(write + res, std::memory_order_release);
+  return res;
+}
+
+template <typename SampleType>
+void AudioFrameRingBuffer<SampleType>::copy_out(std::size_t pos,
+                                                std::size_t num,
+                                                SampleType* const* dests,
+                                                std::size_t offset) const {
+  const auto* frames = buffer_.data() + pos * channels_;
+  for (std::size_t done = 0; done < num; done += kBlockFrames) {
+    auto block = std::min(kBlockFrames, num - done);
+    const auto* block_frames = frames + done * channels_;
+    for (unsigned int chan = 0; chan < channels_; ++chan) {
+      if (nullptr == dests[chan]) continue;
+      auto* dest = dests[chan] + offset + done;
+      for (std::size_t i = 0; i < block; ++i) dest[i] = block_frames[i * channels_ + chan];
+    }
+  }
+}
+
+template <typename SampleType>
+std::size_t AudioFrameRingBuffer<SampleType>::pop_frames(std::size_t num,
+                                                         SampleType* const* dests) {
+  auto read = read_.load(std::memory_order_relaxed);
+  std::size_t res = std::min(num, write_.load(std::memory_order_acquire) - read);
+  if (0 == res) return res;
+  if (nullptr != dests) {
+    auto pos = read % buffer_size_;
+    auto first_read = std::min(res, buffer_size_ - pos);
+    copy_out(pos, first_read, dests, 0);
+    copy_out(0, res - first_read, dests, first_read);
+  }
+  read_.store(read + res, std::memory_order_release);
+  return res;
+}
+
+template <typename SampleType>
+std::size_t AudioFrameRingBuffer<SampleType>::shrink_to(std::size_t size) {
+  auto read = read_.load(std::memory_order_relaxed);
+  std::size_t available = write_.load(std::memory_order_acquire) - read;
+  if (available < size) return 0;
+  std::size_t res = available - size;
+  read_.store(read + res, std::memory_order_release);
+  return res;
+}
+
+template <typename SampleType>
+std::size_t AudioFrameRingBuffer<SampleType>::get_usage() const {
+  // read_ first, since write_ can only be ahead of it
+  auto read = read_.load(std::memory_order_acquire);
+  return write_.load(std::memory_order_acquire) - read;
+}
+
+}  // namespace utils
+}  // namespace switcher
@@ -0,0 +1,188 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include "./audio-interleave.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SWITCHER_INTERLEAVE_X86
+#endif
+
+namespace switcher {
+namespace utils {
+
+namespace {
+
+// Kernels write num_channels samples per frame in dest, frames being stride samples apart. They
+// progress by blocks of frames, so that destination frames are written sequentially.
+
+// copy channels [first_chan, last_chan) of frames [first_frame, last_frame) one sample at a time
+inline void copy_samples(const float* const* channels,
+                         std::size_t first_chan,
+                         std::size_t last_chan,
+                         std::size_t first_frame,
+                         std::size_t last_frame,
+                         float* dest,
+                         std::size_t stride) {
+  for (std::size_t frame = first_frame; frame < last_frame; ++frame)
+    for (std::size_t chan = first_chan; chan < last_chan; ++chan)
+      dest[frame * stride + chan] = channels[chan][frame];
+}
+
+void interleave_one_by_one(const float* const* channels,
+                           std::size_t num_channels,
+                           std::size_t num_frames,
+                           float* dest,
+                           std::size_t stride) {
+  copy_samples(channels, 0, num_channels, 0, num_frames, dest, stride);
+}
+
+#ifdef SWITCHER_INTERLEAVE_X86
+// transpose 4 channels by 4 frames
+__attribute__((target("sse"))) inline void transpose_4x4(const float* const* channels,
+                                                         std::size_t chan,
+                                                         std::size_t frame,
+                                                         float* dest,
+                                                         std::size_t stride) {
+  __m128 row0 = _mm_loadu_ps(channels[chan] + frame);
+  __m128 row1 = _mm_loadu_ps(channels[chan + 1] + frame);
+  __m128 row2 = _mm_loadu_ps(channels[chan + 2] + frame);
+  __m128 row3 = _mm_loadu_ps(channels[chan + 3] + frame);
+  _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+  float* out = dest + frame * stride + chan;
+  _mm_storeu_ps(out, row0);
+  _mm_storeu_ps(out + stride, row1);
+  _mm_storeu_ps(out + 2 * stride, row2);
+  _mm_storeu_ps(out + 3 * stride, row3);
+}
+
+// interleave 4 frames of a stereo stream
+__attribute__((target("sse"))) inline void interleave_stereo_4(const float* const* channels,
+                                                               std::size_t frame,
+                                                               float* dest) {
+  __m128 left = _mm_loadu_ps(channels[0] + frame);
+  __m128 right = _mm_loadu_ps(channels[1] + frame);
+  _mm_storeu_ps(dest + 2 * frame, _mm_unpacklo_ps(left, right));
+  _mm_storeu_ps(dest + 2 * frame + 4, _mm_unpackhi_ps(left, right));
+}
+
+__attribute__((target("sse"))) void interleave_sse(const float* const* channels,
+                                                   std::size_t num_channels,
+                                                   std::size_t num_frames,
+                                                   float* dest,
+                                                   std::size_t stride) {
+  const auto block_chans = num_channels - num_channels % 4;
+  const auto block_frames = num_frames - num_frames % 4;
+  for (std::size_t frame = 0; frame < block_frames; frame += 4) {
+    if (2 == num_channels && 2 == stride) {
+      interleave_stereo_4(channels, frame, dest);
+      continue;
+    }
+    for (std::size_t chan = 0; chan < block_chans; chan += 4)
+      transpose_4x4(channels, chan, frame, dest, stride);
+    copy_samples(channels, block_chans, num_channels, frame, frame + 4, dest, stride);
+  }
+  copy_samples(channels, 0, num_channels, block_frames, num_frames, dest, stride);
+}
+
+// transpose 8 channels by 8 frames
+__attribute__((target("avx"))) inline void transpose_8x8(const float* const* channels,
+                                                         std::size_t chan,
+                                                         std::size_t frame,
+                                                         float* dest,
+                                                         std::size_t stride) {
+  __m256 rows[8];
+  for (int i = 0; i < 8; ++i) rows[i] = _mm256_loadu_ps(channels[chan + i] + frame);
+  __m256 unpacked[8];
+  for (int i = 0; i < 8; i += 2) {
+    unpacked[i] = _mm256_unpacklo_ps(rows[i], rows[i + 1]);
+    unpacked[i + 1] = _mm256_unpackhi_ps(rows[i], rows[i + 1]);
+  }
+  __m256 shuffled[8];
+  for (int i = 0; i < 8; i += 4) {
+    shuffled[i] = _mm256_shuffle_ps(unpacked[i], unpacked[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+    shuffled[i + 1] = _mm256_shuffle_ps(unpacked[i], unpacked[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+    shuffled[i + 2] = _mm256_shuffle_ps(unpacked[i + 1], unpacked[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+    shuffled[i + 3] = _mm256_shuffle_ps(unpacked[i + 1], unpacked[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+  }
+  float* out = dest + frame * stride + chan;
+  for (int i = 0; i < 4; ++i) {
+    // lower lanes hold frames 0 to 3, upper lanes frames 4 to 7
+    _mm256_storeu_ps(out + i * stride,
+                     _mm256_permute2f128_ps(shuffled[i], shuffled[i + 4], 0x20));
+    _mm256_storeu_ps(out + (i + 4) * stride,
+                     _mm256_permute2f128_ps(shuffled[i], shuffled[i + 4], 0x31));
+  }
+}
+
+__attribute__((target("avx"))) void interleave_avx(const float* const* channels,
+                                                   std::size_t num_channels,
+                                                   std::size_t num_frames,
+                                                   float* dest,
+                                                   std::size_t stride) {
+  if (num_channels < 8) return interleave_sse(channels, num_channels, num_frames, dest, stride);
+  const auto block_chans = num_channels - num_channels % 8;
+  const bool has_4_chans_block = num_channels - block_chans >= 4;
+  const auto block_frames = num_frames - num_frames % 8;
+  for (std::size_t frame = 0; frame < block_frames; frame += 8) {
+    for (std::size_t chan = 0; chan < block_chans; chan += 8)
+      transpose_8x8(channels, chan, frame, dest, stride);
+    auto chan = block_chans;
+    if (has_4_chans_block) {
+      transpose_4x4(channels, chan, frame, dest, stride);
+      transpose_4x4(channels, chan, frame + 4, dest, stride);
+      chan += 4;
+    }
+    copy_samples(channels, chan, num_channels, frame, frame + 8, dest, stride);
+  }
+  copy_samples(channels, 0, num_channels, block_frames, num_frames, dest, stride);
+}
+#endif
+
+using interleave_fun_t =
+    void (*)(const float* const*, std::size_t, std::size_t, float*, std::size_t);
+
+interleave_fun_t select_interleave() {
+#ifdef SWITCHER_INTERLEAVE_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx")) return &interleave_avx;
+  if (__builtin_cpu_supports("sse")) return &interleave_sse;
+#endif
+  return &interleave_one_by_one;
+}
+
+}  // namespace
+
+void interleave(const float* const* channels,
+                std::size_t num_channels,
+                std::size_t num_frames,
+                float* dest) {
+  static const interleave_fun_t fun = select_interleave();
+  fun(channels, num_channels, num_frames, dest, num_channels);
+}
+
+void interleave_scalar(const float* const* channels,
+                       std::size_t num_channels,
+                       std::size_t num_frames,
+                       float* dest) {
+  interleave_one_by_one(channels, num_channels, num_frames, dest, num_channels);
+}
+
+}  // namespace utils
+}  // namespace switcher
@@ -0,0 +1,51 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __SWITCHER_AUDIO_INTERLEAVE_H__
+#define __SWITCHER_AUDIO_INTERLEAVE_H__
+
+#include <cstddef>
+
+namespace switcher {
+namespace utils {
+
+/**
+ * Interleave one buffer per channel into a buffer of frames. The implementation is selected
+ * at first call according to the CPU: AVX or SSE on x86, interleave_scalar otherwise.
+ * \param   channels         One source buffer per channel, each holding num_frames samples.
+ * \param   num_channels     Number of channels.
+ * \param   num_frames       Number of frames to write.
+ * \param   dest             Destination buffer, holding num_channels * num_frames samples.
+ **/
+void interleave(const float* const* channels,
+                std::size_t num_channels,
+                std::size_t num_frames,
+                float* dest);
+
+/**
+ * Reference implementation of interleave, copying one sample at a time.
+ **/
+void interleave_scalar(const float* const* channels,
+                       std::size_t num_channels,
+                       std::size_t num_frames,
+                       float* dest);
+
+}  // namespace utils
+}  // namespace switcher
+#endif
@@ -60,6 +60,11 @@ class AudioResampler {
    * \return A sample.
    */
   inline float get_sample(std::size_t pos, unsigned int channel_number);
+  /**
+   * Get the resampled samples, interleaved, in the float format.
+   * \return The first sample of the first channel.
+   */
+  const float* get_samples() const { return resampled_.data(); }
 
  private:
   /**
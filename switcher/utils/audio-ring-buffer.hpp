@@ -32,6 +32,11 @@ namespace utils {
  * A ring buffer class for multithreaded exchange of audio samples. The sample format is set using a
  * class template argument.
  *
+ * The ring buffer is a single producer, single consumer queue: put_samples must be called from a
+ * single thread, and pop, read and shrink methods from a single other thread. Read and write
+ * positions are published with acquire/release ordering and live in separate cache lines, so that
+ * no lock is required.
+ *
  * The ring buffer is designed to host a single channel audio. Multichannel should be implemented
  * using multiple AudioRingBuffer.
  * \tparam SampleType Audio sample type.
@@ -54,6 +59,16 @@ class AudioRingBuffer {
    * \return Number of sample actually processed.
    **/
   std::size_t put_samples(std::size_t num, std::function<SampleType()> sample_factory);
+  /**
+   * Add samples to the ring buffer from a user-provided buffer. Samples can be taken from
+   * interleaved audio by giving the address of the first sample of the channel and the number of
+   * channels as stride.
+   * \param   src              Buffer where to read the first sample.
+   * \param   num              Number of sample to add.
+   * \param   stride           Distance, in samples, between two consecutive samples in src.
+   * \return Number of sample actually processed.
+   **/
+  std::size_t put_samples(const SampleType* src, std::size_t num, std::size_t stride = 1);
   /**
    * Pop or remove samples from the ring buffer to a user-provided buffer.
    * \param   num              Number of sample to pop.
@@ -114,11 +129,27 @@ class AudioRingBuffer {
   std::size_t get_usage();
 
  private:
-  const std::size_t buffer_size_;     //!< Initial buffer size.
-  std::vector<SampleType> buffer_;    //!< Actual buffer.
-  std::atomic_ulong available_size_;  //!< Number of sample that can be added.
-  std::size_t read_{0};               //!< Read playhead.
-  std::size_t write_{0};              //!< Write playhead.
+  static constexpr std::size_t kCacheLineSize{64};
+  const std::size_t buffer_size_;   //!< Initial buffer size.
+  std::vector<SampleType> buffer_;  //!< Actual buffer.
+  // Playheads count samples since construction, their position in buffer_ is modulo buffer_size_.
+  alignas(kCacheLineSize) std::atomic<std::size_t> read_{0};   //!< Updated by the consumer.
+  alignas(kCacheLineSize) std::atomic<std::size_t> write_{0};  //!< Updated by the producer.
+
+  /**
+   * Number of sample available for reading, as seen from the consumer. Positions are loaded with
+   * acquire ordering, so that samples written before are visible.
+   * \param read Current read playhead.
+   **/
+  std::size_t readable(std::size_t read) const;
+  /**
+   * Copy samples from the ring buffer, without removing them.
+   * \param read      Read playhead where to start copying.
+   * \param num       Number of sample to copy.
+   * \param dest      Destination buffer.
+   * \param stride    Distance, in samples, between two consecutive samples in dest.
+   **/
+  void copy_out(std::size_t read, std::size_t num, SampleType* dest, std::size_t stride) const;
 };
 
 }  // namespace utils
@@ -17,74 +17,104 @@
  * Boston, MA 02111-1307, USA.
  */
 
-#include <iostream>
+#include <algorithm>
 
 namespace switcher {
 namespace utils {
 
 template <typename SampleType>
 AudioRingBuffer<SampleType>::AudioRingBuffer(std::size_t size_in_sample)
-    : buffer_size_(size_in_sample), buffer_(size_in_sample), available_size_(size_in_sample) {}
+    : buffer_size_(size_in_sample), buffer_(size_in_sample) {}
 
 template <typename SampleType>
 std::size_t AudioRingBuffer<SampleType>::put_samples(std::size_t num,
                                                      std::function<SampleType()> sample_getter) {
-  std::size_t available = available_size_.load();
-  std::size_t res = num;
-  if (available < num) res = available;
+  auto write = write_.load(std::memory_order_relaxed);
+  auto available = buffer_size_ - (write - read_.load(std::memory_order_acquire));
+  std::size_t res = std::min(num, available);
   if (0 == res) return res;
+  auto pos = write % buffer_size_;
   for (std::size_t i = 0; i < res; ++i) {
-    buffer_[write_] = sample_getter();
-    ++write_;
-    if (buffer_size_ == write_) write_ = 0;
+    buffer_[pos] = sample_getter();
+    ++pos;
+    if (buffer_size_ == pos) pos = 0;
   }
-  available_size_.fetch_sub(res);
+  write_.store(write + res, std::memory_order_release);
   return res;
 }
 
 template <typename SampleType>
-std::size_t AudioRingBuffer<SampleType>::pop_samples(std::size_t num, SampleType* dest) {
-  std::size_t available = buffer_size_ - available_size_.load();
-  std::size_t res = num;
-  if (available < num) res = available;
+std::size_t AudioRingBuffer<SampleType>::put_samples(const SampleType* src,
+                                                     std::size_t num,
+                                                     std::size_t stride) {
+  auto write = write_.load(std::memory_order_relaxed);
+  auto available = buffer_size_ - (write - read_.load(std::memory_order_acquire));
+  std::size_t res = std::min(num, available);
   if (0 == res) return res;
-  if (nullptr == dest) {
-    read_ = (read_ + res) % buffer_size_;
-    available_size_.fetch_add(res);
-    return res;
+  auto pos = write % buffer_size_;
+  // copy the end of the buffer, then the remaining samples at the beginning
+  auto first_write = std::min(res, buffer_size_ - pos);
+  auto* dest = buffer_.data() + pos;
+  if (1 == stride) {
+    std::memcpy(static_cast<void*>(dest), src, first_write * sizeof(SampleType));
+    std::memcpy(static_cast<void*>(buffer_.data()),
+                src + first_write,
+                (res - first_write) * sizeof(SampleType));
+  } else {
+    for (std::size_t i = 0; i < first_write; ++i) dest[i] = src[i * stride];
+    src += first_write * stride;
+    dest = buffer_.data();
+    for (std::size_t i = 0; i < res - first_write; ++i) dest[i] = src[i * stride];
   }
-  auto first_read = buffer_size_ - read_;
-  if (first_read >= num) {  // one copy is enought
-    std::memcpy(static_cast<void*>(dest), buffer_.data() + read_, num * sizeof(SampleType));
-    read_ += num;
-  } else {  // copy the end of the buffer, then the remaining samples located at the beginning
-    std::memcpy(static_cast<void*>(dest), buffer_.data() + read_, first_read * sizeof(SampleType));
+  write_.store(write + res, std::memory_order_release);
+  return res;
+}
+
+template <typename SampleType>
+std::size_t AudioRingBuffer<SampleType>::readable(std::size_t read) const {
+  return write_.load(std::memory_order_acquire) - read;
+}
+
+template <typename SampleType>
+void AudioRingBuffer<SampleType>::copy_out(std::size_t read,
+                                           std::size_t num,
+                                           SampleType* dest,
+                                           std::size_t stride) const {
+  auto pos = read % buffer_size_;
+  // copy the end of the buffer, then the remaining samples located at the beginning
+  auto first_read = std::min(num, buffer_size_ - pos);
+  const auto* src = buffer_.data() + pos;
+  if (1 == stride) {
+    std::memcpy(static_cast<void*>(dest), src, first_read * sizeof(SampleType));
     std::memcpy(static_cast<void*>(dest + first_read),
                 buffer_.data(),
                 (num - first_read) * sizeof(SampleType));
-    read_ = num - first_read;
+  } else {
+    for (std::size_t i = 0; i < first_read; ++i) dest[i * stride] = src[i];
+    dest += first_read * stride;
+    src = buffer_.data();
+    for (std::size_t i = 0; i < num - first_read; ++i) dest[i * stride] = src[i];
   }
-  available_size_.fetch_add(res);
+}
+
+template <typename SampleType>
+std::size_t AudioRingBuffer<SampleType>::pop_samples(std::size_t num, SampleType* dest) {
+  auto read = read_.load(std::memory_order_relaxed);
+  std::size_t res = std::min(num, readable(read));
+  if (0 == res) return res;
+  if (nullptr != dest) copy_out(read, res, dest, 1);
+  read_.store(read + res, std::memory_order_release);
   return res;
 }
 
 template <typename SampleType>
 std::size_t AudioRingBuffer<SampleType>::read_samples(std::size_t num, SampleType* dest) {
-  std::size_t available = buffer_size_ - available_size_.load();
-  std::size_t res = num;
-  if (available < num) res = available;
+  auto read = read_.load(std::memory_order_relaxed);
+  std::size_t res = std::min(num, readable(read));
   if (0 == res || nullptr == dest) {
     return 0;
   }
-  auto first_read = buffer_size_ - read_;
-  if (first_read >= num) {  // one copy is enought
-    std::memcpy(static_cast<void*>(dest), buffer_.data() + read_, num * sizeof(SampleType));
-  } else {  // copy the end of the buffer, then the remaining samples at the beginning
-    std::memcpy(static_cast<void*>(dest), buffer_.data() + read_, first_read * sizeof(SampleType));
-    std::memcpy(static_cast<void*>(dest + first_read),
-                buffer_.data(),
-                (num - first_read) * sizeof(SampleType));
-  }
+  copy_out(read, res, dest, 1);
   return res;
 }
 
@@ -93,18 +123,12 @@ std::size_t AudioRingBuffer<SampleType>::read_samples_as_channel(std::size_t num
                                                                  SampleType* dest,
                                                                  unsigned int chan,
                                                                  unsigned int total_chan) {
-  std::size_t available = buffer_size_ - available_size_.load();
-  std::size_t res = num;
-  if (available < num) res = available;
+  auto read = read_.load(std::memory_order_relaxed);
+  std::size_t res = std::min(num, readable(read));
   if (0 == res || nullptr == dest) {
     return 0;
   }
-  auto read = read_;
-  for (std::size_t i = 0; i < res; ++i) {
-    dest[(i * total_chan) + (chan - 1)] = buffer_[read];
-    ++read;
-    if (buffer_size_ == read) read = 0;
-  }
+  copy_out(read, res, dest + (chan - 1), total_chan);
   return res;
 }
 
@@ -113,35 +137,28 @@ std::size_t AudioRingBuffer<SampleType>::pop_samples_as_channel(std::size_t num,
                                                                 SampleType* dest,
                                                                 unsigned int chan,
                                                                 unsigned int total_chan) {
-  std::size_t available = buffer_size_ - available_size_.load();
-  std::size_t res = num;
-  if (available < num) res = available;
+  auto read = read_.load(std::memory_order_relaxed);
+  std::size_t res = std::min(num, readable(read));
   if (0 == res) return res;
-  if (nullptr == dest) {
-    read_ = (read_ + res) % buffer_size_;
-    return res;
-  }
-  for (std::size_t i = 0; i < res; ++i) {
-    dest[(i * total_chan) + (chan - 1)] = buffer_[read_];
-    ++read_;
-    if (buffer_size_ == read_) read_ = 0;
-  }
-  available_size_.fetch_add(res);
+  if (nullptr != dest) copy_out(read, res, dest + (chan - 1), total_chan);
+  read_.store(read + res, std::memory_order_release);
   return res;
 }
 
 template <typename SampleType>
 std::size_t AudioRingBuffer<SampleType>::get_usage() {
-  return buffer_size_ - available_size_.load();
+  // read_ first, since write_ can only be ahead of it
+  auto read = read_.load(std::memory_order_acquire);
+  return write_.load(std::memory_order_acquire) - read;
 }
 
 template <typename SampleType>
 std::size_t AudioRingBuffer<SampleType>::shrink_to(std::size_t size) {
-  std::size_t available = buffer_size_ - available_size_.load();
+  auto read = read_.load(std::memory_order_relaxed);
+  std::size_t available = readable(read);
   if (available < size) return 0;
   std::size_t res = available - size;
-  read_ = (read_ + res) % buffer_size_;
-  available_size_.fetch_add(res);
+  read_.store(read + res, std::memory_order_release);
   return res;
 }
 
@@ -173,11 +173,9 @@ BoolLog fileutils::save(const std::string& content, const std::string& file_path
     On_scope_exit { g_error_free(error); };
     return BoolLog(false, error->message);
   }
-  // saving the save tree to the file
-  gchar* history = g_strdup(content.c_str());
-  g_output_stream_write(
-      (GOutputStream*)file_stream, history, sizeof(gchar) * strlen(history), nullptr, &error);
-  g_free(history);
+  // saving the content to the file, which can be binary
+  g_output_stream_write_all(
+      (GOutputStream*)file_stream, content.data(), content.size(), nullptr, nullptr, &error);
   if (error != nullptr) {
     On_scope_exit { g_error_free(error); };
     return BoolLog(false, error->message);
@@ -212,10 +210,10 @@ std::string fileutils::get_content(const std::string& file_path) {
   if (0 == size) {
     return std::string();
   }
-  std::string file_str;
-  file_str.reserve(size);
+  std::string file_str(static_cast<size_t>(size), '\0');
   file_stream.seekg(0, std::ios::beg);
-  file_str.assign((std::istreambuf_iterator<char>(file_stream)), std::istreambuf_iterator<char>());
+  file_stream.read(&file_str[0], size);
+  file_str.resize(file_stream.gcount());
   return file_str;
 }
 
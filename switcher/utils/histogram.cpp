@@ -0,0 +1,70 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include "./histogram.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace switcher {
+
+size_t Histogram::bucket_index(uint64_t value) {
+  if (value < kSubBuckets) return static_cast<size_t>(value);
+  // the exponent selects the power of two, the following kSubBucketBits bits the sub bucket
+  const unsigned exponent = 63 - __builtin_clzll(value);
+  const unsigned shift = exponent - kSubBucketBits;
+  return (shift + 1) * kSubBuckets + static_cast<size_t>((value >> shift) - kSubBuckets);
+}
+
+uint64_t Histogram::bucket_highest_value(size_t index) {
+  if (index < kSubBuckets) return index;
+  const unsigned shift = index / kSubBuckets - 1;
+  const uint64_t lowest = static_cast<uint64_t>(kSubBuckets + index % kSubBuckets) << shift;
+  return lowest + ((uint64_t(1) << shift) - 1);
+}
+
+void Histogram::record(uint64_t value) {
+  counts_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+  auto max = max_.load(std::memory_order_relaxed);
+  while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+  }
+}
+
+Histogram::Snapshot Histogram::take() {
+  Snapshot res;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    res.counts_[i] = counts_[i].exchange(0, std::memory_order_relaxed);
+    res.count_ += res.counts_[i];
+  }
+  res.max_ = max_.exchange(0, std::memory_order_relaxed);
+  return res;
+}
+
+uint64_t Histogram::Snapshot::value_at(double percentile) const {
+  if (0 == count_) return 0;
+  auto rank = static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100 * count_));
+  if (0 == rank) rank = 1;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    seen += counts_[i];
+    if (seen >= rank) return std::min(bucket_highest_value(i), max_);
+  }
+  return max_;
+}
+
+}  // namespace switcher
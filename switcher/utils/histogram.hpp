@@ -0,0 +1,85 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __SWITCHER_HISTOGRAM_H__
+#define __SWITCHER_HISTOGRAM_H__
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace switcher {
+
+/**
+ * Histogram of unsigned values with buckets of constant relative width, in the spirit of
+ * HdrHistogram. Values are recorded with a few relaxed atomic operations, so that recording
+ * from real time threads is wait-free and does not need a mutex.
+ * Each power of two is split into 2^kSubBucketBits buckets, values are then known with
+ * a relative precision of 1 / 2^kSubBucketBits.
+ */
+class Histogram {
+ public:
+  static constexpr unsigned kSubBucketBits{3};
+  static constexpr size_t kSubBuckets{1u << kSubBucketBits};
+  static constexpr size_t kNumBuckets{(64 - kSubBucketBits + 1) * kSubBuckets};
+
+  /**
+   * Recorded values, taken out of a Histogram.
+   */
+  class Snapshot {
+   public:
+    uint64_t count() const { return count_; }
+    uint64_t max() const { return max_; }
+    /**
+     * Get the value at a given percentile. The returned value is the highest value of the
+     * bucket, or the maximum recorded value if lower.
+     * \param percentile Percentile, between 0 and 100.
+     * \return The value, or 0 if nothing has been recorded.
+     */
+    uint64_t value_at(double percentile) const;
+
+   private:
+    friend class Histogram;
+    std::array<uint64_t, kNumBuckets> counts_{};
+    uint64_t count_{0};
+    uint64_t max_{0};
+  };
+
+  /**
+   * Record a value. Can be called concurrently from any thread.
+   */
+  void record(uint64_t value);
+
+  /**
+   * Take out the recorded values, leaving the histogram empty. Values recorded concurrently are
+   * either in the returned snapshot or kept for the next one.
+   */
+  Snapshot take();
+
+  static size_t bucket_index(uint64_t value);
+  static uint64_t bucket_highest_value(size_t index);
+
+ private:
+  std::array<std::atomic<uint32_t>, kNumBuckets> counts_{};
+  std::atomic<uint64_t> max_{0};
+};
+
+}  // namespace switcher
+#endif
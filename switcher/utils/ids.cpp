@@ -41,8 +41,6 @@ Ids::id_t Ids::allocate_id() {
   return cur_id_;
 }
 
-void Ids::release_last_allocated_id() { ids_.erase(ids_.end() - 1); }
-
 bool Ids::release_id(id_t id) {
   auto it = std::find(ids_.begin(), ids_.end(), id);
   if (ids_.end() == it) {
@@ -51,11 +51,6 @@ class Ids {
    * \return The new identifier.
    */
   id_t allocate_id();
-  /**
-   * Release the last allocated id.
-   *
-   */
-  void release_last_allocated_id();
   /**
    * Release an already allocated identifier.
    *
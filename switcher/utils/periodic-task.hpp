@@ -20,53 +20,37 @@
 #ifndef __SWITCHER_PERIODIC_TASK_H__
 #define __SWITCHER_PERIODIC_TASK_H__
 
-#include <atomic>
 #include <chrono>
-#include <future>
+#include <functional>
+#include "./scheduler.hpp"
 
 namespace switcher {
 
+/**
+ * PeriodicTask invokes a task periodically until destruction. Tasks are executed by a Scheduler,
+ * by default the one shared by all PeriodicTask instances, so that the number of threads does
+ * not grow with the number of tasks. The task is guaranteed to not be running after destruction.
+ */
 template <typename T = std::chrono::milliseconds>
 class PeriodicTask {
  public:
   using task_t = std::function<void()>;
 
   PeriodicTask() = delete;
-  PeriodicTask(task_t task, T period)
-      : task_(task),
-        period_(period),
-        fut_(task ? std::async(std::launch::async, [this]() { this->do_work(); })
-                  : std::future<void>()) {}
+  PeriodicTask(task_t task, T period, Scheduler::ptr scheduler = Scheduler::get_default())
+      : scheduler_(scheduler),
+        id_(task ? scheduler_->schedule(
+                       task, std::chrono::duration_cast<Scheduler::clock::duration>(period))
+                 : 0) {}
   ~PeriodicTask() {
-    {
-      canceled_.store(true);
-      std::unique_lock<std::mutex> lock(cv_m_);
-      cv_.notify_one();
-    }
+    if (0 != id_) scheduler_->cancel(id_);
   }
+  PeriodicTask(const PeriodicTask&) = delete;
+  PeriodicTask& operator=(const PeriodicTask&) = delete;
 
  private:
-  task_t task_;
-  T period_;
-  std::condition_variable cv_{};
-  std::mutex cv_m_{};
-  std::atomic<bool> canceled_{false};
-  std::future<void> fut_{};
-
-  void do_work() {
-    auto exec_duration = std::chrono::system_clock::duration(0);
-    while (!canceled_.load()) {
-      std::unique_lock<std::mutex> lock(cv_m_);
-      auto wait_duration = period_ - exec_duration;
-      // If this happens it means the task is too long for the desired period.
-      if (wait_duration.count() < 0) wait_duration = std::chrono::system_clock::duration(0);
-      if (!cv_.wait_for(lock, wait_duration, [this]() { return canceled_.load(); })) {
-        auto start_clock = std::chrono::system_clock::now();
-        task_();
-        exec_duration = std::chrono::system_clock::now() - start_clock;
-      }
-    }
-  }
+  Scheduler::ptr scheduler_;
+  Scheduler::id_t id_;
 };
 
 }  // namespace switcher
@@ -0,0 +1,129 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include "./scheduler.hpp"
+#include <algorithm>
+
+namespace switcher {
+
+namespace {
+Scheduler::ptr get_shared(std::weak_ptr<Scheduler>* scheduler, std::mutex* mtx) {
+  std::lock_guard<std::mutex> lock(*mtx);
+  auto res = scheduler->lock();
+  if (res) return res;
+  res = std::make_shared<Scheduler>(std::max(4u, std::thread::hardware_concurrency()));
+  *scheduler = res;
+  return res;
+}
+}  // namespace
+
+Scheduler::ptr Scheduler::get_default() {
+  static std::mutex mtx;
+  static std::weak_ptr<Scheduler> scheduler;
+  return get_shared(&scheduler, &mtx);
+}
+
+Scheduler::ptr Scheduler::get_blocking() {
+  static std::mutex mtx;
+  static std::weak_ptr<Scheduler> scheduler;
+  return get_shared(&scheduler, &mtx);
+}
+
+Scheduler::Scheduler(unsigned int num_threads) {
+  for (unsigned int i = 0; i < num_threads; ++i)
+    workers_.emplace_back([state = state_]() { work(state); });
+}
+
+Scheduler::~Scheduler() {
+  {
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->quit = true;
+  }
+  state_->due_cv.notify_all();
+  for (auto& worker : workers_) {
+    // the last reference to the scheduler can be released by a task
+    if (worker.get_id() == std::this_thread::get_id())
+      worker.detach();
+    else
+      worker.join();
+  }
+}
+
+Scheduler::id_t Scheduler::schedule(task_t task, clock::duration period) {
+  std::lock_guard<std::mutex> lock(state_->mtx);
+  auto id = state_->next_id++;
+  state_->tasks.emplace(id, std::make_shared<Task>(Task{task, period}));
+  state_->due.emplace(clock::now() + period, id);
+  state_->due_cv.notify_one();
+  return id;
+}
+
+void Scheduler::cancel(id_t id) {
+  // declared before the lock: releasing the task function may cancel other tasks
+  std::shared_ptr<Task> task;
+  std::unique_lock<std::mutex> lock(state_->mtx);
+  auto found = state_->tasks.find(id);
+  if (state_->tasks.end() == found) return;
+  task = found->second;
+  // the pending execution, if any, is discarded when due
+  state_->tasks.erase(found);
+  if (task->runner == std::this_thread::get_id()) return;
+  state_->done_cv.wait(lock, [&]() { return !task->running; });
+}
+
+void Scheduler::work(std::shared_ptr<State> state) {
+  std::unique_lock<std::mutex> lock(state->mtx);
+  while (!state->quit) {
+    if (state->due.empty()) {
+      state->due_cv.wait(lock);
+      continue;
+    }
+    auto next = state->due.top();
+    if (clock::now() < next.first) {
+      state->due_cv.wait_until(lock, next.first);
+      continue;
+    }
+    state->due.pop();
+    auto found = state->tasks.find(next.second);
+    if (state->tasks.end() == found) continue;  // canceled
+    auto task = found->second;
+    task->running = true;
+    task->runner = std::this_thread::get_id();
+    lock.unlock();
+    task->fun();
+    lock.lock();
+    task->running = false;
+    task->runner = std::thread::id();
+    state->done_cv.notify_all();
+    if (state->tasks.end() == state->tasks.find(next.second)) {
+      // canceled meanwhile, the task function is released out of the lock
+      lock.unlock();
+      task.reset();
+      lock.lock();
+      continue;
+    }
+    // keep the execution rate, without trying to catch up missed executions
+    auto due = std::max(next.first + task->period, clock::now());
+    state->due.emplace(due, next.second);
+    // another worker may be waiting for a later due time
+    state->due_cv.notify_one();
+  }
+}
+
+}  // namespace switcher
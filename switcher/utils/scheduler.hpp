@@ -0,0 +1,116 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __SWITCHER_SCHEDULER_H__
+#define __SWITCHER_SCHEDULER_H__
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace switcher {
+
+/**
+ * Scheduler runs periodic tasks from a fixed pool of threads. Pending executions are kept
+ * ordered by due time, so that idle threads wait for the next due task only. A task is never
+ * executed concurrently with itself.
+ */
+class Scheduler {
+ public:
+  using ptr = std::shared_ptr<Scheduler>;
+  using task_t = std::function<void()>;
+  using id_t = size_t;
+  using clock = std::chrono::steady_clock;
+
+  /**
+   * Get the scheduler shared by all PeriodicTask. It is created when needed and destroyed when
+   * no more tasks or Switcher instances are using it. Tasks run there are expected to be short,
+   * such as stat updates.
+   */
+  static Scheduler::ptr get_default();
+
+  /**
+   * Get the scheduler shared by tasks that may block for a while, such as network requests or
+   * pipeline relaunches. Its threads are separate from the default scheduler ones, so that
+   * blocking tasks do not delay short ones. It is created when needed and destroyed when no more
+   * tasks are using it.
+   */
+  static Scheduler::ptr get_blocking();
+
+  /**
+   * Construct a Scheduler.
+   * \param num_threads Number of threads executing tasks.
+   */
+  explicit Scheduler(unsigned int num_threads);
+  ~Scheduler();
+  Scheduler(const Scheduler&) = delete;
+  Scheduler& operator=(const Scheduler&) = delete;
+
+  /**
+   * Schedule a periodic task. The first execution happens one period after scheduling.
+   * If an execution lasts longer than the period, the next one is started immediately.
+   * \param task   The function to execute.
+   * \param period The execution period.
+   * \return The task id, to be used for cancellation.
+   */
+  id_t schedule(task_t task, clock::duration period);
+
+  /**
+   * Cancel a task. If the task is executing, wait for the execution to finish, unless cancel is
+   * invoked from the task itself.
+   * \param id The task id.
+   */
+  void cancel(id_t id);
+
+  size_t get_num_threads() const { return workers_.size(); }
+
+ private:
+  struct Task {
+    task_t fun;
+    clock::duration period;
+    bool running{false};
+    std::thread::id runner{};
+  };
+  using due_t = std::pair<clock::time_point, id_t>;
+
+  // shared with the workers, which outlive the scheduler when a task releases the last reference
+  struct State {
+    std::mutex mtx{};
+    std::condition_variable due_cv{};   //!< Workers wait here for the next due task.
+    std::condition_variable done_cv{};  //!< Cancellation waits here for running executions.
+    std::unordered_map<id_t, std::shared_ptr<Task>> tasks{};
+    std::priority_queue<due_t, std::vector<due_t>, std::greater<due_t>> due{};
+    id_t next_id{1};
+    bool quit{false};
+  };
+  std::shared_ptr<State> state_{std::make_shared<State>()};
+  std::vector<std::thread> workers_{};
+
+  static void work(std::shared_ptr<State> state);
+};
+
+}  // namespace switcher
+#endif
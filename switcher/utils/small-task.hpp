@@ -0,0 +1,117 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __SWITCHER_SMALL_TASK_H__
+#define __SWITCHER_SMALL_TASK_H__
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace switcher {
+
+/**
+ * SmallTask is a move-only wrapper for a callable taking no argument. Unlike std::function,
+ * callables fitting in kInlineSize bytes (typically lambdas capturing a few pointers) are stored
+ * inline, so that queuing them does not allocate.
+ */
+class SmallTask {
+ public:
+  static constexpr size_t kInlineSize = 6 * sizeof(void*);
+
+  SmallTask() = default;
+  SmallTask(std::nullptr_t) {}
+  template <typename F,
+            typename std::enable_if<!std::is_same<std::decay_t<F>, SmallTask>::value>::type* =
+                nullptr>
+  SmallTask(F&& fun) {
+    using fun_t = std::decay_t<F>;
+    if constexpr (is_inline<fun_t>()) {
+      new (&storage_) fun_t(std::forward<F>(fun));
+      ops_ = &InlineOps<fun_t>::ops;
+    } else {
+      new (&storage_) fun_t*(new fun_t(std::forward<F>(fun)));
+      ops_ = &HeapOps<fun_t>::ops;
+    }
+  }
+  SmallTask(SmallTask&& other) noexcept : ops_(other.ops_) {
+    if (ops_) ops_->move(&storage_, &other.storage_);
+    other.ops_ = nullptr;
+  }
+  SmallTask& operator=(SmallTask&& other) noexcept {
+    if (this == &other) return *this;
+    reset();
+    ops_ = other.ops_;
+    if (ops_) ops_->move(&storage_, &other.storage_);
+    other.ops_ = nullptr;
+    return *this;
+  }
+  SmallTask(const SmallTask&) = delete;
+  SmallTask& operator=(const SmallTask&) = delete;
+  ~SmallTask() { reset(); }
+
+  explicit operator bool() const { return nullptr != ops_; }
+  void operator()() { ops_->call(&storage_); }
+
+ private:
+  struct Ops {
+    void (*call)(void*);
+    void (*move)(void* dst, void* src);  //!< Move construct into dst and destroy src.
+    void (*destroy)(void*);
+  };
+
+  template <typename F>
+  static constexpr bool is_inline() {
+    return sizeof(F) <= kInlineSize && alignof(F) <= alignof(std::max_align_t) &&
+           std::is_nothrow_move_constructible<F>::value;
+  }
+
+  template <typename F>
+  struct InlineOps {
+    static F* get(void* storage) { return std::launder(static_cast<F*>(storage)); }
+    static void call(void* storage) { (*get(storage))(); }
+    static void move(void* dst, void* src) {
+      new (dst) F(std::move(*get(src)));
+      get(src)->~F();
+    }
+    static void destroy(void* storage) { get(storage)->~F(); }
+    static constexpr Ops ops{&call, &move, &destroy};
+  };
+
+  template <typename F>
+  struct HeapOps {
+    static F*& get(void* storage) { return *std::launder(static_cast<F**>(storage)); }
+    static void call(void* storage) { (*get(storage))(); }
+    static void move(void* dst, void* src) { new (dst) F*(get(src)); }
+    static void destroy(void* storage) { delete get(storage); }
+    static constexpr Ops ops{&call, &move, &destroy};
+  };
+
+  void reset() {
+    if (ops_) ops_->destroy(&storage_);
+    ops_ = nullptr;
+  }
+
+  std::aligned_storage_t<kInlineSize, alignof(std::max_align_t)> storage_;
+  const Ops* ops_{nullptr};
+};
+
+}  // namespace switcher
+#endif
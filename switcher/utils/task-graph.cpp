@@ -0,0 +1,88 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include "./task-graph.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace switcher {
+
+TaskGraph::id_t TaskGraph::add_task(task_t task) {
+  tasks_.push_back(Task{std::move(task)});
+  return tasks_.size() - 1;
+}
+
+void TaskGraph::add_dependency(id_t task, id_t dependency) {
+  tasks_[dependency].dependents.push_back(task);
+  ++tasks_[task].num_dependencies;
+}
+
+void TaskGraph::run(unsigned int num_threads) {
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::set<id_t> ready;
+  std::vector<size_t> pending(tasks_.size());
+  std::vector<bool> started(tasks_.size(), false);
+  size_t remaining = tasks_.size();
+  size_t running = 0;
+  for (id_t id = 0; id < tasks_.size(); ++id) {
+    pending[id] = tasks_[id].num_dependencies;
+    if (0 == pending[id]) ready.insert(id);
+  }
+
+  auto work = [&]() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (0 != remaining) {
+      if (ready.empty() && 0 == running) {
+        // dependency cycle, start the first task not yet started
+        ready.insert(std::distance(started.begin(),
+                                   std::find(started.begin(), started.end(), false)));
+      }
+      if (ready.empty()) {
+        cv.wait(lock);
+        continue;
+      }
+      auto id = *ready.begin();
+      ready.erase(ready.begin());
+      started[id] = true;
+      ++running;
+      lock.unlock();
+      tasks_[id].fun();
+      lock.lock();
+      --running;
+      --remaining;
+      for (auto dependent : tasks_[id].dependents) {
+        if (0 == --pending[dependent] && !started[dependent]) ready.insert(dependent);
+      }
+      cv.notify_all();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  auto num_workers = std::min<size_t>(std::max(1u, num_threads), tasks_.size());
+  for (size_t i = 1; i < num_workers; ++i) workers.emplace_back(work);
+  work();
+  for (auto& worker : workers) worker.join();
+}
+
+}  // namespace switcher
@@ -0,0 +1,74 @@
+/*
+ * This file is part of libswitcher.
+ *
+ * libswitcher is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __SWITCHER_TASK_GRAPH_H__
+#define __SWITCHER_TASK_GRAPH_H__
+
+#include <functional>
+#include <vector>
+
+namespace switcher {
+
+/**
+ * TaskGraph runs a set of one-shot tasks on several threads, a task being started only once all
+ * the tasks it depends on are done. Among ready tasks, the first added is started first, so that
+ * a single thread runs the tasks in their order of addition whenever dependencies allow it.
+ *
+ * Dependency cycles do not block the execution: when no task is ready or running, the first task
+ * not yet started is run regardless of its dependencies.
+ */
+class TaskGraph {
+ public:
+  using id_t = size_t;
+  using task_t = std::function<void()>;
+
+  /**
+   * Add a task to the graph.
+   * \param task The function to execute.
+   * \return The task id, to be used for declaring dependencies.
+   */
+  id_t add_task(task_t task);
+
+  /**
+   * Declare that a task must not start before another one is done.
+   * \param task       The dependent task.
+   * \param dependency The task to wait for.
+   */
+  void add_dependency(id_t task, id_t dependency);
+
+  /**
+   * Run all the tasks and return when they are all done. The calling thread executes tasks
+   * along with num_threads - 1 additional threads.
+   * \param num_threads The maximum number of tasks running concurrently.
+   */
+  void run(unsigned int num_threads);
+
+  size_t size() const { return tasks_.size(); }
+
+ private:
+  struct Task {
+    task_t fun;
+    std::vector<id_t> dependents{};
+    size_t num_dependencies{0};
+  };
+  std::vector<Task> tasks_{};
+};
+
+}  // namespace switcher
+#endif
@@ -20,192 +20,141 @@
 #ifndef __SWITCHER_THREADED_WRAPPER_H__
 #define __SWITCHER_THREADED_WRAPPER_H__
 
-#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <functional>
-#include <future>
-#include <iostream>
 #include <memory>
-#include <vector>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include "./small-task.hpp"
 
 namespace switcher {
 
 class ThreadedWrapperVoid {};
 
+/**
+ * ThreadedWrapper owns a thread and an instance of T living in this thread. Functions are
+ * executed in this thread, in the order they were submitted, either synchronously (invoke and
+ * run return when the function has been executed) or asynchronously (invoke_async and run_async).
+ * The thread sleeps until a function is submitted.
+ */
 template <typename T = ThreadedWrapperVoid>
 class ThreadedWrapper {
  public:
   template <typename... Args>
-  ThreadedWrapper(Args... args) : fut_(std::async(std::launch::async, [&]() { threaded_wrap(); })) {
-    do_sync_task([&]() { member_.reset(new T(args...)); });
+  ThreadedWrapper(Args... args) : thread_([this]() { work(); }) {
+    run([&]() { member_.reset(new T(args...)); });
   }
   ~ThreadedWrapper() {
-    do_sync_task([&]() {
-      run_async_tasks();
-      // destroy member from the thread:
+    // functions submitted before are executed before destroying member
+    run([this]() {
       member_.reset(nullptr);
-      // stop the thread
-      canceled_.store(true);
+      quit_ = true;
     });
-    // wait for the thread
-    if (fut_.valid()) fut_.get();
+    thread_.join();
   }
+  ThreadedWrapper(const ThreadedWrapper&) = delete;
+  ThreadedWrapper& operator=(const ThreadedWrapper&) = delete;
 
-  void threaded_wrap() {
-    // work loop
-    while (!canceled_.load()) {
-      std::unique_lock<std::mutex> lock(cv_m_);
-
-      // async tasks
-      run_async_tasks();
-
-      // sync task
-      if (nullptr != sync_task_ && sync_task_) {
-        sync_task_();
-        sync_task_ = nullptr;
-        std::unique_lock<std::mutex> lock2(task_done_m_);
-        task_done_ = true;
-        task_done_cv_.notify_one();
-      }
-      cv_.wait_for(lock, std::chrono::milliseconds(1));
-    }
+  template <typename R = void, typename F>
+  R invoke(F&& fun) {
+    return run<R>([&]() { return fun(this->member_.get()); });
   }
 
-  template <typename R = void,
-            typename std::enable_if<std::is_same<void, R>::value>::type* = nullptr>
-  R invoke(std::function<void(T*)> fun) {
-    auto task = [&]() {
-      fun(this->member_.get());
-      std::unique_lock<std::mutex> lock(this->task_done_m_);
-      this->task_done_cv_.notify_one();
-    };
-    do_sync_task(task);
-    return;
+  template <typename F>
+  void invoke_async(F&& fun) {
+    push([this, fun = std::forward<F>(fun)]() mutable { fun(this->member_.get()); });
   }
 
-  // invoke with a return type
-  template <typename R, typename std::enable_if<!std::is_same<void, R>::value>::type* = nullptr>
-  R invoke(std::function<R(T*)> fun) {
-    R res;
-    auto task = [&]() {
-      res = fun(this->member_.get());
-      std::unique_lock<std::mutex> lock(this->task_done_m_);
-      this->task_done_cv_.notify_one();
-    };
-    do_sync_task(task);
-    return res;
-  }
-
-  void invoke_async(std::function<void(T*)> fun) {
-    {
-      std::unique_lock<std::mutex> lock_sync(async_mtx_);
-      async_tasks_.emplace_back([=]() { fun(this->member_.get()); });
+  template <typename R = void, typename F>
+  R run(F&& fun) {
+    if constexpr (std::is_void<R>::value) {
+      do_sync_task(fun);
+    } else {
+      R res{};
+      auto task = [&]() { res = fun(); };
+      do_sync_task(task);
+      return res;
     }
-    return;
-  }
-
-  // returning functions
-  template <typename R, typename std::enable_if<!std::is_same<void, R>::value>::type* = nullptr>
-  R run(std::function<R()> fun) {
-    R res;
-    auto task = [&]() {
-      res = fun();
-      std::unique_lock<std::mutex> lock(this->task_done_m_);
-      this->task_done_cv_.notify_one();
-    };
-    do_sync_task(task);
-    return res;
   }
 
   void wait_done() {
-    auto task = [&]() {
-      std::unique_lock<std::mutex> lock(this->task_done_m_);
-      this->task_done_cv_.notify_one();
-    };
-    do_sync_task(task);
-  }
-
-  template <typename R, typename std::enable_if<!std::is_same<void, R>::value>::type* = nullptr>
-  void run_async(std::function<void()> fun, std::function<void(R)> on_result) {
-    {
-      std::unique_lock<std::mutex> lock_sync(async_mtx_);
-      async_tasks_.emplace_back([=]() {
-        if (on_result)
-          on_result(fun());
-        else
-          fun();
-      });
-    }
-    return;
+    run([]() {});
   }
 
   // void functions
   template <typename R = void,
-            typename std::enable_if<std::is_same<void, R>::value>::type* = nullptr>
-  R run(std::function<void()> fun) {
-    auto task = [&]() {
+            typename F,
+            typename std::enable_if<std::is_void<R>::value>::type* = nullptr>
+  void run_async(F&& fun, std::function<void()> on_done = nullptr) {
+    if (!on_done) return push(std::forward<F>(fun));
+    push([fun = std::forward<F>(fun), on_done = std::move(on_done)]() mutable {
       fun();
-      std::unique_lock<std::mutex> lock(this->task_done_m_);
-      this->task_done_cv_.notify_one();
-    };
-    do_sync_task(task);
-    return;
+      on_done();
+    });
   }
 
-  template <typename R = void,
-            typename std::enable_if<std::is_same<void, R>::value>::type* = nullptr>
-  void run_async(std::function<void()> fun, std::function<void()> on_done = nullptr) {
-    {
-      std::unique_lock<std::mutex> lock_sync(async_mtx_);
-      async_tasks_.emplace_back([=]() {
-        if (on_done) {
-          fun();
-          on_done();
-        } else {
-          fun();
-        }
-      });
-    }
-    return;
+  // returning functions
+  template <typename R,
+            typename F,
+            typename std::enable_if<!std::is_void<R>::value>::type* = nullptr>
+  void run_async(F&& fun, std::function<void(R)> on_result) {
+    push([fun = std::forward<F>(fun), on_result = std::move(on_result)]() mutable {
+      if (on_result)
+        on_result(fun());
+      else
+        fun();
+    });
   }
 
  private:
-  std::unique_ptr<T> member_;
-  // sync task
-  std::function<void()> sync_task_{nullptr};
-  std::mutex cv_m_{};
-  std::condition_variable cv_{};
-  std::mutex sync_mtx_{};
-  std::mutex task_done_m_{};
-  std::condition_variable task_done_cv_{};
-  bool task_done_{false};
-  // async task
-  std::mutex async_mtx_{};
-  std::vector<std::function<void()>> async_tasks_{};
-
-  // thread
-  std::atomic<bool> canceled_{false};
-  std::future<void> fut_;
-
-  void do_sync_task(std::function<void()> fun) {
-    std::unique_lock<std::mutex> lock_sync(sync_mtx_);
-    {
-      std::unique_lock<std::mutex> lock2(cv_m_);
-      sync_task_ = fun;
-      cv_.notify_one();
-      while (!task_done_) {
-        task_done_cv_.wait(lock2);
-      }
+  std::unique_ptr<T> member_{};
+  std::mutex mtx_{};
+  std::condition_variable work_cv_{};  //!< The thread waits here for tasks.
+  std::condition_variable done_cv_{};  //!< Synchronous callers wait here for their task.
+  std::deque<SmallTask> tasks_{};
+  bool quit_{false};  //!< Only accessed from the thread.
+  std::thread thread_;  // last member, started once others are initialized
+
+  void work() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (!quit_) {
+      work_cv_.wait(lock, [this]() { return !tasks_.empty(); });
+      auto task = std::move(tasks_.front());
+      tasks_.pop_front();
+      lock.unlock();
+      task();
+      // release captures before taking the lock again
+      task = nullptr;
+      lock.lock();
     }
-    task_done_ = false;
   }
 
-  void run_async_tasks() {
-    std::vector<std::function<void()>> tasks_to_do{};
+  void push(SmallTask&& task) {
     {
-      std::unique_lock<std::mutex> lock_sync(async_mtx_);
-      std::swap(tasks_to_do, async_tasks_);
+      std::lock_guard<std::mutex> lock(mtx_);
+      tasks_.emplace_back(std::move(task));
     }
-    for (auto& it : tasks_to_do) it();
+    work_cv_.notify_one();
+  }
+
+  template <typename F>
+  void do_sync_task(F& fun) {
+    // a synchronous call from the thread itself would wait forever
+    if (std::this_thread::get_id() == thread_.get_id()) {
+      fun();
+      return;
+    }
+    bool done = false;
+    push([&]() {
+      fun();
+      std::lock_guard<std::mutex> lock(mtx_);
+      done = true;
+      done_cv_.notify_all();
+    });
+    std::unique_lock<std::mutex> lock(mtx_);
+    done_cv_.wait(lock, [&]() { return done; });
   }
 };
 
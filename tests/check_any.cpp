@@ -0,0 +1,95 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#undef NDEBUG  // get assert in release mode
+
+#include <cassert>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "switcher/utils/any.hpp"
+
+using namespace switcher;
+
+// larger than the inline storage
+struct Large {
+  std::string strings[4]{};
+  friend std::ostream& operator<<(std::ostream& os, const Large& large) {
+    return os << large.strings[0];
+  }
+};
+
+int main() {
+  {  // arithmetic values
+    Any i(42);
+    assert(AnyCategory::INTEGRAL == i.get_category());
+    assert(42 == i.copy_as<int>());
+    assert(42.0 == i.copy_as<double>());
+    Any d(2.5);
+    assert(AnyCategory::FLOATING_POINT == d.get_category());
+    assert(2 == d.copy_as<int>());
+    Any ld(static_cast<long double>(1.5));
+    assert(1.5 == ld.copy_as<double>());
+    Any b(true);
+    assert(AnyCategory::BOOLEAN == b.get_category());
+    assert(b.copy_as<bool>());
+    assert("42" == Any::to_string(i));
+    assert("null" == Any::to_string(Any()));
+  }
+
+  {  // short and long strings, and values larger than the inline storage
+    std::string long_string(1000, 'a');
+    Large large;
+    large.strings[0] = "large";
+    std::vector<Any> values{Any(std::string("short")), Any(long_string), Any(large)};
+    for (int i = 0; i < 100; ++i) values.push_back(values[i % 3]);  // copies and moves
+    for (size_t i = 0; i < values.size(); ++i) {
+      if (i % 3 == 0) assert(values[i].as<std::string>() == "short");
+      if (i % 3 == 1) assert(values[i].as<std::string>() == long_string);
+      if (i % 3 == 2) assert(values[i].as<Large>().strings[0] == "large");
+    }
+    assert(values[0].is<std::string>());
+    assert(!values[0].is<Large>());
+  }
+
+  {  // copies, moves and assignments between stored and allocated values
+    Any small(std::string("small"));
+    Any large(Large{});
+    Any copy(small);
+    assert(copy.as<std::string>() == "small");
+    Any moved(std::move(copy));
+    assert(moved.as<std::string>() == "small");
+    assert(copy.is_null());
+    moved = large;
+    assert(moved.is<Large>());
+    moved = small;
+    assert(moved.as<std::string>() == "small");
+    moved = std::move(large);
+    assert(moved.is<Large>());
+    assert(large.is_null());
+    moved = Any(7);
+    assert(7 == moved.copy_as<int>());
+    const Any& self = moved;
+    moved = self;
+    assert(7 == moved.copy_as<int>());
+    moved = Any();
+    assert(moved.is_null());
+  }
+
+  return 0;
+}
@@ -0,0 +1,49 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#undef NDEBUG  // get assert in release mode
+
+#include <cassert>
+#include <vector>
+#include "switcher/utils/audio-interleave.hpp"
+
+using namespace switcher::utils;
+
+int main() {
+  // channel and frame counts around the SIMD block sizes
+  for (std::size_t num_channels : {1, 2, 3, 4, 5, 7, 8, 9, 12, 13, 16, 17, 64, 65, 128}) {
+    for (std::size_t num_frames : {0, 1, 3, 4, 7, 8, 9, 33, 256}) {
+      std::vector<std::vector<float>> channels(num_channels, std::vector<float>(num_frames));
+      std::vector<const float*> srcs;
+      for (std::size_t chan = 0; chan < num_channels; ++chan) {
+        for (std::size_t frame = 0; frame < num_frames; ++frame)
+          channels[chan][frame] = static_cast<float>(chan * 1000 + frame);
+        srcs.push_back(channels[chan].data());
+      }
+      std::vector<float> interleaved(num_channels * num_frames, -1.f);
+      interleave(srcs.data(), num_channels, num_frames, interleaved.data());
+      std::vector<float> expected(num_channels * num_frames, -2.f);
+      interleave_scalar(srcs.data(), num_channels, num_frames, expected.data());
+      assert(interleaved == expected);
+      for (std::size_t frame = 0; frame < num_frames; ++frame)
+        for (std::size_t chan = 0; chan < num_channels; ++chan)
+          assert(interleaved[frame * num_channels + chan] == channels[chan][frame]);
+    }
+  }
+  return 0;
+}
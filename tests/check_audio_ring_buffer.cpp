@@ -0,0 +1,94 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#undef NDEBUG  // get assert in release mode
+
+#include <cassert>
+#include <thread>
+#include <vector>
+#include "switcher/utils/audio-frame-ring-buffer.hpp"
+#include "switcher/utils/audio-ring-buffer.hpp"
+
+using namespace switcher::utils;
+
+int main() {
+  {  // bulk put wraps around the end of the buffer
+    AudioRingBuffer<int> rb(10);
+    std::vector<int> interleaved{0, 100, 1, 101, 2, 102, 3, 103, 4, 104, 5, 105, 6, 106, 7, 107};
+    assert(8 == rb.put_samples(interleaved.data(), 8, 2));
+    std::vector<int> out(8);
+    assert(6 == rb.pop_samples(6, out.data()));
+    assert(8 == rb.put_samples(interleaved.data() + 1, 8, 2));
+    assert(10 == rb.get_usage());
+    assert(0 == rb.put_samples(interleaved.data(), 1));
+    std::vector<int> as_channel(20);
+    assert(10 == rb.pop_samples_as_channel(10, as_channel.data(), 2, 2));
+    std::vector<int> expected{6, 7, 100, 101, 102, 103, 104, 105, 106, 107};
+    for (int i = 0; i < 10; ++i) assert(as_channel[2 * i + 1] == expected[i]);
+    assert(0 == rb.get_usage());
+  }
+
+  {  // frames are de-interleaved into one buffer per channel
+    const unsigned int channels = 3;
+    AudioFrameRingBuffer<int> rb(channels, 50);
+    std::vector<int> frames;
+    for (int frame = 0; frame < 40; ++frame)
+      for (unsigned int chan = 0; chan < channels; ++chan) frames.push_back(100 * chan + frame);
+    assert(40 == rb.put_frames(frames.data(), 40));
+    assert(10 == rb.put_frames(frames.data(), 40));
+    std::vector<std::vector<int>> outs(channels, std::vector<int>(100, -1));
+    std::vector<int*> dests{outs[0].data(), nullptr, outs[2].data()};
+    assert(45 == rb.pop_frames(45, dests.data()));
+    // the next batch wraps around the end of the buffer
+    assert(40 == rb.put_frames(frames.data(), 40));
+    assert(45 == rb.get_usage());
+    assert(5 == rb.shrink_to(40));
+    dests = {outs[0].data() + 45, nullptr, outs[2].data() + 45};
+    assert(40 == rb.pop_frames(100, dests.data()));
+    for (int i = 0; i < 85; ++i) {
+      auto frame = i < 40 ? i : (i < 45 ? i - 40 : i - 45);
+      assert(outs[0][i] == frame);
+      assert(outs[2][i] == 200 + frame);
+    }
+    assert(-1 == outs[1][0]);
+  }
+
+  {  // single producer and single consumer threads
+    const int total = 1000000;
+    AudioRingBuffer<int> rb(1000);
+    std::thread producer([&]() {
+      std::vector<int> buf(64);
+      int next = 0;
+      while (next < total) {
+        for (auto& it : buf) it = next++;
+        std::size_t done = 0;
+        while (done < buf.size()) {
+          done += rb.put_samples(buf.data() + done, buf.size() - done);
+          std::this_thread::yield();
+        }
+      }
+    });
+    std::vector<int> buf(100);
+    int expected = 0;
+    while (expected < total) {
+      auto num = rb.pop_samples(buf.size(), buf.data());
+      for (std::size_t i = 0; i < num; ++i) assert(buf[i] == expected++);
+    }
+    producer.join();
+  }
+  return 0;
+}
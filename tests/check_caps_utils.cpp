@@ -0,0 +1,64 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#undef NDEBUG  // get assert in release mode
+
+#include <cassert>
+#include <string>
+
+#include "switcher/shmdata/caps/utils.hpp"
+
+using namespace switcher::shmdata;
+
+std::size_t frame_size(const std::string& format, int width, int height) {
+  return caps::get_raw_video_frame_size("video/x-raw, format=(string)" + format +
+                                        ", width=(int)" + std::to_string(width) +
+                                        ", height=(int)" + std::to_string(height) +
+                                        ", framerate=(fraction)30/1");
+}
+
+int main() {
+  // planar formats
+  assert(460800 == frame_size("I420", 640, 480));
+  assert(460800 == frame_size("YV12", 640, 480));
+  assert(460800 == frame_size("NV12", 640, 480));
+  assert(614400 == frame_size("Y42B", 640, 480));
+  assert(921600 == frame_size("Y444", 640, 480));
+
+  // packed formats
+  assert(6220800 == frame_size("RGB", 1920, 1080));
+  assert(8294400 == frame_size("RGBA", 1920, 1080));
+  assert(614400 == frame_size("YUY2", 640, 480));
+  assert(614400 == frame_size("RGB16", 640, 480));
+  assert(307200 == frame_size("GRAY8", 640, 480));
+
+  // odd sizes, with rows padded to 4 bytes and chroma planes rounded up
+  assert(48 == frame_size("I420", 5, 3));
+  assert(48 == frame_size("NV12", 5, 3));
+  assert(48 == frame_size("Y42B", 5, 3));
+  assert(48 == frame_size("RGB", 5, 3));
+  assert(36 == frame_size("YUY2", 5, 3));
+  assert(24 == frame_size("GRAY8", 5, 3));
+  assert(60 == frame_size("RGBA", 5, 3));
+
+  // not raw video, or unknown size
+  assert(0 == caps::get_raw_video_frame_size(
+                  "audio/x-raw, format=(string)F32LE, rate=(int)48000, channels=(int)2"));
+  assert(0 == caps::get_raw_video_frame_size("video/x-h264, width=(int)640, height=(int)480"));
+  assert(0 == caps::get_raw_video_frame_size("video/x-raw, format=(string)I420, width=(int)640"));
+  return 0;
+}
@@ -20,6 +20,7 @@
 #undef NDEBUG  // get assert in release mode
 
 #include <shmdata/console-logger.hpp>
+#include <atomic>
 
 #include "switcher/quiddity/basic-test.hpp"
 #include "switcher/quiddity/claw/claw.hpp"
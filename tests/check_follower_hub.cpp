@@ -0,0 +1,127 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#undef NDEBUG  // get assert in release mode
+
+#include <gst/gst.h>
+#include <shmdata/console-logger.hpp>
+#include <shmdata/writer.hpp>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include "switcher/shmdata/follower-hub.hpp"
+#include "switcher/switcher.hpp"
+
+using namespace switcher;
+using shmdata::FollowerHub;
+
+bool wait_for(std::function<bool()> predicate) {
+  for (int i = 0; i < 500; ++i) {
+    if (predicate()) return true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return false;
+}
+
+int main() {
+  {
+    Switcher::ptr manager = Switcher::make_switcher("check-follower-hub");
+    auto hub = FollowerHub::get_default();
+    const std::string path("/tmp/check_follower_hub");
+    ::shmdata::ConsoleLogger logger;
+    ::shmdata::Writer writer(path, sizeof(int), "application/x-check-follower-hub", &logger);
+    assert(writer);
+
+    std::atomic<int> first{0};
+    std::atomic<int> second{0};
+    std::atomic<bool> connected{false};
+    auto sub1 = hub->subscribe(
+        path,
+        *manager,
+        [&](void* data, size_t size) {
+          assert(sizeof(int) == size);
+          first += *static_cast<int*>(data);
+        },
+        [&](const std::string&) { connected = true; },
+        nullptr);
+    auto sub2 = hub->subscribe(path,
+                               *manager,
+                               [&](void* data, size_t) { second += *static_cast<int*>(data); },
+                               nullptr,
+                               nullptr);
+    // a single follower serves both subscriptions
+    assert(1 == hub->get_num_followed());
+    assert(wait_for([&]() { return connected.load(); }));
+
+    // both subscriptions receive every buffer
+    for (int i = 1; i <= 10; ++i) {
+      writer.copy_to_shm(&i, sizeof(int));
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    assert(wait_for([&]() { return 55 == first && 55 == second; }));
+
+    // a late subscription is told the writer is already connected, from a hub thread
+    std::string data_type;
+    std::thread::id osc_thread;
+    std::atomic<bool> late_connected{false};
+    auto sub3 = hub->subscribe(path,
+                               *manager,
+                               nullptr,
+                               [&](const std::string& type) {
+                                 data_type = type;
+                                 osc_thread = std::this_thread::get_id();
+                                 late_connected = true;
+                               },
+                               nullptr);
+    assert(wait_for([&]() { return late_connected.load(); }));
+    assert("application/x-check-follower-hub" == data_type);
+    assert(std::this_thread::get_id() != osc_thread);
+    assert(1 == hub->get_num_followed());
+
+    // a blocked subscription does not delay the others
+    std::atomic<bool> release{false};
+    auto blocked = hub->subscribe(path,
+                                  *manager,
+                                  [&](void*, size_t) {
+                                    while (!release)
+                                      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                                  },
+                                  nullptr,
+                                  nullptr);
+    int ten = 10;
+    writer.copy_to_shm(&ten, sizeof(int));
+    assert(wait_for([&]() { return 65 == first && 65 == second; }));
+    release = true;
+    blocked.reset();
+
+    // released subscriptions are not invoked anymore
+    sub1.reset();
+    int one = 1;
+    writer.copy_to_shm(&one, sizeof(int));
+    assert(wait_for([&]() { return 66 == second; }));
+    assert(65 == first);
+
+    sub2.reset();
+    sub3.reset();
+    assert(0 == hub->get_num_followed());
+  }
+  gst_deinit();
+  return 0;
+}
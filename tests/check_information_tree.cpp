@@ -18,11 +18,13 @@
 #undef NDEBUG  // get assert in release mode
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <iostream>
 #include <list>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "switcher/infotree/information-tree.hpp"
@@ -43,6 +45,24 @@ std::ostream& operator<<(std::ostream& os, const SerializableWidget&) {
   return os;
 }
 
+// apply changes to a copy of a tree, as a remote client would do
+void apply_changes(const std::vector<InfoTree::Change>& changes, InfoTree::ptr* client) {
+  for (auto& change : changes) {
+    if (InfoTree::Change::Op::prune == change.op) {
+      (*client)->prune(change.path);
+      continue;
+    }
+    auto copy = InfoTree::copy(change.tree.get());
+    if (change.path == ".") {
+      copy->make_array(change.tree->is_array());
+      *client = copy;
+      continue;
+    }
+    (*client)->graft(change.path, copy);
+    (*client)->tag_as_array(change.path, change.tree->is_array());
+  }
+}
+
 int main() {
   auto string_compare = [](const std::string& first, const std::string& second) {
     return (0 == first.compare(second));
@@ -291,6 +311,181 @@ int main() {
     }
   }
 
+  {  // pre-tokenized paths
+    InfoTree::ptr tree = InfoTree::make();
+    infotree::Path path("..shmdata..writer.stat.");
+    assert(3 == path.size());
+    assert("writer" == path.key(1));
+    assert(infotree::Path(".").is_root());
+    assert(tree->graft(path, InfoTree::make(42)));
+    assert(42 == tree->branch_read_data<int>(path));
+    assert(42 == tree->branch_read_data<int>(".shmdata.writer.stat"));
+    assert(tree->branch_set_value(path, 3.14));
+    assert(3.14 == tree->branch_get_value(path).copy_as<double>());
+    assert(tree->branch_has_data(infotree::Path("shmdata.writer.stat")));
+    assert(tree->prune(path));
+    assert(!tree->branch_has_data(path));
+    assert(!tree->prune(path));
+  }
+
+  {  // many children, looked up with the child index
+    InfoTree::ptr tree = InfoTree::make();
+    const int num_children = 10 * InfoTree::kChildIndexThreshold;
+    for (int i = 0; i < num_children; ++i) tree->vgraft(".root.child" + std::to_string(i), i);
+    for (int i = 0; i < num_children; ++i)
+      assert(i == tree->branch_read_data<int>(".root.child" + std::to_string(i)));
+    // prune every other child and check remaining ones are still found
+    for (int i = 0; i < num_children; i += 2)
+      assert(tree->prune(".root.child" + std::to_string(i)));
+    for (int i = 0; i < num_children; ++i) {
+      auto path = infotree::Path(".root.child" + std::to_string(i));
+      assert((i % 2 != 0) == tree->branch_has_data(path));
+      if (i % 2 != 0) assert(i == tree->branch_read_data<int>(path));
+    }
+    // replace and add children
+    tree->vgraft(".root.child1", -1);
+    tree->vgraft(".root.child0", 0);
+    assert(-1 == tree->branch_read_data<int>(".root.child1"));
+    assert(0 == tree->branch_read_data<int>(".root.child0"));
+    assert(num_children / 2 + 1 == static_cast<int>(tree->get_child_keys(".root").size()));
+    // prune until the index is dropped
+    for (int i = 1; i < num_children - 2; i += 2) tree->prune(".root.child" + std::to_string(i));
+    assert(0 == tree->branch_read_data<int>(".root.child0"));
+    assert(num_children - 1 == tree->branch_read_data<int>(".root.child" +
+                                                           std::to_string(num_children - 1)));
+  }
+
+  {  // snapshots
+    InfoTree::ptr tree = InfoTree::make();
+    tree->vgraft(".child1.child2", 1);
+    auto snapshot = tree->snapshot();
+    assert(snapshot == tree->snapshot());  // not modified, same snapshot is shared
+    tree->vgraft(".child1.child2", 2);
+    tree->vgraft(".child1.child3", 3);
+    assert(1 == snapshot->branch_read_data<int>(".child1.child2"));
+    assert(!snapshot->branch_has_data(".child1.child3"));
+    auto updated = tree->snapshot();
+    assert(snapshot != updated);
+    assert(2 == updated->branch_read_data<int>(".child1.child2"));
+    assert(3 == updated->branch_read_data<int>(".child1.child3"));
+    tree->prune(".child1.child3");
+    assert(updated->branch_has_data(".child1.child3"));
+    assert(!tree->snapshot()->branch_has_data(".child1.child3"));
+    // branches not modified are shared with the previous snapshot
+    tree->vgraft(".other.branch", 1);
+    auto before = tree->snapshot();
+    tree->vgraft(".child1.child2", 4);
+    auto after = tree->snapshot();
+    assert(InfoTree::get_subtree(before.get(), ".other") ==
+           InfoTree::get_subtree(after.get(), ".other"));
+    assert(2 == before->branch_read_data<int>(".child1.child2"));
+    assert(4 == after->branch_read_data<int>(".child1.child2"));
+    // readers and a writer
+    std::atomic<bool> done{false};
+    auto writer = std::thread([&]() {
+      for (int i = 0; i < 1000; ++i) tree->vgraft(".child1.value", i);
+      done = true;
+    });
+    int last = -1;
+    while (!done) {
+      auto snap = tree->snapshot();
+      if (!snap->branch_has_data(".child1.value")) continue;
+      auto value = snap->branch_read_data<int>(".child1.value");
+      assert(value >= last);
+      last = value;
+    }
+    writer.join();
+    assert(999 == tree->snapshot()->branch_read_data<int>(".child1.value"));
+    // modifications made through subtrees are part of the next snapshot
+    auto subtree = tree->get_tree(".child1");
+    subtree->branch_set_value(".value", Any(1000));
+    assert(1000 == tree->snapshot()->branch_read_data<int>(".child1.value"));
+    subtree->get_tree(".child2")->set_value(Any(5));
+    assert(5 == tree->snapshot()->branch_read_data<int>(".child1.child2"));
+    subtree->vgraft(".child4", 4);
+    assert(4 == tree->snapshot()->branch_read_data<int>(".child1.child4"));
+    subtree->prune(".child4");
+    assert(!tree->snapshot()->branch_has_data(".child1.child4"));
+    // a pruned subtree is not part of the tree anymore
+    auto pruned = tree->prune(".child1");
+    auto without = tree->snapshot();
+    pruned->vgraft(".value", 0);
+    assert(without == tree->snapshot());
+  }
+
+  {  // changes since a version
+    InfoTree::ptr tree = InfoTree::make();
+    tree->vgraft(".a.b", 1);
+    tree->vgraft(".a.c", std::string("c"));
+    tree->vgraft(".d.e.f", 1.5);
+    for (int i = 0; i < 4; ++i) tree->vgraft(".list." + std::to_string(i), i);
+    tree->tag_as_array(".list", true);
+    InfoTree::ptr client = InfoTree::make();
+    std::uint64_t version = 0;
+    apply_changes(tree->get_changes_since(0, &version), &client);
+    assert(tree->json() == client->json());
+    assert(version == tree->get_version());
+    assert(tree->get_changes_since(version, &version).empty());
+    // only modified branches are in the changes
+    tree->vgraft(".a.b", 2);
+    auto changes = tree->get_changes_since(version, &version);
+    assert(1 == changes.size());
+    assert(InfoTree::Change::Op::graft == changes.front().op);
+    assert(".a.b" == changes.front().path);
+    apply_changes(changes, &client);
+    assert(tree->json() == client->json());
+    // modifications made through subtrees
+    tree->get_tree(".d.e")->branch_set_value(".f", Any(2.5));
+    changes = tree->get_changes_since(version, &version);
+    assert(1 == changes.size() && ".d.e.f" == changes.front().path);
+    apply_changes(changes, &client);
+    assert(tree->json() == client->json());
+    // values, prunes, array tags and new branches
+    auto previous = version;
+    tree->branch_set_value(".a", std::string("a value"));
+    tree->prune(".a.c");
+    tree->prune(".list.2");
+    tree->tag_as_array(".d", true);
+    tree->vgraft(".g.h", false);
+    tree->vgraft(".a.c", std::string("c again"));
+    changes = tree->get_changes_since(version, &version);
+    assert(std::none_of(changes.begin(), changes.end(), [](const InfoTree::Change& change) {
+      return change.path == ".list.0";
+    }));
+    apply_changes(changes, &client);
+    assert(tree->json() == client->json());
+    // root modifications
+    tree->set_value(std::string("root value"));
+    changes = tree->get_changes_since(version, &version);
+    assert(1 == changes.size() && "." == changes.front().path);
+    // too many prunes to keep them all, the whole parent is grafted
+    for (int i = 0; i < 100; ++i) tree->vgraft(".many." + std::to_string(i), i);
+    apply_changes(tree->get_changes_since(previous, &version), &client);
+    for (int i = 0; i < 99; ++i) tree->prune(".many." + std::to_string(i));
+    changes = tree->get_changes_since(version, &version);
+    assert(1 == changes.size() && ".many" == changes.front().path);
+    apply_changes(changes, &client);
+    assert(tree->json() == client->json());
+    // JSON serialization of the changes
+    tree->vgraft(".a.b", 3);
+    tree->prune(".g");
+    assert(tree->serialize_json_changes(version) ==
+           "{\n"
+           "  \"version\" : " + std::to_string(tree->get_version()) + ",\n"
+           "  \"changes\" : [\n"
+           "    {\n"
+           "      \"op\" : \"prune\",\n"
+           "      \"path\" : \".g\"\n"
+           "    },\n"
+           "    {\n"
+           "      \"op\" : \"graft\",\n"
+           "      \"path\" : \".a.b\",\n"
+           "      \"value\" : 3\n"
+           "    }\n"
+           "  ]\n"
+           "}");
+  }
+
   {  // graft by value
     InfoTree::ptr tree = InfoTree::make();
     tree->vgraft(".string", "a string value");
@@ -0,0 +1,249 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#undef NDEBUG  // get assert in release mode
+
+#include <json-glib/json-glib.h>
+#include <cassert>
+#include <limits>
+#include <string>
+
+#include "switcher/infotree/information-tree.hpp"
+#include "switcher/infotree/json-serializer.hpp"
+#include "switcher/infotree/json-writer.hpp"
+
+using namespace switcher;
+
+// reference serialization, building a json-glib document as the former implementation did
+namespace reference {
+
+void write_typed_member(JsonBuilder* builder, const Any& value) {
+  switch (value.get_category()) {
+    case AnyCategory::BOOLEAN:
+      json_builder_add_boolean_value(builder, value.copy_as<bool>());
+      break;
+    case AnyCategory::INTEGRAL:
+      json_builder_add_int_value(builder, value.copy_as<gint64>());
+      break;
+    case AnyCategory::FLOATING_POINT:
+      json_builder_add_double_value(builder, value.copy_as<gdouble>());
+      break;
+    case AnyCategory::OTHER:
+      json_builder_add_string_value(builder, Any::to_string(value).c_str());
+      break;
+    case AnyCategory::NONE:
+      json_builder_add_null_value(builder);
+      break;
+  }
+}
+
+bool on_visiting_node(std::string key,
+                      InfoTree::ptrc node,
+                      bool is_array_element,
+                      bool repeat_array_indexes,
+                      JsonBuilder* builder) {
+  key = InfoTree::unescape_dots(key);
+  if (!is_array_element) json_builder_set_member_name(builder, key.c_str());
+  if (node->is_leaf()) {
+    if (!node->read_data().is_null())
+      write_typed_member(builder, node->read_data());
+    else if (node->is_array())
+      json_builder_begin_array(builder);
+    else
+      json_builder_add_null_value(builder);
+    return true;
+  }
+  if (node->is_array()) {
+    json_builder_begin_array(builder);
+    return true;
+  }
+  json_builder_begin_object(builder);
+  if (is_array_element && repeat_array_indexes) {
+    json_builder_set_member_name(builder, "id");
+    json_builder_add_string_value(builder, key.c_str());
+  }
+  if (node->read_data().not_null()) {
+    json_builder_set_member_name(builder, "key_value");
+    write_typed_member(builder, node->read_data());
+  }
+  return true;
+}
+
+bool on_node_visited(InfoTree::ptrc node, JsonBuilder* builder) {
+  if (node->is_array())
+    json_builder_end_array(builder);
+  else if (!node->is_leaf())
+    json_builder_end_object(builder);
+  return true;
+}
+
+std::string serialize(InfoTree::ptrc tree, bool repeat_array_indexes) {
+  JsonBuilder* builder = json_builder_new();
+  if (tree->is_array())
+    json_builder_begin_array(builder);
+  else
+    json_builder_begin_object(builder);
+  InfoTree::preorder_tree_walk(
+      tree,
+      [&](const std::string& key, InfoTree::ptrc node, bool is_array_element) {
+        return on_visiting_node(key, node, is_array_element, repeat_array_indexes, builder);
+      },
+      [&](const std::string&, InfoTree::ptrc node, bool) {
+        return on_node_visited(node, builder);
+      });
+  if (tree->is_array())
+    json_builder_end_array(builder);
+  else
+    json_builder_end_object(builder);
+  JsonNode* root = json_builder_get_root(builder);
+  JsonGenerator* generator = json_generator_new();
+  json_generator_set_pretty(generator, TRUE);
+  json_generator_set_root(generator, root);
+  gchar* data = json_generator_to_data(generator, nullptr);
+  std::string res(data);
+  g_free(data);
+  g_object_unref(generator);
+  json_node_free(root);
+  g_object_unref(builder);
+  return res;
+}
+
+}  // namespace reference
+
+// compare with the reference, with and without repeated array indexes
+bool same_as_reference(InfoTree::ptrc tree) {
+  return infotree::json::serialize(tree, false) == reference::serialize(tree, false) &&
+         infotree::json::serialize(tree, true) == reference::serialize(tree, true);
+}
+
+int main() {
+  {  // values
+    auto tree = InfoTree::make();
+    tree->vgraft(".int", 42);
+    tree->vgraft(".negative", -7);
+    tree->vgraft(".min", std::numeric_limits<int64_t>::min());
+    tree->vgraft(".unsigned", 3000000000u);
+    tree->vgraft(".bool", true);
+    tree->vgraft(".false", false);
+    tree->vgraft(".double", 0.1);
+    tree->vgraft(".round_double", 3.0);
+    tree->vgraft(".float", 1.5f);
+    tree->vgraft(".big", 1e20);
+    tree->vgraft(".small", -2.5e-300);
+    tree->vgraft(".third", 1.0 / 3);
+    tree->vgraft(".string", std::string("a string value"));
+    tree->vgraft(".char_string", "another one");
+    tree->vgraft(".empty_string", std::string());
+    tree->graft(".null", InfoTree::make());
+    assert(same_as_reference(tree.get()));
+  }
+
+  {  // escaping
+    auto tree = InfoTree::make();
+    tree->vgraft(".quotes", std::string("\"quoted\" and \\back\\slashed/"));
+    tree->vgraft(".controls", std::string("\b\f\n\r\t\x01\x1e\x1f\x7f"));
+    tree->vgraft(".utf8", std::string("caf\xc3\xa9 \xe4\xb8\xad"));
+    tree->vgraft(".nul", std::string("before\0after", 12));
+    tree->vgraft(".dotted__DOT__key", 1);
+    tree->vgraft(".quoted\"key", 2);
+    assert(same_as_reference(tree.get()));
+  }
+
+  {  // nested objects with values, arrays and empty arrays
+    auto tree = InfoTree::make();
+    tree->vgraft(".object", std::string("object value"));
+    tree->vgraft(".object.child", 1);
+    tree->vgraft(".object.child.grandchild", 2.5);
+    tree->vgraft(".list.a", 1);
+    tree->vgraft(".list.b", std::string("b"));
+    tree->graft(".list.c", InfoTree::make());
+    tree->tag_as_array(".list", true);
+    tree->graft(".empty_list", InfoTree::make());
+    tree->tag_as_array(".empty_list", true);
+    tree->vgraft(".objects.first.name", std::string("first"));
+    tree->vgraft(".objects.first.value", 1);
+    tree->vgraft(".objects.second", std::string("second value"));
+    tree->vgraft(".objects.second.name", std::string("second"));
+    tree->vgraft(".objects.third.sub.0", 0);
+    tree->vgraft(".objects.third.sub.1", 1);
+    tree->tag_as_array(".objects.third.sub", true);
+    tree->tag_as_array(".objects", true);
+    tree->vgraft(".nested.0.0", 1);
+    tree->vgraft(".nested.0.1", 2);
+    tree->graft(".nested.1", InfoTree::make());
+    tree->tag_as_array(".nested.0", true);
+    tree->tag_as_array(".nested.1", true);
+    tree->tag_as_array(".nested", true);
+    assert(same_as_reference(tree.get()));
+  }
+
+  {  // children named as the members added by the serializer
+    auto tree = InfoTree::make();
+    tree->vgraft(".objects.first", std::string("first value"));
+    tree->vgraft(".objects.first.id", std::string("my id"));
+    tree->vgraft(".objects.first.key_value", 42);
+    tree->vgraft(".objects.first.other", true);
+    tree->vgraft(".objects.second.other", false);
+    tree->vgraft(".objects.second.id.sub", 1);
+    tree->tag_as_array(".objects", true);
+    tree->vgraft(".object", 1);
+    tree->vgraft(".object.id", 2);
+    tree->vgraft(".object.key_value", 3);
+    assert(same_as_reference(tree.get()));
+  }
+
+  {  // root arrays
+    auto tree = InfoTree::make();
+    tree->vgraft(".a.name", std::string("a"));
+    tree->vgraft(".b", 2);
+    tree->make_array(true);
+    assert(same_as_reference(tree.get()));
+  }
+
+  {  // root leaves are not formatted as json
+    assert(infotree::json::serialize(InfoTree::make().get()) == "null");
+    auto array = InfoTree::make();
+    array->make_array(true);
+    assert(infotree::json::serialize(array.get()) == "[]");
+    assert(infotree::json::serialize(InfoTree::make(true).get()) == "true");
+    assert(infotree::json::serialize(InfoTree::make(3).get()) == "3");
+    assert(infotree::json::serialize(InfoTree::make("a\"b").get()) == "\"a\"b\"");
+  }
+
+  {  // round trip through the parser
+    auto tree = infotree::json::deserialize(
+        R"({"name" : "a", "values" : [1, 2.5, true, null, {"x" : "y"}], "empty" : {}})");
+    assert(same_as_reference(tree.get()));
+    auto serialized = infotree::json::serialize(tree.get());
+    assert(serialized == infotree::json::serialize(infotree::json::deserialize(serialized).get()));
+  }
+
+  {  // a reused writer gives the same result, and append keeps the previous content
+    auto tree = InfoTree::make();
+    tree->vgraft(".a.b", 1);
+    tree->vgraft(".c", std::string("c"));
+    auto expected = infotree::json::serialize(tree.get(), true);
+    infotree::json::Writer writer(true);
+    assert(writer.write(tree.get()) == expected);
+    assert(writer.write(tree.get()) == expected);
+    std::string out("prefix");
+    writer.append(tree.get(), &out);
+    assert(out == "prefix" + expected);
+  }
+
+  return 0;
+}
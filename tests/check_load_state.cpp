@@ -0,0 +1,105 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#undef NDEBUG  // get assert in release mode
+
+#include <gst/gst.h>
+#include <atomic>
+#include <cassert>
+#include "switcher/quiddity/property/pbag.hpp"
+#include "switcher/switcher.hpp"
+
+using namespace switcher;
+using namespace quiddity;
+
+int main() {
+  {
+    Switcher::ptr manager = Switcher::make_switcher("test-load-state");
+    manager->reset_state(false);
+    // declared here since the subscriptions below last as long as the quiddities
+    std::atomic<int> num_created{0};
+    std::atomic<int> num_created_when_started{-1};
+
+    InfoTree::ptr state;
+    {  // saving a state with a started source between other quiddities
+      for (const auto& kind_and_name : {std::make_pair("dummysink", "sink1"),
+                                        std::make_pair("videotestsrc", "vid"),
+                                        std::make_pair("dummysink", "sink2")}) {
+        assert(manager->quids<&Container::create>(
+            kind_and_name.first, kind_and_name.second, nullptr));
+      }
+      auto vid = manager->quids<&Container::get_quiddity>(
+          manager->quids<&Container::get_id>("vid"));
+      assert(!vid->tree<&InfoTree::snapshot>()->branch_read_data<bool>(".property.started.value"));
+      assert(vid->prop<&property::PBag::set_str_str>("started", "true"));
+      assert(vid->user_data<&InfoTree::graft>(".tag", InfoTree::make(std::string("loaded"))));
+      state = manager->get_state();
+      // saving writes property values through their own subtree, snapshots show them as well
+      assert(vid->tree<&InfoTree::snapshot>()->branch_read_data<bool>(".property.started.value"));
+      assert(state->branch_has_data(".quiddities.sink2"));
+    }
+
+    manager->reset_state(true);
+    assert(0 == manager->quids<&Container::get_id>("vid"));
+
+    {  // every quiddity is created before any is configured
+      auto creation_cb = manager->quids<&Container::register_creation_cb>([&](qid_t id) {
+        ++num_created;
+        auto quid = manager->quids<&Container::get_quiddity>(id);
+        auto started_id = quid->prop<&property::PBag::get_id>("started");
+        if (0 == started_id) return;
+        quid->prop<&property::PBag::subscribe>(
+            started_id, [&]() { num_created_when_started = num_created.load(); });
+      });
+      assert(manager->load_state(state.get()));
+      manager->quids<&Container::unregister_creation_cb>(creation_cb);
+      assert(3 == num_created);
+      assert(3 == num_created_when_started);
+    }
+
+    {  // properties and user data are restored
+      auto vid = manager->quids<&Container::get_quiddity>(
+          manager->quids<&Container::get_id>("vid"));
+      assert(vid);
+      assert(vid->prop<&property::PBag::get<bool>>(
+          vid->prop<&property::PBag::get_id>("started")));
+      assert("loaded" ==
+             vid->user_data<&InfoTree::branch_get_value>(".tag").copy_as<std::string>());
+      assert(0 != manager->quids<&Container::get_id>("sink1"));
+      assert(0 != manager->quids<&Container::get_id>("sink2"));
+    }
+
+    {  // loading durations are published by the switcher, not added to the state
+      assert(!state->branch_has_data(".load_timings"));
+      auto info = manager->get_info_tree();
+      for (const auto& name : {"sink1", "vid", "sink2"}) {
+        assert(info->branch_has_data(std::string(".load_timings.") + name + ".create"));
+        assert(info->branch_has_data(std::string(".load_timings.") + name + ".load"));
+        assert(info->branch_get_value(std::string(".load_timings.") + name + ".create")
+                   .copy_as<double>() <=
+               info->branch_get_value(std::string(".load_timings.") + name + ".load")
+                   .copy_as<double>());
+      }
+    }
+
+    auto vid =
+        manager->quids<&Container::get_quiddity>(manager->quids<&Container::get_id>("vid"));
+    vid->prop<&property::PBag::set_str_str>("started", "false");
+  }  // end of scope is releasing the manager
+  gst_deinit();
+  return 0;
+}
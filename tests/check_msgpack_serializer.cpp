@@ -0,0 +1,180 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#undef NDEBUG  // get assert in release mode
+
+#include <cassert>
+#include <limits>
+#include <string>
+
+#include "switcher/infotree/information-tree.hpp"
+#include "switcher/infotree/json-serializer.hpp"
+#include "switcher/infotree/msgpack-serializer.hpp"
+
+using namespace switcher;
+
+template <typename T>
+void check_value(InfoTree::ptrc tree, const std::string& path, T expected, AnyArithmeticType type) {
+  auto value = tree->branch_get_value(path);
+  assert(value.get_arithmetic_type() == type);
+  assert(value.copy_as<T>() == expected);
+}
+
+// children keys, values and array tags of both trees are identical
+void check_same(InfoTree::ptrc first, InfoTree::ptrc second) {
+  assert(first->is_array() == second->is_array());
+  assert(Any::to_string(first->get_value()) == Any::to_string(second->get_value()));
+  assert(first->get_value().get_category() == second->get_value().get_category());
+  auto keys = first->get_child_keys(".");
+  assert(keys == second->get_child_keys("."));
+  for (auto& key : keys)
+    check_same(InfoTree::get_subtree(first, key), InfoTree::get_subtree(second, key));
+}
+
+int main() {
+  {  // values keep their type
+    auto tree = InfoTree::make();
+    tree->vgraft(".int.small", 42);
+    tree->vgraft(".int.negative", -7);
+    tree->vgraft(".int.large", std::numeric_limits<int>::min());
+    tree->vgraft(".short", static_cast<short>(-1234));
+    tree->vgraft(".long", std::numeric_limits<long>::max());
+    tree->vgraft(".long_long", std::numeric_limits<long long>::min());
+    tree->vgraft(".unsigned_short", static_cast<unsigned short>(65535));
+    tree->vgraft(".unsigned_int", std::numeric_limits<unsigned int>::max());
+    tree->vgraft(".unsigned_long", std::numeric_limits<unsigned long>::max());
+    tree->vgraft(".unsigned_long_long", std::numeric_limits<unsigned long long>::max());
+    tree->vgraft(".float", 1.5f);
+    tree->vgraft(".double", -0.1);
+    tree->vgraft(".bool", true);
+    tree->vgraft(".string.short", std::string("short"));
+    tree->vgraft(".string.long", std::string(70000, 'x'));
+    tree->vgraft(".string.nul", std::string("a\0b", 3));
+    tree->graft(".null", InfoTree::make());
+
+    auto decoded = infotree::msgpack::deserialize(infotree::msgpack::serialize(tree.get()));
+    check_value(decoded.get(), ".int.small", 42, AnyArithmeticType::INT);
+    check_value(decoded.get(), ".int.negative", -7, AnyArithmeticType::INT);
+    check_value(
+        decoded.get(), ".int.large", std::numeric_limits<int>::min(), AnyArithmeticType::INT);
+    check_value(decoded.get(), ".short", static_cast<short>(-1234), AnyArithmeticType::SHORT);
+    check_value(
+        decoded.get(), ".long", std::numeric_limits<long>::max(), AnyArithmeticType::LONG);
+    check_value(decoded.get(),
+                ".long_long",
+                std::numeric_limits<long long>::min(),
+                AnyArithmeticType::LONG_LONG);
+    check_value(decoded.get(),
+                ".unsigned_short",
+                static_cast<unsigned short>(65535),
+                AnyArithmeticType::UNSIGNED_SHORT);
+    check_value(decoded.get(),
+                ".unsigned_int",
+                std::numeric_limits<unsigned int>::max(),
+                AnyArithmeticType::UNSIGNED_INT);
+    check_value(decoded.get(),
+                ".unsigned_long",
+                std::numeric_limits<unsigned long>::max(),
+                AnyArithmeticType::UNSIGNED_LONG);
+    check_value(decoded.get(),
+                ".unsigned_long_long",
+                std::numeric_limits<unsigned long long>::max(),
+                AnyArithmeticType::UNSIGNED_LONG_LONG);
+    check_value(decoded.get(), ".float", 1.5f, AnyArithmeticType::FLOAT);
+    check_value(decoded.get(), ".double", -0.1, AnyArithmeticType::DOUBLE);
+    assert(decoded->branch_read_data<bool>(".bool"));
+    assert("short" == decoded->branch_read_data<std::string>(".string.short"));
+    assert(std::string(70000, 'x') == decoded->branch_read_data<std::string>(".string.long"));
+    assert(std::string("a\0b", 3) == decoded->branch_read_data<std::string>(".string.nul"));
+    assert(!decoded->branch_has_data(".null"));
+    check_same(tree.get(), decoded.get());
+  }
+
+  {  // structure, array tags and keys of array elements are kept
+    auto tree = InfoTree::make(std::string("root value"));
+    tree->vgraft(".child1", 3);
+    tree->graft(".child1.child2.red_door", InfoTree::make(std::string("red")));
+    tree->graft(".child1.child2.black_door", InfoTree::make(std::string("black")));
+    tree->tag_as_array(".child1.child2", true);
+    tree->graft(".empty_array", InfoTree::make());
+    tree->tag_as_array(".empty_array", true);
+    tree->vgraft(".dotted." + InfoTree::escape_dots("a.b"), 1);
+    for (int i = 0; i < 40; ++i) tree->vgraft(".many." + std::to_string(39 - i), i);
+
+    auto serialized = infotree::msgpack::serialize(tree.get());
+    auto decoded = infotree::msgpack::deserialize(serialized);
+    check_same(tree.get(), decoded.get());
+    assert(decoded->branch_is_array(".child1.child2"));
+    assert(decoded->branch_is_array(".empty_array"));
+    assert("black" == decoded->branch_read_data<std::string>(".child1.child2.black_door"));
+    assert(20 == decoded->branch_read_data<int>(".many.19"));
+    assert(infotree::json::serialize(tree.get()) == infotree::json::serialize(decoded.get()));
+    // encoding is deterministic
+    assert(serialized == infotree::msgpack::serialize(decoded.get()));
+    // a subtree can be decoded on its own
+    auto child = infotree::msgpack::serialize(InfoTree::get_subtree(tree.get(), ".child1"));
+    check_same(InfoTree::get_subtree(tree.get(), ".child1"),
+               infotree::msgpack::deserialize(child).get());
+  }
+
+  {  // a leaf root is encoded as its value only
+    auto leaf = InfoTree::make(3);
+    assert(std::string(1, '\x03') == infotree::msgpack::serialize(leaf.get()));
+    assert(3 == infotree::msgpack::deserialize(std::string(1, '\x03'))->read_data().copy_as<int>());
+    assert(infotree::msgpack::deserialize(std::string())->empty());
+  }
+
+  {  // malformed data gives an empty tree
+    auto tree = InfoTree::make();
+    tree->vgraft(".a.b", std::string("value"));
+    tree->vgraft(".a.c", 1.5);
+    tree->tag_as_array(".a", true);
+    auto serialized = infotree::msgpack::serialize(tree.get());
+    for (size_t size = 0; size < serialized.size(); ++size) {
+      auto decoded = infotree::msgpack::deserialize(serialized.substr(0, size), true);
+      assert(decoded->branch_has_data(".parsing_error"));
+      assert(decoded->get_child_keys(".").size() == 1);
+    }
+    assert(infotree::msgpack::deserialize(serialized + '\x01', true)
+               ->branch_has_data(".parsing_error"));
+    assert(infotree::msgpack::deserialize(std::string("\xc1"))->empty());
+    // deep nesting is rejected instead of exhausting the stack
+    std::string deep;
+    for (int i = 0; i < 100000; ++i) deep += std::string("\x93\xc0\xc2\x81\xa1k", 6);
+    deep += '\xc0';
+    assert(infotree::msgpack::deserialize(deep)->empty());
+    // duplicate keys, in small and in indexed maps
+    assert(infotree::msgpack::deserialize(std::string("\x93\xc0\xc2\x82\xa1k\xc0\xa1k\xc0", 10))
+               ->empty());
+    std::string large("\x93\xc0\xc2\xde\x00\x15", 6);
+    for (char key = 'a'; key < 'a' + 20; ++key) large += std::string("\xa1") + key + '\xc0';
+    assert(!infotree::msgpack::deserialize(large + std::string("\xa1u\xc0"))->empty());
+    assert(infotree::msgpack::deserialize(large + std::string("\xa1j\xc0"))->empty());
+    // random bytes
+    unsigned int seed = 1;
+    for (int i = 0; i < 10000; ++i) {
+      std::string bytes = serialized;
+      for (int j = 0; j < 3; ++j) {
+        seed = seed * 1103515245 + 12345;
+        bytes[(seed >> 8) % bytes.size()] = static_cast<char>(seed >> 16);
+      }
+      infotree::msgpack::deserialize(bytes);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#undef NDEBUG  // get assert in release mode
+
+#include <gst/gst.h>
+#include <atomic>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "switcher/switcher.hpp"
+
+using namespace switcher;
+
+int main() {
+  {
+    Switcher::ptr manager = Switcher::make_switcher("test-container");
+    auto first = manager->quids<&quiddity::Container::create>("empty-quid", "first", nullptr);
+    auto second = manager->quids<&quiddity::Container::create>("empty-quid", "second", nullptr);
+    assert(first && second);
+    assert(first.get_id() == manager->quids<&quiddity::Container::get_id>("first"));
+    assert(second.get_id() == manager->quids<&quiddity::Container::get_id>("second"));
+    assert(0 == manager->quids<&quiddity::Container::get_id>("third"));
+
+    // nicknames are unique
+    assert(!manager->quids<&quiddity::Container::create>("empty-quid", "first", nullptr));
+    assert(!second.get()->set_nickname("first"));
+    assert(second.get()->set_nickname("second"));
+
+    // renaming updates the nickname index
+    assert(first.get()->set_nickname("renamed"));
+    assert(0 == manager->quids<&quiddity::Container::get_id>("first"));
+    assert(first.get_id() == manager->quids<&quiddity::Container::get_id>("renamed"));
+    assert("renamed" == manager->quids<&quiddity::Container::get_nickname>(first.get_id()));
+
+    // removal releases the nickname
+    assert(manager->quids<&quiddity::Container::remove>(first.get_id()));
+    assert(0 == manager->quids<&quiddity::Container::get_id>("renamed"));
+    assert(manager->quids<&quiddity::Container::create>("empty-quid", "renamed", nullptr));
+
+    // concurrent creations with the same nickname, only one succeeds
+    std::atomic<int> num_created{0};
+    std::vector<std::thread> clients;
+    for (int i = 0; i < 8; ++i) {
+      clients.emplace_back([&]() {
+        if (manager->quids<&quiddity::Container::create>("empty-quid", "concurrent", nullptr))
+          ++num_created;
+        manager->quids<&quiddity::Container::get_id>("second");
+      });
+    }
+    for (auto& it : clients) it.join();
+    assert(1 == num_created);
+    assert(0 != manager->quids<&quiddity::Container::get_id>("concurrent"));
+  }
+  gst_deinit();
+  return 0;
+}
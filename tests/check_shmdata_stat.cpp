@@ -0,0 +1,116 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#undef NDEBUG  // get assert in release mode
+
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "switcher/shmdata/stat.hpp"
+#include "switcher/utils/histogram.hpp"
+
+using namespace switcher;
+
+int main() {
+  {  // buckets are exact below kSubBuckets * 2, then keep the relative precision
+    for (uint64_t value = 0; value < 2 * Histogram::kSubBuckets; ++value)
+      assert(value == Histogram::bucket_highest_value(Histogram::bucket_index(value)));
+    assert(Histogram::kNumBuckets - 1 == Histogram::bucket_index(UINT64_MAX));
+    assert(UINT64_MAX == Histogram::bucket_highest_value(Histogram::kNumBuckets - 1));
+    for (uint64_t value = 1; value < (uint64_t(1) << 40); value = value * 3 + 1) {
+      auto index = Histogram::bucket_index(value);
+      auto highest = Histogram::bucket_highest_value(index);
+      assert(value <= highest);
+      assert(highest - value <= value / Histogram::kSubBuckets);
+      assert(index + 1 == Histogram::bucket_index(highest + 1));
+    }
+  }
+
+  {  // percentiles
+    Histogram histogram;
+    assert(0 == histogram.take().value_at(50));
+    for (uint64_t value = 1; value <= 100; ++value) histogram.record(value);
+    histogram.record(100000);
+    auto snapshot = histogram.take();
+    assert(101 == snapshot.count());
+    assert(100000 == snapshot.max());
+    assert(1 == snapshot.value_at(0));
+    auto p50 = snapshot.value_at(50);
+    assert(51 <= p50 && p50 <= 51 + 51 / Histogram::kSubBuckets);
+    assert(100000 == snapshot.value_at(100));
+    // taking empties the histogram
+    assert(0 == histogram.take().count());
+  }
+
+  {  // concurrent recording is not lost
+    Histogram histogram;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+      threads.emplace_back([&histogram]() {
+        for (uint64_t value = 0; value < 100000; ++value) histogram.record(value);
+      });
+    uint64_t count = 0;
+    for (int i = 0; i < 10; ++i) count += histogram.take().count();
+    for (auto& thread : threads) thread.join();
+    count += histogram.take().count();
+    assert(400000 == count);
+  }
+
+  {  // shmdata statistics
+    shmdata::StatCounter counter;
+    for (int i = 0; i < 10; ++i) {
+      counter.count_buffer(i < 9 ? 1000 : 50000);
+      std::this_thread::sleep_for(std::chrono::milliseconds(i < 9 ? 2 : 40));
+    }
+    auto stat = counter.collect();
+    assert(59000 == stat.bytes_);
+    assert(10 == stat.accesses_);
+    // the ongoing gap after the last buffer is the longest
+    assert(stat.max_gap_ >= std::chrono::milliseconds(40));
+    assert(stat.gap_p50_ >= std::chrono::milliseconds(2));
+    assert(stat.gap_p50_ < stat.max_gap_);
+    assert(stat.jitter_ > std::chrono::microseconds(0));
+    assert(1000 <= stat.size_p50_ && stat.size_p50_ <= 1000 + 1000 / Histogram::kSubBuckets);
+    assert(50000 == stat.size_p99_);
+    assert(50000 == stat.size_max_);
+    // the collection resets the counters
+    stat = counter.collect();
+    assert(0 == stat.bytes_);
+    assert(0 == stat.accesses_);
+    assert(0 == stat.size_max_);
+    assert(stat.max_gap_ >= std::chrono::milliseconds(40));
+    auto tree = InfoTree::make();
+    stat.update_tree(tree, "counted");
+    assert(tree->branch_has_data("counted.stat.max_gap_ms"));
+    assert(tree->branch_has_data("counted.stat.size_max"));
+  }
+
+  {  // values that are not measured are not published
+    shmdata::Stat stat;
+    stat.bytes_ = 1000;
+    stat.accesses_ = 10;
+    auto tree = InfoTree::make();
+    stat.update_tree(tree, "uncounted");
+    assert(tree->branch_has_data("uncounted.stat.byte_rate"));
+    assert(tree->branch_has_data("uncounted.stat.rate"));
+    for (const auto& key : {"max_gap_ms", "jitter_ms", "gap_p50_ms", "gap_p99_ms", "size_p50"})
+      assert(!tree->branch_has_data(std::string("uncounted.stat.") + key));
+  }
+
+  return 0;
+}
@@ -0,0 +1,175 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#undef NDEBUG  // get assert in release mode
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "switcher/quiddity/signal/sig.hpp"
+
+using namespace switcher;
+using namespace switcher::quiddity::signal;
+using namespace std::chrono_literals;
+
+int main() {
+  {  // immediate delivery runs the subscriber from the notifying thread
+    Sig sig;
+    std::thread::id subscriber_thread;
+    sig.subscribe([&](const InfoTree::ptr&) { subscriber_thread = std::this_thread::get_id(); });
+    sig.notify(InfoTree::make(std::string("path")));
+    assert(std::this_thread::get_id() == subscriber_thread);
+  }
+
+  {  // coalesced delivery merges paths and keeps the order of first notification
+    Sig sig;
+    std::mutex mtx;
+    std::vector<std::string> received;
+    std::thread::id subscriber_thread;
+    sig.subscribe(
+        [&](const InfoTree::ptr& tree) {
+          std::lock_guard<std::mutex> lock(mtx);
+          subscriber_thread = std::this_thread::get_id();
+          received.push_back(tree->read_data().copy_as<std::string>());
+        },
+        Delivery::coalesce(50ms));
+    for (auto& path : {".stat.a", ".stat.b", ".stat.a", ".stat.a", ".stat.c", ".stat.b"})
+      sig.notify(InfoTree::make(std::string(path)));
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      assert(received.empty());
+    }
+    std::this_thread::sleep_for(200ms);
+    std::lock_guard<std::mutex> lock(mtx);
+    assert((std::vector<std::string>{".stat.a", ".stat.b", ".stat.c"}) == received);
+    assert(std::this_thread::get_id() != subscriber_thread);
+  }
+
+  {  // rate limited delivery
+    Sig sig;
+    std::atomic<int> num_received{0};
+    sig.subscribe([&](const InfoTree::ptr&) { ++num_received; }, Delivery::max_rate(10));
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < 350ms) {
+      sig.notify(InfoTree::make(std::string(".stat")));
+      std::this_thread::sleep_for(1ms);
+    }
+    std::this_thread::sleep_for(200ms);
+    assert(2 <= num_received && num_received <= 6);
+  }
+
+  {  // unsubscribe waits for the running delivery
+    Sig sig;
+    std::atomic<bool> started{false};
+    std::atomic<bool> done{false};
+    auto rid = sig.subscribe(
+        [&](const InfoTree::ptr&) {
+          started = true;
+          std::this_thread::sleep_for(50ms);
+          done = true;
+        },
+        Delivery::coalesce(1ms));
+    sig.notify(InfoTree::make(std::string("path")));
+    while (!started) std::this_thread::sleep_for(1ms);
+    assert(sig.unsubscribe(rid));
+    assert(done);
+    assert(!sig.unsubscribe(rid));
+  }
+
+  {  // unsubscribing from the subscriber does not block, pending notifications are dropped
+    Sig sig;
+    std::atomic<int> num_received{0};
+    register_id_t rid = 0;
+    rid = sig.subscribe(
+        [&](const InfoTree::ptr&) {
+          assert(sig.unsubscribe(rid));
+          ++num_received;
+        },
+        Delivery::coalesce(10ms));
+    sig.notify(InfoTree::make(std::string("a")));
+    sig.notify(InfoTree::make(std::string("b")));
+    while (0 == num_received) std::this_thread::sleep_for(1ms);
+    std::this_thread::sleep_for(50ms);
+    assert(1 == num_received);
+  }
+
+  {  // a shared queue keeps the order of notifications from different signals
+    Sig grafted;
+    Sig pruned;
+    std::mutex mtx;
+    std::vector<std::string> received;
+    auto queue = std::make_shared<Queue>(Delivery::coalesce(50ms));
+    grafted.subscribe(
+        [&](const InfoTree::ptr& tree) {
+          std::lock_guard<std::mutex> lock(mtx);
+          received.push_back("grafted " + tree->read_data().copy_as<std::string>());
+        },
+        Delivery::through(queue));
+    pruned.subscribe(
+        [&](const InfoTree::ptr& tree) {
+          std::lock_guard<std::mutex> lock(mtx);
+          received.push_back("pruned " + tree->read_data().copy_as<std::string>());
+        },
+        Delivery::through(queue));
+    grafted.notify(InfoTree::make(std::string(".a")));
+    grafted.notify(InfoTree::make(std::string(".b")));
+    grafted.notify(InfoTree::make(std::string(".a")));
+    pruned.notify(InfoTree::make(std::string(".a")));
+    grafted.notify(InfoTree::make(std::string(".a")));
+    grafted.notify(InfoTree::make(std::string(".b")));
+    std::this_thread::sleep_for(200ms);
+    std::lock_guard<std::mutex> lock(mtx);
+    assert((std::vector<std::string>{"grafted .a", "grafted .b", "pruned .a", "grafted .a",
+                                     "grafted .b"}) == received);
+  }
+
+  {  // destroying the signal does not wait for the running delivery
+    std::atomic<bool> started{false};
+    std::atomic<bool> done{false};
+    {
+      Sig sig;
+      sig.subscribe(
+          [&](const InfoTree::ptr&) {
+            started = true;
+            std::this_thread::sleep_for(100ms);
+            done = true;
+          },
+          Delivery::coalesce(1ms));
+      sig.notify(InfoTree::make(std::string("path")));
+      while (!started) std::this_thread::sleep_for(1ms);
+    }
+    assert(!done);
+    while (!done) std::this_thread::sleep_for(1ms);
+  }
+
+  {  // no delivery after the signal is destroyed
+    std::atomic<int> num_received{0};
+    {
+      Sig sig;
+      sig.subscribe([&](const InfoTree::ptr&) { ++num_received; }, Delivery::coalesce(10ms));
+      sig.notify(InfoTree::make(std::string("path")));
+    }
+    std::this_thread::sleep_for(50ms);
+    assert(0 == num_received);
+  }
+
+  return 0;
+}
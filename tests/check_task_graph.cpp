@@ -0,0 +1,103 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#undef NDEBUG  // get assert in release mode
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "switcher/utils/task-graph.hpp"
+
+using namespace switcher;
+
+int main() {
+  {  // an empty graph
+    TaskGraph graph;
+    graph.run(4);
+  }
+
+  {  // a single thread runs the tasks in order of addition, unless dependencies prevent it
+    TaskGraph graph;
+    std::vector<int> order;
+    for (int i = 0; i < 4; ++i) graph.add_task([&, i]() { order.push_back(i); });
+    graph.add_dependency(0, 2);
+    graph.run(1);
+    assert((std::vector<int>{1, 2, 0, 3}) == order);
+  }
+
+  {  // dependencies are respected by concurrent threads
+    const int num_tasks = 500;
+    TaskGraph graph;
+    std::mutex mtx;
+    std::vector<int> done_at(num_tasks, -1);
+    int count = 0;
+    for (int i = 0; i < num_tasks; ++i) {
+      graph.add_task([&, i]() {
+        std::lock_guard<std::mutex> lock(mtx);
+        done_at[i] = count++;
+      });
+    }
+    std::vector<std::pair<int, int>> dependencies;
+    std::minstd_rand rand;
+    for (int i = 1; i < num_tasks; ++i) {
+      dependencies.emplace_back(i, rand() % i);
+      if (0 == i % 3) dependencies.emplace_back(i, i / 3);
+    }
+    for (auto& it : dependencies) graph.add_dependency(it.first, it.second);
+    graph.run(8);
+    assert(num_tasks == count);
+    for (auto& it : dependencies) assert(done_at[it.first] > done_at[it.second]);
+  }
+
+  {  // independent tasks overlap
+    TaskGraph graph;
+    std::atomic<int> arrived{0};
+    std::atomic<bool> overlapped{true};
+    for (int i = 0; i < 2; ++i) {
+      graph.add_task([&]() {
+        ++arrived;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (arrived < 2) {
+          if (std::chrono::steady_clock::now() > deadline) {
+            overlapped = false;
+            return;
+          }
+          std::this_thread::yield();
+        }
+      });
+    }
+    graph.run(2);
+    assert(overlapped);
+  }
+
+  {  // dependency cycles are broken
+    TaskGraph graph;
+    std::vector<int> order;
+    for (int i = 0; i < 3; ++i) graph.add_task([&, i]() { order.push_back(i); });
+    graph.add_dependency(0, 1);
+    graph.add_dependency(1, 0);
+    graph.add_dependency(2, 2);
+    graph.run(3);
+    assert((std::vector<int>{0, 1, 2}) == order);
+  }
+  return 0;
+}
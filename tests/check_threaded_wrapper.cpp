@@ -19,9 +19,13 @@
 
 #undef NDEBUG  // get assert in release mode
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <iostream>
 #include <string>
+#include <vector>
 #include "switcher/utils/threaded-wrapper.hpp"
 
 using namespace std;
@@ -57,16 +61,65 @@ void use_A(ThreadedWrapper<A>& twa, const string& str) {
 void use_A_async(ThreadedWrapper<A>& twa, const string& str) {
   int i = 100;
   while (--i >= 0) {
-    twa.invoke_async([&](A* a) { a->hello(i, str); });
-    twa.invoke_async([&](A* a) {
+    // captured by copy, since the loop goes on before execution
+    twa.invoke_async([i, str](A* a) { a->hello(i, str); });
+    twa.invoke_async([i, str](A* a) {
       a->do_nothing();
       if (0 == i) cout << str << ": last do_nothing invocation done" << endl;
     });
   }
 }
 
+// time from submission to execution of asynchronous functions, and round trip of synchronous
+// functions, when the wrapper thread is idle
+void measure_latency() {
+  using clk = std::chrono::steady_clock;
+  const int iterations = 1000;
+  ThreadedWrapper<> tw;
+  std::vector<double> async_latencies;  // in microseconds
+  std::vector<double> sync_latencies;
+  auto elapsed_us = [](clk::time_point start) {
+    return std::chrono::duration<double, std::micro>(clk::now() - start).count();
+  };
+  for (int i = 0; i < iterations; ++i) {
+    std::atomic<bool> done{false};
+    auto start = clk::now();
+    tw.run_async([&]() {
+      async_latencies.push_back(elapsed_us(start));
+      done = true;
+    });
+    while (!done) std::this_thread::yield();
+    // let the thread go back to sleep
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    start = clk::now();
+    tw.run([]() {});
+    sync_latencies.push_back(elapsed_us(start));
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  for (auto* latencies : {&async_latencies, &sync_latencies}) {
+    std::sort(latencies->begin(), latencies->end());
+    cout << (latencies == &async_latencies ? "async latency" : "sync round trip") << ": median "
+         << (*latencies)[iterations / 2] << "us, p99 " << (*latencies)[iterations * 99 / 100]
+         << "us" << endl;
+  }
+}
+
 int main() {
+  ThreadedWrapper<> tw;
+  // functions are executed in submission order
+  std::vector<int> order;
+  for (int i = 0; i < 100; ++i) tw.run_async([&, i]() { order.push_back(i); });
+  tw.run_async<int>([]() { return 100; }, [&](int res) { order.push_back(res); });
+  tw.run_async([]() {}, [&]() { order.push_back(101); });
+  assert(tw.run<size_t>([&]() { return order.size(); }) == 102);
+  for (int i = 0; i < 102; ++i) assert(order[i] == i);
+  // synchronous invocation from the wrapper thread does not block
+  tw.run_async([&]() { tw.run([&]() { order.clear(); }); });
+  tw.wait_done();
+  assert(order.empty());
+
   ThreadedWrapper<A> twa("coucou");
+  assert(twa.invoke<std::string>([](A* a) { return a->hello(1, "sync"); }) == "hello1");
   thread th1(use_A, ref(twa), "th1 (sync)");
   thread th2(use_A, ref(twa), "th2 (sync)");
   thread th3(use_A_async, ref(twa), "th3 (async)");
@@ -75,4 +128,6 @@ int main() {
   th2.join();
   th3.join();
   th4.join();
+
+  measure_latency();
 }
@@ -0,0 +1,104 @@
+/*
+ * This file is part of switcher.
+ *
+ * switcher is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * switcher is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with switcher.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#undef NDEBUG  // get assert in release mode
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <thread>
+#include "plugins/glfw/triple-buffer.hpp"
+
+// every value of a frame is its sequence number, a torn frame mixes several
+struct Frame {
+  bool filling{false};
+  std::uint64_t seq{0};
+  std::array<std::uint64_t, 512> values{};
+};
+
+bool is_whole(const Frame& frame) {
+  if (frame.filling) return false;
+  for (auto it : frame.values)
+    if (it != frame.seq) return false;
+  return true;
+}
+
+int main() {
+  {  // the reader gets the latest published value only
+    TripleBuffer<int> buffer;
+    bool has_changed = true;
+    buffer.read(has_changed);
+    assert(!has_changed);
+    buffer.back() = 1;
+    buffer.publish();
+    buffer.back() = 2;
+    buffer.publish();
+    assert(2 == buffer.read(has_changed));
+    assert(has_changed);
+    assert(2 == buffer.read(has_changed));
+    assert(!has_changed);
+    assert(2 == buffer.front());
+    // the slot of the reader is not given back to the writer
+    buffer.back() = 3;
+    buffer.publish();
+    buffer.back() = 4;
+    assert(2 == buffer.front());
+    assert(3 == buffer.read(has_changed));
+  }
+
+  {  // one writer and one reader threads
+    const std::uint64_t total = 200000;
+    TripleBuffer<Frame> buffer;
+    std::atomic<bool> done{false};
+    std::thread writer([&]() {
+      for (std::uint64_t seq = 1; seq <= total; ++seq) {
+        auto& frame = buffer.back();
+        frame.filling = true;
+        frame.seq = seq;
+        for (auto& it : frame.values) it = seq;
+        frame.filling = false;
+        buffer.publish();
+      }
+      done = true;
+    });
+    std::uint64_t last = 0;
+    std::uint64_t num_changes = 0;
+    while (true) {
+      // the final value is read once the writer is done
+      auto finished = done.load();
+      bool has_changed = false;
+      auto& frame = buffer.read(has_changed);
+      assert(is_whole(frame));
+      if (has_changed) {
+        assert(frame.seq > last);
+        ++num_changes;
+      } else {
+        assert(frame.seq == last);
+      }
+      last = frame.seq;
+      // the slot stays untouched by the writer while the reader holds it
+      std::this_thread::yield();
+      assert(is_whole(frame) && frame.seq == last);
+      if (finished) break;
+    }
+    writer.join();
+    assert(total == last);
+    assert(0 < num_changes && num_changes <= total);
+  }
+  return 0;
+}
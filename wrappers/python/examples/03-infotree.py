@@ -86,6 +86,13 @@ assert 1.0 == from_json.get('one')
 utree.graft('other tree', from_json)
 assert utree.json('other tree') == from_json.json()
 
+# trees also have a binary MessagePack representation, which keeps value types and arrays
+packed = utree.msgpack()
+assert isinstance(packed, bytes)
+from_msgpack = pyquid.InfoTree(packed)
+assert utree.json() == from_msgpack.json()
+assert [1, 1, 0, 6] == json.loads(from_msgpack.json('my.array'))
+
 # ensure parsing errors are handled
 error_raised = False
 try:
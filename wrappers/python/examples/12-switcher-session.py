@@ -43,10 +43,17 @@ assert isinstance(session_files, list) and len(session_files) >= 3
 assert sw.session.load("session1")
 assert sw.session.load("session2.json")
 
+# sessions saved with the .msgpack extension use a binary format, faster to load
+s4_filepath = sw.session.save_as("session4.msgpack")
+assert s4_filepath.endswith(".msgpack") and os.path.exists(s4_filepath)
+assert isinstance(sw.session.read("session4.msgpack"), bytes)
+assert sw.session.load("session4.msgpack")
+
 # remove test session files
 assert sw.session.remove("session1")
 assert sw.session.remove("session2.json")
 assert sw.session.remove("session3")
+assert sw.session.remove("session4.msgpack")
 
 sw2 = pyquid.Switcher('session_test', debug=True)
 
@@ -20,6 +20,7 @@
 #include "./pyinfotree.hpp"
 
 #include <switcher/infotree/json-serializer.hpp>
+#include <switcher/infotree/msgpack-serializer.hpp>
 #include <switcher/utils/scope-exit.hpp>
 
 PyObject* pyInfoTree::InfoTree_new(PyTypeObject* type, PyObject* /*args*/, PyObject* /*kwds*/) {
@@ -73,10 +74,25 @@ int pyInfoTree::InfoTree_init(pyInfoTreeObject* self, PyObject* args, PyObject*
     return 0;
   };
 
+  // init from MessagePack bytes
+  if (PyBytes_Check(initial)) {
+    self->keepAlive = infotree::msgpack::deserialize(
+        std::string_view(PyBytes_AsString(initial), PyBytes_Size(initial)), true);
+    self->tree = self->keepAlive.get();
+    // handle possible decoding error
+    if (self->keepAlive->branch_has_data(".parsing_error")) {
+      PyErr_Format(PyExc_RuntimeError,
+                   "parsing error: %s",
+                   self->tree->branch_get_value(".parsing_error").copy_as<std::string>().c_str());
+      return -1;
+    }
+    return 0;
+  }
+
   // raise type error
   PyErr_SetString(PyExc_TypeError,
-                  "function takes either a dictionary or a json string as its first optional "
-                  "argument `initial`.");
+                  "function takes either a dictionary, a json string or MessagePack bytes as its "
+                  "first optional argument `initial`.");
   return -1;
 }
 
@@ -194,6 +210,19 @@ PyObject* pyInfoTree::json(pyInfoTreeObject* self, PyObject* args, PyObject* kwd
   return PyUnicode_FromString(str.c_str());
 }
 
+PyDoc_STRVAR(pyinfotree_msgpack_doc,
+             "Get a MessagePack representation of the tree, that keeps value types and arrays.\n"
+             "Arguments: (path)\n"
+             "Returns: The MessagePack representation of the tree, as bytes\n");
+
+PyObject* pyInfoTree::msgpack(pyInfoTreeObject* self, PyObject* args, PyObject* kwds) {
+  const char* path = ".";
+  static char* kwlist[] = {(char*)"path", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|s", kwlist, &path)) return nullptr;
+  auto bytes = infotree::msgpack::serialize(self->tree->get_tree(path).get());
+  return PyBytes_FromStringAndSize(bytes.data(), bytes.size());
+}
+
 PyObject* pyInfoTree::any_to_pyobject(const Any& any) {
   auto category = any.get_category();
   if (AnyCategory::NONE == category) {  // any is empty
@@ -311,6 +340,7 @@ PyMethodDef pyInfoTree::pyInfoTree_methods[] = {
     {"copy", (PyCFunction)copy, METH_VARARGS | METH_KEYWORDS, pyinfotree_copy_doc},
     {"graft", (PyCFunction)graft, METH_VARARGS | METH_KEYWORDS, pyinfotree_graft_doc},
     {"json", (PyCFunction)json, METH_VARARGS | METH_KEYWORDS, pyinfotree_json_doc},
+    {"msgpack", (PyCFunction)msgpack, METH_VARARGS | METH_KEYWORDS, pyinfotree_msgpack_doc},
     {"get", (PyCFunction)get, METH_VARARGS | METH_KEYWORDS, pyinfotree_get_doc},
     {"get_child_keys",
      (PyCFunction)get_child_keys,
@@ -53,6 +53,7 @@ class pyInfoTree {
   static PyObject* get_key_values(pyInfoTreeObject* self, PyObject* args, PyObject* kwds);
   static PyObject* graft(pyInfoTreeObject* self, PyObject* args, PyObject* kwds);
   static PyObject* json(pyInfoTreeObject* self, PyObject* args, PyObject* kwds);
+  static PyObject* msgpack(pyInfoTreeObject* self, PyObject* args, PyObject* kwds);
   static PyObject* prune(pyInfoTreeObject* self, PyObject* args, PyObject* kwds);
   static PyObject* tag_as_array(pyInfoTreeObject* self, PyObject* args, PyObject* kwds);
 };
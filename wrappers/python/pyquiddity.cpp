@@ -477,7 +477,7 @@ PyObject* pyQuiddity::get_kind(pyQuiddityObject* self, PyObject*, PyObject*) {
 PyDoc_STRVAR(pyquiddity_set_nickname_doc,
              "Set the quiddity nickname.\n"
              "Arguments: (nickname)\n"
-             "Returns: True or False\n");
+             "Returns: True or False, False when the nickname is used by another quiddity\n");
 
 PyObject* pyQuiddity::set_nickname(pyQuiddityObject* self, PyObject* args, PyObject* kwds) {
   const char* nickname = nullptr;
@@ -531,13 +531,15 @@ PyObject* pyQuiddity::id(pyQuiddityObject* self, PyObject*, PyObject*) {
 bool pyQuiddity::subscribe_to_signal(pyQuiddityObject* self,
                                      const char* signal_name,
                                      PyObject* cb,
-                                     PyObject* user_data) {
+                                     PyObject* user_data,
+                                     signal::Delivery delivery) {
   auto quid = self->quid.lock();
   if (!quid) return false;
   auto sig_id = quid->sig<&signal::SBag::get_id>(signal_name);
   if (0 == sig_id) return false;
-  auto reg_id = quid->sig<&signal::SBag::subscribe>(
-      sig_id, [cb, user_data, self](const InfoTree::ptr& tree) {
+  auto reg_id = quid->sig<&signal::SBag::subscribe_with_delivery>(
+      sig_id,
+      [cb, user_data, self](const InfoTree::ptr& tree) {
         auto gstate = PyGILState_Ensure();
 
         PyObject* arglist;
@@ -556,7 +558,8 @@ bool pyQuiddity::subscribe_to_signal(pyQuiddityObject* self,
 
         /* Release the thread. No Python API allowed beyond this point. */
         PyGILState_Release(gstate);
-      });
+      },
+      delivery);
   if (0 == reg_id) return false;
   Py_INCREF(cb);
   self->sig_reg->callbacks.emplace(sig_id, cb);
@@ -614,17 +617,41 @@ PyDoc_STRVAR(pyquiddity_subscribe_doc,
              "Subscribe to a signal or to a property. The callback has two argument(s): value (of "
              "the property or the json representation of the value for signals), and the user_data "
              "if subscribe has been invoked with a user_data.\n"
-             "Arguments: (name, callback, user_data) where name is a signal name or a property "
-             "name. Note that user_data is optional\n"
+             "Arguments: (name, callback, user_data, coalesce_ms, max_rate, queue) where name is a "
+             "signal name or a property name. Note that user_data is optional. For signals only, "
+             "coalesce_ms or max_rate (in Hz) make the callback invoked from a dispatcher thread "
+             "with pending notifications of the same path merged, either coalesce_ms milliseconds "
+             "after the first one or at most max_rate times per second. Subscriptions given the "
+             "same queue name share their pending notifications, which are then delivered in the "
+             "order they were emitted, following the policy of the first of these "
+             "subscriptions.\n"
              "Returns: True or False\n");
 
 PyObject* pyQuiddity::subscribe(pyQuiddityObject* self, PyObject* args, PyObject* kwds) {
   const char* name = nullptr;
   PyObject* cb = nullptr;
   PyObject* user_data = nullptr;
-
-  static char* kwlist[] = {(char*)"name", (char*)"cb", (char*)"user_data", nullptr};
-  if (!PyArg_ParseTupleAndKeywords(args, kwds, "sO|O", kwlist, &name, &cb, &user_data)) {
+  int coalesce_ms = 0;
+  double max_rate = 0;
+  const char* queue = nullptr;
+
+  static char* kwlist[] = {(char*)"name",
+                           (char*)"cb",
+                           (char*)"user_data",
+                           (char*)"coalesce_ms",
+                           (char*)"max_rate",
+                           (char*)"queue",
+                           nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args,
+                                   kwds,
+                                   "sO|Oidz",
+                                   kwlist,
+                                   &name,
+                                   &cb,
+                                   &user_data,
+                                   &coalesce_ms,
+                                   &max_rate,
+                                   &queue)) {
     PyErr_SetString(PyExc_TypeError, "error parsing arguments");
     return nullptr;
   }
@@ -643,7 +670,18 @@ PyObject* pyQuiddity::subscribe(pyQuiddityObject* self, PyObject* args, PyObject
   if (prop_id != 0) {
     is_subscribed = subscribe_to_property(self, name, cb, user_data);
   } else if (sig_id != 0) {
-    is_subscribed = subscribe_to_signal(self, name, cb, user_data);
+    auto delivery = signal::Delivery::immediate();
+    if (0 < coalesce_ms)
+      delivery = signal::Delivery::coalesce(std::chrono::milliseconds(coalesce_ms));
+    else if (0 < max_rate)
+      delivery = signal::Delivery::max_rate(max_rate);
+    if (queue) {
+      auto& shared = self->sig_reg->queues[queue];
+      if (!shared && signal::Delivery::Mode::immediate != delivery.mode)
+        shared = std::make_shared<signal::Queue>(delivery);
+      if (shared) delivery = signal::Delivery::through(shared);
+    }
+    is_subscribed = subscribe_to_signal(self, name, cb, user_data, delivery);
   }
 
   if (is_subscribed) {
@@ -709,7 +747,10 @@ bool pyQuiddity::unsubscribe_from_signal(pyQuiddityObject* self, const char* sig
   if (0 == sig_id) return false;
   auto found = self->sig_reg->signals.find(sig_id);
   if (self->sig_reg->signals.end() == found) return false;
-  auto unsubscribed = quid->sig<&signal::SBag::unsubscribe>(sig_id, found->second);
+  // a deferred delivery waiting for the GIL may be running and is waited for
+  auto unsubscribed = pyquid::ungiled(std::function([&]() {
+    return quid->sig<&signal::SBag::unsubscribe>(sig_id, found->second);
+  }));
   if (!unsubscribed) return false;
   auto cb = self->sig_reg->callbacks.find(sig_id);
   Py_XDECREF(cb->second);
@@ -837,8 +878,40 @@ PyObject* pyQuiddity::get_info_tree_as_json(pyQuiddityObject* self,
     PyErr_SetString(PyExc_MemoryError, "Quiddity or parent Switcher has been deleted");
     return nullptr;
   }
-  std::string res = pyquid::ungiled(
-      std::function([&]() { return quid->tree<&InfoTree::serialize_json>(path); }));
+  std::string res = pyquid::ungiled(std::function([&]() {
+    // the whole tree is serialized from a snapshot in order to not block quiddity threads
+    // updating the tree during serialization
+    if (std::string(".") == path) return quid->tree<&InfoTree::snapshot>()->serialize_json(path);
+    return quid->tree<&InfoTree::serialize_json>(path);
+  }));
+
+  return PyUnicode_FromString(res.c_str());
+}
+
+PyDoc_STRVAR(pyquiddity_get_info_tree_changes_doc,
+             "Get the changes made to the InfoTree since a version, as grafts and prunes.\n"
+             "Arguments: (since)\n"
+             "Returns: a json string with the current \"version\", to be used with the next call,\n"
+             "and the \"changes\" array, with \"op\", \"path\" and grafted \"value\" members\n");
+
+PyObject* pyQuiddity::get_info_tree_changes(pyQuiddityObject* self,
+                                            PyObject* args,
+                                            PyObject* kwds) {
+  unsigned long long since = 0;
+  static char* kwlist[] = {(char*)"since", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|K", kwlist, &since)) {
+    PyErr_SetString(PyExc_TypeError, "error parsing arguments");
+    return nullptr;
+  }
+
+  auto quid = self->quid.lock();
+  if (!quid) {
+    PyErr_SetString(PyExc_MemoryError, "Quiddity or parent Switcher has been deleted");
+    return nullptr;
+  }
+  std::string res = pyquid::ungiled(std::function([&]() {
+    return quid->tree<&InfoTree::serialize_json_changes>(static_cast<std::uint64_t>(since));
+  }));
 
   return PyUnicode_FromString(res.c_str());
 }
@@ -867,12 +940,14 @@ void pyQuiddity::Quiddity_dealloc(pyQuiddityObject* self) {
   auto quid = self->quid.lock();
 
   if (quid) {
-    // cleaning signal subscription
-    for (const auto& it : self->sig_reg->callbacks) {
-      const auto found = self->sig_reg->signals.find(it.first);
-      quid->sig<&signal::SBag::unsubscribe>(found->first, found->second);
-      Py_XDECREF(it.second);
-    }
+    // cleaning signal subscription, a deferred delivery waiting for the GIL may be running and
+    // is waited for
+    pyquid::ungiled(std::function([&]() {
+      for (const auto& it : self->sig_reg->signals)
+        quid->sig<&signal::SBag::unsubscribe>(it.first, it.second);
+      return true;
+    }));
+    for (const auto& it : self->sig_reg->callbacks) Py_XDECREF(it.second);
     for (auto& it : self->sig_reg->user_data) {
       Py_XDECREF(it.second);
     }
@@ -1069,6 +1144,10 @@ PyMethodDef pyQuiddity::pyQuiddity_methods[] = {
      (PyCFunction)pyQuiddity::get_info_tree_as_json,
      METH_VARARGS | METH_KEYWORDS,
      pyquiddity_get_info_tree_as_json_doc},
+    {"get_info_tree_changes",
+     (PyCFunction)pyQuiddity::get_info_tree_changes,
+     METH_VARARGS | METH_KEYWORDS,
+     pyquiddity_get_info_tree_changes_doc},
     {"subscribe",
      (PyCFunction)pyQuiddity::subscribe,
      METH_VARARGS | METH_KEYWORDS,
@@ -40,6 +40,7 @@ class pyQuiddity {
     std::map<signal::sig_id_t, signal::register_id_t> signals{};
     std::map<signal::sig_id_t, PyObject*> callbacks{};
     std::map<signal::sig_id_t, PyObject*> user_data{};
+    std::map<std::string, std::shared_ptr<signal::Queue>> queues{};  //!< By queue name.
   };
   using prop_registering_t = struct {
     std::map<property::prop_id_t, property::register_id_t> props{};
@@ -130,6 +131,7 @@ class pyQuiddity {
   // access to quiddity InfoTree
   static PyObject* get_info(pyQuiddityObject* self, PyObject* args, PyObject* kwds);
   static PyObject* get_info_tree_as_json(pyQuiddityObject* self, PyObject* args, PyObject* kwds);
+  static PyObject* get_info_tree_changes(pyQuiddityObject* self, PyObject* args, PyObject* kwds);
   // kind, nickname and id
   static PyObject* get_kind(pyQuiddityObject* self, PyObject* args, PyObject* kwds);
   static PyObject* set_nickname(pyQuiddityObject* self, PyObject* args, PyObject* kwds);
@@ -141,7 +143,8 @@ class pyQuiddity {
   static bool subscribe_to_signal(pyQuiddityObject* self,
                                   const char* signal_name,
                                   PyObject* cb,
-                                  PyObject* user_data);
+                                  PyObject* user_data,
+                                  signal::Delivery delivery);
   static bool unsubscribe_from_signal(pyQuiddityObject* self, const char* signal_name);
   static bool subscribe_to_property(pyQuiddityObject* self,
                                     const char* prop_name,
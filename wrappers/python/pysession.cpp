@@ -115,7 +115,13 @@ PyObject* pySession::load(SessionObject* self, PyObject* args, PyObject* Py_UNUS
   const char* filename = nullptr;
   if (!PyArg_ParseTuple(args, "s", &filename)) return nullptr;
   // call C++ session method and return a python boolean
-  if(self->csession->load(filename))
+  // the GIL is released since quiddities are loaded from several threads, whose callbacks may
+  // need it
+  bool loaded;
+  Py_BEGIN_ALLOW_THREADS
+  loaded = self->csession->load(filename);
+  Py_END_ALLOW_THREADS
+  if (loaded)
     Py_RETURN_TRUE;
   else {
     PyErr_SetString(PyExc_RuntimeError, "Switcher could not load session file");
@@ -133,15 +139,29 @@ PyObject* pySession::read(SessionObject* self, PyObject* args, PyObject* Py_UNUS
   if (session_content.empty()) {
     PyErr_SetString(PyExc_RuntimeError, "Switcher could not read session file");
     return nullptr;
+  } else if (Session::is_msgpack(filename)) {
+    return PyBytes_FromStringAndSize(session_content.data(), session_content.size());
   } else {
     return PyUnicode_FromString(session_content.c_str());
   }
 };
 
 PyObject* pySession::write(SessionObject* self, PyObject* args, PyObject* Py_UNUSED(kwargs)) {
-  const char* session_content = nullptr;
+  PyObject* content = nullptr;
   const char* filename = nullptr;
-  if (!PyArg_ParseTuple(args, "ss", &session_content, &filename)) return nullptr;
+  if (!PyArg_ParseTuple(args, "Os", &content, &filename)) return nullptr;
+  // binary session content is given as bytes
+  std::string session_content;
+  if (PyBytes_Check(content)) {
+    session_content.assign(PyBytes_AsString(content), PyBytes_Size(content));
+  } else if (PyUnicode_Check(content)) {
+    auto utf8 = PyUnicode_AsUTF8(content);
+    if (!utf8) return nullptr;
+    session_content = utf8;
+  } else {
+    PyErr_SetString(PyExc_TypeError, "content must be a string or bytes");
+    return nullptr;
+  }
 
   // call C++ session write method and return a python boolean
   if(self->csession->write(session_content, filename))
@@ -188,15 +208,15 @@ PyMethodDef pySession::methods[] = {
                "----------\n"
                "filename: str\n"
                "\tThe name of the session file to read\n\n"
-               "Returns: content of session file.\n")},
+               "Returns: content of session file, as bytes for .msgpack files.\n")},
     {"write",
      (PyCFunction)pySession::write,
      METH_VARARGS,
      PyDoc_STR("Write content to a session file on disk without affecting current session state\n\n"
                "Arguments:\n"
                "----------\n"
-               "content: str\n"
-               "\tContent to write to session file\n\n"
+               "content: str or bytes\n"
+               "\tContent to write to session file, bytes for .msgpack files\n\n"
                "filename: str\n"
                "\tThe name of the session file to write to\n\n"
                "Returns: A boolean asserting how the write went.\n")},
@@ -217,7 +237,8 @@ PyMethodDef pySession::methods[] = {
                "Arguments:\n"
                "----------\n"
                "filename: str\n"
-               "\tThe name of the file to save the session to\n\n"
+               "\tThe name of the file to save the session to. The session is saved as JSON,\n"
+               "\tunless the name has the .msgpack extension.\n\n"
                "Returns: Either an empty string or the path to the saved session file.\n")},
     {nullptr}  // sentinel
 };
@@ -26,6 +26,7 @@
 
 #include "./pyinfotree.hpp"
 #include "./pyquiddity.hpp"
+#include "./ungiled.hpp"
 
 PyObject* InterpType(const char* type_name, const char* module_name) {
   PyObject *key = PyUnicode_FromString(type_name), *globals = PyEval_GetGlobals();
@@ -275,7 +276,11 @@ PyObject* pySwitch::remove(pySwitchObject* self, PyObject* args, PyObject* kwds)
     return nullptr;
   }
 
-  if (!self->switcher->quids<&quiddity::Container::remove>(id)) {
+  // signal subscriptions of the quiddity wait for deferred deliveries, which may need the GIL
+  auto removed = pyquid::ungiled(std::function([&]() {
+    return static_cast<bool>(self->switcher->quids<&quiddity::Container::remove>(id));
+  }));
+  if (!removed) {
     Py_INCREF(Py_False);
     return Py_False;
   }
@@ -343,6 +348,17 @@ PyObject* pySwitch::get_state(pySwitchObject* self, PyObject* args, PyObject* kw
   return pyInfoTree::make_pyobject_from_c_ptr(tree.get(), true);
 }
 
+PyDoc_STRVAR(pyswitch_get_info_tree_doc,
+             "Get information about the switcher instance, such as the loading durations of the "
+             "last load_state.\n"
+             "Arguments: None\n"
+             "Returns: an InfoTree object.\n");
+
+PyObject* pySwitch::get_info_tree(pySwitchObject* self, PyObject*, PyObject*) {
+  auto tree = self->switcher->get_info_tree();
+  return pyInfoTree::make_pyobject_from_c_ptr(tree.get(), true);
+}
+
 PyDoc_STRVAR(pyswitch_reset_state_doc,
              "Reset initial state for saving. When loading a new state, quiddities "
              "created after a call to reset_state will be cleared.\n The clear "
@@ -367,7 +383,8 @@ PyObject* pySwitch::reset_state(pySwitchObject* self, PyObject* args, PyObject*
 }
 
 PyDoc_STRVAR(pyswitch_load_state_doc,
-             "Load a switcher state. \n"
+             "Load a switcher state.\n"
+             "Loading durations are available from get_info_tree, under load_timings.\n"
              "Arguments: state (InfoTree)\n"
              "Returns: True or False.\n");
 
@@ -383,8 +400,14 @@ PyObject* pySwitch::load_state(pySwitchObject* self, PyObject* args, PyObject* k
                     "error: state argument is not an instance of a pyquid.InfoTree");
     return nullptr;
   }
-  if (!self->switcher->load_state(
-          reinterpret_cast<pyInfoTree::pyInfoTreeObject*>(pyinfotree)->tree)) {
+  // the GIL is released since quiddities are loaded from several threads, whose callbacks may
+  // need it
+  auto state = reinterpret_cast<pyInfoTree::pyInfoTreeObject*>(pyinfotree)->tree;
+  bool loaded;
+  Py_BEGIN_ALLOW_THREADS
+  loaded = self->switcher->load_state(state);
+  Py_END_ALLOW_THREADS
+  if (!loaded) {
     Py_INCREF(Py_False);
     return Py_False;
   }
@@ -700,6 +723,10 @@ PyMethodDef pySwitch::pySwitch_methods[] = {
      METH_VARARGS | METH_KEYWORDS,
      pyswitch_get_quid_id_doc},
     {"get_state", (PyCFunction)pySwitch::get_state, METH_NOARGS, pyswitch_get_state_doc},
+    {"get_info_tree",
+     (PyCFunction)pySwitch::get_info_tree,
+     METH_NOARGS,
+     pyswitch_get_info_tree_doc},
     {"load_state",
      (PyCFunction)pySwitch::load_state,
      METH_VARARGS | METH_KEYWORDS,
@@ -140,6 +140,7 @@ class pySwitch {
   static PyObject* load_bundles(pySwitchObject* self, PyObject* args, PyObject* kwds);
   // state saving
   static PyObject* get_state(pySwitchObject* self, PyObject* args, PyObject* kwds);
+  static PyObject* get_info_tree(pySwitchObject* self, PyObject* args, PyObject* kwds);
   static PyObject* load_state(pySwitchObject* self, PyObject* args, PyObject* kwds);
   static PyObject* reset_state(pySwitchObject* self, PyObject* args, PyObject* kwds);
   // introspection
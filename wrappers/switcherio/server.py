@@ -244,8 +244,16 @@ def set_signal_subscriptions(quid: Quiddity) -> None:
         'on-connection-spec-removed': on_connection_spec_removed
     }
 
+    # grafts are frequent (shmdata stats among others) and the handler reads
+    # the current value, so notifications of a same path are merged. Prunes go
+    # through the same queue, in order to be delivered in order with grafts.
+    coalesced_signals = {'on-tree-grafted': 100, 'on-tree-pruned': 100}
+
     for signal, method in quiddity_signals.items():
-        if not quid.subscribe(signal, method, quid.id()):
+        coalesce_ms = coalesced_signals.get(signal, 0)
+        if not quid.subscribe(signal, method, quid.id(),
+                              coalesce_ms=coalesce_ms,
+                              queue='info_tree' if coalesce_ms else None):
             sio.logger.warn(f'Could not subscribe to "{signal}" '
                             f'signal of `{repr(quid)}`')
         else:
@@ -756,6 +764,39 @@ def get_quiddity_info_tree(
         return str(e), None
 
 
+@sio.on('info_tree.changes')
+def get_quiddity_info_tree_changes(
+    sid: str,
+    quid_id: int,
+    since: int = 0
+) -> Tuple[Optional[str], Optional[dict]]:
+    """Retrieves the changes made to the info tree of a quiddity since a version.
+
+    Changes are grafts and prunes to apply in order. Asking for the changes since
+    version 0 gives the whole tree, and the returned version is used for the next
+    request, so that clients stay in sync without fetching whole branches.
+
+   Decorators:
+        sio.on
+
+   Arguments:
+        sid {str} -- The session identifier assigned to the client
+        quid_id {int} -- The quiddity identifier
+        since {int} -- The version of the tree the client is synchronized with
+
+   Returns:
+        tuple -- The error and response for this event, with the new `version`
+                 and the `changes`, each having an `op`, a `path` and a `value`
+                 for grafts
+    """
+    try:
+        quid = sw.get_quid(quid_id)
+        return None, json.loads(quid.get_info_tree_changes(since))
+    except Exception as e:
+        sio.logger.exception(e)
+        return str(e), None
+
+
 @sio.on('user_tree.get')
 def get_quiddity_user_tree(
     sid: str,
@@ -153,6 +153,7 @@ class InfoTreeTestCase(TreeTestCase):
 
       Available tests:
         - info_tree.get
+        - info_tree.changes
         - info_tree.grafted
         - info_tree.pruned
       """
@@ -179,6 +180,34 @@ class InfoTreeTestCase(TreeTestCase):
         self.assertIsNone(err)
         self.assertEqual(res, None)
 
+    def test_get_info_tree_changes(self):
+        # changes since the start give the whole tree
+        err, res = self.sio.call('info_tree.changes', data=(self.signal_id, 0))
+        self.assertIsNone(err)
+        version = res['version']
+        self.assertGreater(version, 0)
+        self.assertGreater(len(res['changes']), 0)
+
+        # only the grafted branch is changed
+        self.sio.call('quiddity.invoke', data=(self.signal_id, 'do-graft-tree', []))
+        err, res = self.sio.call('info_tree.changes', data=(self.signal_id, version))
+        self.assertIsNone(err)
+        self.assertGreater(res['version'], version)
+        self.assertEqual(res['changes'],
+                         [{'op': 'graft', 'path': '.hello', 'value': 'world'}])
+
+        # pruned branch
+        version = res['version']
+        self.sio.call('quiddity.invoke', data=(self.signal_id, 'do-prune-tree', []))
+        err, res = self.sio.call('info_tree.changes', data=(self.signal_id, version))
+        self.assertIsNone(err)
+        self.assertEqual(res['changes'], [{'op': 'prune', 'path': '.hello'}])
+
+        # nothing changed since
+        err, res = self.sio.call('info_tree.changes', data=(self.signal_id, res['version']))
+        self.assertIsNone(err)
+        self.assertEqual(res['changes'], [])
+
     def test_info_tree_grafted(self):
         err, res = self.sio.call('quiddity.invoke', data=(
             self.signal_id, 'do-graft-tree', []))